@@ -9,20 +9,27 @@
 #include <grpcpp/client_context.h>
 #include <grpcpp/create_channel.h>
 #include <grpcpp/security/credentials.h>
+#include <grpcpp/support/channel_arguments.h>
 
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <gflags/gflags.h>
 
+#include <array>
+#include <charconv>
 #include <chrono>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
 #include "rg_service/route_guide_service.h"
 
 #include "rg_service/rg_db.h"
+#include "rg_service/rg_interceptors.h"
+#include "rg_service/rg_random.h"
+#include "rg_service/rg_stats.h"
 #include "rg_service/rg_utils.h"
 #include "protobuf_utils/protobuf_utils.h"
 
@@ -39,9 +46,219 @@ using routeguide::RouteGuide;
 using routeguide::RouteNote;
 using routeguide::RouteSummary;
 
+DEFINE_string(address, "localhost:50051",
+              "Address of the server: host:port, unix:/path/to/socket or unix-abstract:name");
+DEFINE_uint32(load_threads, 0, "When non-zero, run the load mode with this many threads instead of the demo calls");
+DEFINE_uint32(load_seconds, 10, "Duration of the load mode, in seconds");
+DEFINE_string(load_mix, "GetFeature:1,ListFeatures:0,RecordRoute:0,RouteChat:0",
+              "RPC mix of the load mode, as comma-separated Method:weight pairs");
+DEFINE_bool(load_channel_per_thread, false,
+            "Give each load thread its own channel, hence its own connection, instead of one shared channel");
+DEFINE_uint64(load_seed, 1, "Seed of the load mode requests: thread n draws from stream n of that seed");
+DEFINE_string(load_faults, "", "Faults injected by the client in the load mode RPCs, same syntax as the --faults "
+              "flag of the servers, see rg_interceptors.h");
+
 namespace {
 std::thread::id main_thread = std::this_thread::get_id();
 FeatureList feature_list_;
+
+/// Parses the --load_mix flag.
+/// @param mix comma-separated Method:weight pairs, e.g. "GetFeature:8,ListFeatures:2"
+/// @return cycle of RPC methods holding each method as many times as its weight, empty when the mix is invalid
+std::vector<routeguide::RpcMethods> ParseRpcMix(std::string_view mix) {
+  std::vector<routeguide::RpcMethods> cycle;
+  while (!mix.empty()) {
+    const auto comma = mix.find(',');
+    const auto entry = mix.substr(0, comma);
+    mix = comma == std::string_view::npos ? std::string_view{} : mix.substr(comma + 1);
+    const auto colon = entry.find(':');
+    if (colon == std::string_view::npos) return {};
+    const auto name = entry.substr(0, colon);
+    const auto weight_text = entry.substr(colon + 1);
+    unsigned weight = 0;
+    if (const auto [end, ec] = std::from_chars(weight_text.data(), weight_text.data() + weight_text.size(), weight);
+        ec != std::errc{} || end != weight_text.data() + weight_text.size()) {
+      return {};
+    }
+    size_t method = 0;
+    while (method < routeguide::kRpcMethodsQty && routeguide::ToString(routeguide::RpcMethods(method)) != name) {
+      ++method;
+    }
+    if (method == routeguide::kRpcMethodsQty) return {};
+    cycle.insert(cycle.end(), weight, routeguide::RpcMethods(method));
+  }
+  return cycle;
+}
+
+/// Results of one load thread, merged by the main thread once every load thread is joined.
+struct LoadStats {
+  std::array<rg_stats::LatencyHistogram, routeguide::kRpcMethodsQty> latency;
+  std::array<uint64_t, routeguide::kRpcMethodsQty> failed{};
+  std::array<uint64_t, routeguide::kRpcMethodsQty> messages{};
+
+  void Merge(const LoadStats& other) {
+    for (size_t i = 0; i < routeguide::kRpcMethodsQty; ++i) {
+      latency[i].Merge(other.latency[i]);
+      failed[i] += other.failed[i];
+      messages[i] += other.messages[i];
+    }
+  }
+};
+
+/// One thread of the load mode: owns its stub and issues blocking RPCs back to back, without logging,
+/// following the RPC mix until the deadline. Request points are drawn in batches from the feature database
+/// with the thread's own random stream, so that no state is shared between the load threads.
+class LoadWorker {
+ public:
+  /// @param channel used by this thread only, or shared by every load thread
+  /// @param mix cycle of RPC methods, see ParseRpcMix()
+  /// @param offset starting position in the mix, so that the threads do not all call the same method, and
+  ///               index of the random stream of the thread
+  /// @param seed seed of the random streams, shared by every load thread
+  LoadWorker(const std::shared_ptr<Channel>& channel, const std::vector<routeguide::RpcMethods>& mix,
+             const size_t offset, const uint64_t seed)
+      : stub_(RouteGuide::NewStub(channel)), mix_(mix), next_method_(offset), engine_(seed, offset) {}
+
+  void Run(const std::chrono::steady_clock::time_point deadline, LoadStats& stats) {
+    while (std::chrono::steady_clock::now() < deadline) {
+      const auto method = mix_[next_method_++ % mix_.size()];
+      const auto index = static_cast<size_t>(method);
+      uint64_t messages = 0;
+      const auto start = std::chrono::steady_clock::now();
+      const auto status = Call(method, messages);
+      stats.latency[index].Record(std::chrono::steady_clock::now() - start);
+      stats.messages[index] += messages;
+      if (!status.ok()) ++stats.failed[index];
+    }
+  }
+
+ private:
+  Status Call(const routeguide::RpcMethods method, uint64_t& messages) {
+    switch (method) {
+      case routeguide::RpcMethods::kGetFeature: return GetFeature(messages);
+      case routeguide::RpcMethods::kListFeatures: return ListFeatures(messages);
+      case routeguide::RpcMethods::kRecordRoute: return RecordRoute(messages);
+      case routeguide::RpcMethods::kRouteChat: return RouteChat(messages);
+      default: return Status(grpc::StatusCode::UNIMPLEMENTED, "Unknown RPC method");
+    }
+  }
+
+  const Point& NextPoint() {
+    if (next_point_ == points_.size()) {
+      rg_random::FillPoints(engine_, feature_list_, points_);
+      next_point_ = 0;
+    }
+    return *points_[next_point_++];
+  }
+
+  Status GetFeature(uint64_t& messages) {
+    ClientContext context;
+    Feature feature;
+    messages = 1;
+    return stub_->GetFeature(&context, NextPoint(), &feature);
+  }
+
+  Status ListFeatures(uint64_t& messages) {
+    static const auto kRectangle = rg_utils::MakeRectangle(400000000, -750000000, 420000000, -730000000);
+    ClientContext context;
+    Feature feature;
+    auto reader = stub_->ListFeatures(&context, kRectangle);
+    while (reader->Read(&feature)) {
+      ++messages;
+    }
+    return reader->Finish();
+  }
+
+  Status RecordRoute(uint64_t& messages) {
+    constexpr int kPoints = 10;
+    ClientContext context;
+    RouteSummary summary;
+    auto writer = stub_->RecordRoute(&context, &summary);
+    for (int i = 0; i < kPoints && writer->Write(NextPoint()); ++i) {
+      ++messages;
+    }
+    writer->WritesDone();
+    return writer->Finish();
+  }
+
+  Status RouteChat(uint64_t& messages) {
+    constexpr int kNotes = 4;
+    ClientContext context;
+    auto stream = stub_->RouteChat(&context);
+    for (int i = 0; i < kNotes; ++i) {
+      const auto& point = NextPoint();
+      if (!stream->Write(rg_utils::MakeRouteNote("Load note", point.latitude(), point.longitude()))) break;
+      ++messages;
+    }
+    stream->WritesDone();
+    RouteNote server_note;
+    while (stream->Read(&server_note)) {
+      ++messages;
+    }
+    return stream->Finish();
+  }
+
+  std::unique_ptr<RouteGuide::Stub> stub_;
+  const std::vector<routeguide::RpcMethods>& mix_;
+  size_t next_method_;
+  rg_random::Xoshiro256pp engine_;
+  std::array<const Point*, 256> points_{};
+  size_t next_point_ = points_.size();
+};
+
+/// @return channel of the load mode, its RPCs given the faults of the plan
+std::shared_ptr<Channel> CreateLoadChannel(const grpc::ChannelArguments& args,
+                                           const rg_interceptors::FaultPlan& faults) {
+  std::vector<std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>> interceptors;
+  if (!faults.Empty()) {
+    interceptors.push_back(std::make_unique<rg_interceptors::ClientFaultInterceptorFactory>(faults));
+  }
+  return grpc::experimental::CreateCustomChannelWithInterceptors(FLAGS_address, grpc::InsecureChannelCredentials(),
+                                                                 args, std::move(interceptors));
+}
+
+/// Load mode: runs `thread_qty` LoadWorker threads for `duration`, then merges their histograms and logs,
+/// per RPC method, the call rate, the message rate and the latency percentiles.
+void RunLoad(const std::vector<routeguide::RpcMethods>& mix, const size_t thread_qty,
+             const std::chrono::seconds duration, const bool channel_per_thread, const uint64_t seed,
+             const rg_interceptors::FaultPlan& faults) {
+  const auto shared_channel = CreateLoadChannel(grpc::ChannelArguments(), faults);
+  std::vector<LoadStats> stats(thread_qty);
+  std::vector<std::thread> threads;
+  threads.reserve(thread_qty);
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + duration;
+  for (size_t i = 0; i < thread_qty; ++i) {
+    auto channel = shared_channel;
+    if (channel_per_thread) {
+      // A local subchannel pool keeps gRPC from sharing one connection between same-target channels.
+      grpc::ChannelArguments args;
+      args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+      channel = CreateLoadChannel(args, faults);
+    }
+    threads.emplace_back([channel, &mix, i, seed, deadline, &thread_stats = stats[i]] {
+      LoadWorker(channel, mix, i, seed).Run(deadline, thread_stats);
+    });
+  }
+  LoadStats total;
+  for (size_t i = 0; i < thread_qty; ++i) {
+    threads[i].join();
+    total.Merge(stats[i]);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  spdlog::info("LOAD     | threads={} channels={} elapsed={:.3f}s", thread_qty,
+               channel_per_thread ? thread_qty : 1, elapsed.count());
+  for (size_t i = 0; i < routeguide::kRpcMethodsQty; ++i) {
+    const auto& latency = total.latency[i];
+    if (latency.Count() == 0) continue;
+    auto& logger = routeguide::logger::Get(routeguide::RpcMethods(i));
+    logger.info("LOAD     | calls={} failed={} messages={} {:.0f} calls/s {:.0f} msg/s", latency.Count(),
+                total.failed[i], total.messages[i], latency.Count() / elapsed.count(),
+                total.messages[i] / elapsed.count());
+    rg_stats::LogSummary(logger, "LOAD     | latency", latency);
+  }
+}
 }  // anonymous namespace
 
 namespace rg_logger = routeguide::logger;
@@ -161,8 +378,22 @@ int main(int argc, char** argv) {
 
   feature_list_ = rg_db::GetInitialFeatures();
 
+  if (FLAGS_load_threads > 0) {
+    const auto mix = ParseRpcMix(FLAGS_load_mix);
+    if (mix.empty()) {
+      spdlog::error("Invalid --load_mix: {}", FLAGS_load_mix);
+      return 1;
+    }
+    rg_interceptors::FaultPlan faults;
+    if (!rg_interceptors::ParseFaultPlan(FLAGS_load_faults, faults)) return 1;
+    spdlog::info("-------------- Load --------------");
+    RunLoad(mix, FLAGS_load_threads, std::chrono::seconds(FLAGS_load_seconds), FLAGS_load_channel_per_thread,
+            FLAGS_load_seed, faults);
+    return 0;
+  }
+
   RouteGuideClient guide(
-      grpc::CreateChannel("localhost:50051", grpc::InsecureChannelCredentials()));
+      grpc::CreateChannel(FLAGS_address, grpc::InsecureChannelCredentials()));
 
   spdlog::info("-------------- GetFeature --------------");
   guide.GetFeature();
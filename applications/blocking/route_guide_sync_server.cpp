@@ -23,7 +23,13 @@
 
 #include "rg_service/route_guide_service.h"
 
+#include "rg_service/rg_affinity.h"
 #include "rg_service/rg_db.h"
+#include "rg_service/rg_hugepages.h"
+#include "rg_service/rg_import.h"
+#include "rg_service/rg_index.h"
+#include "rg_service/rg_interceptors.h"
+#include "rg_service/rg_metrics.h"
 #include "rg_service/rg_utils.h"
 #include "protobuf_utils/protobuf_utils.h"
 
@@ -42,9 +48,29 @@ using routeguide::RouteNote;
 using routeguide::RouteSummary;
 using std::chrono::system_clock;
 
+DEFINE_string(address, "0.0.0.0:50051",
+              "Address the server listens on: host:port, unix:/path/to/socket or unix-abstract:name");
+DEFINE_double(chat_radius_m, 0, "RouteChat echoes the previous notes within that distance, in meters, of a new "
+              "note. 0 echoes only the notes at the exact same location");
+DEFINE_string(features_file, "", "CSV or GeoJSON dataset to serve instead of the built-in features");
+DEFINE_uint32(import_threads, 0, "Threads importing --features_file and indexing the features, 0 for one per core");
+DEFINE_bool(lazy_features, false, "Keep the features as compact records, and build their Feature messages only for "
+            "the responses");
+DEFINE_string(faults, "", "Faults injected in the RPCs: latency, errors and stream stalls per method, e.g. "
+              "\"GetFeature:delay=exp:2ms,error=0.01;ListFeatures:stall=0.05:50ms\", see rg_interceptors.h");
+DEFINE_uint32(metrics_port, 0, "Port of the HTTP listener exporting the metrics in the Prometheus format, 0 for "
+              "no metrics");
+DEFINE_string(grpc_cpus, "", "CPUs of the threads of the server, gRPC and metrics exporter, e.g. \"0-3\", "
+              "empty to leave them to the scheduler");
+DEFINE_string(huge_pages, "off", "Back the feature store with huge pages: off, transparent (madvise) or explicit "
+              "(MAP_HUGETLB, falling back to transparent)");
+DEFINE_uint32(memory_report_seconds, 0, "Period of the log of the huge pages held and the dTLB load misses per "
+              "second, 0 for none");
+
 namespace {
 std::thread::id main_thread = std::this_thread::get_id();
-FeatureList feature_list_;
+rg_db::FeatureStore feature_store_;
+rg_index::FeatureIndex feature_index_;  // locations of feature_store_
 }  // anonymous namespace
 
 class RouteGuideImpl final : public RouteGuide::Service {
@@ -54,7 +80,7 @@ class RouteGuideImpl final : public RouteGuide::Service {
     auto& logger = routeguide::logger::Get(routeguide::RpcMethods::kGetFeature);
     logger.info("ENTER    |");
     logger.info("REQUEST  | Point: {}", protobuf_utils::ToString(*point));
-    *feature = rg_utils::GetFeatureFromPoint(feature_list_, *point);
+    *feature = rg_utils::GetFeatureFromPoint(feature_index_, *point);
     logger.info("RESPONSE | Feature: {}", protobuf_utils::ToString(*feature));
     logger.info("EXIT     |");
     return Status::OK;
@@ -66,8 +92,10 @@ class RouteGuideImpl final : public RouteGuide::Service {
     auto& logger = routeguide::logger::Get(routeguide::RpcMethods::kListFeatures);
     logger.info("ENTER    |");
     logger.info("REQUEST  | Rectangle: {}", protobuf_utils::ToString(*rectangle));
-    for (const Feature& f : feature_list_) {
-      if (rg_utils::IsPointWithinRectangle(*rectangle, f.location())) {
+    Feature scratch;  // lazy mode: reused by every written feature
+    for (size_t i = 0; i < feature_store_.size(); ++i) {
+      if (rg_utils::IsPointWithinRectangle(*rectangle, feature_store_.location(i))) {
+        const Feature& f = feature_store_.Get(i, scratch);
         logger.info("RESPONSE | Feature: {}", protobuf_utils::ToString(f));
         writer->Write(f);
       }
@@ -90,11 +118,11 @@ class RouteGuideImpl final : public RouteGuide::Service {
     while (reader->Read(&point)) {
       logger.info("REQUEST  | Point: {}", protobuf_utils::ToString(point));
       point_count++;
-      if (const auto name = rg_utils::GetFeatureName(point, feature_list_); name && strlen(name) > 0) {
+      if (const auto name = rg_utils::GetFeatureName(point, feature_index_); name && strlen(name) > 0) {
         feature_count++;
       }
       if (point_count != 1) {
-        distance += rg_utils::GetDistance(previous, point);
+        distance += rg_utils::GetApproxDistance(previous, point);
       }
       previous = point;
     }
@@ -116,14 +144,21 @@ class RouteGuideImpl final : public RouteGuide::Service {
     RouteNote note;
     while (stream->Read(&note)) {
       logger.info("REQUEST  | RouteNote: {}", protobuf_utils::ToString(note));
+      if (note.message().empty() && note.session_id() != 0) {
+        // Closes the session alone, acknowledged by the same empty note, on a stream shared by several.
+        logger.info("RESPONSE | RouteNote: {}", protobuf_utils::ToString(note));
+        stream->Write(note);
+        continue;
+      }
       std::unique_lock lock(mu_);
-      for (const RouteNote& n : received_notes_) {
-        if (n.location() == note.location()) {
-          logger.info("RESPONSE | RouteNote: {}", protobuf_utils::ToString(n));
-          stream->Write(n);
-        }
+      for (const RouteNote* n : received_notes_.FindNear(note.location())) {
+        // Answered in the session of the note, on a stream shared by several sessions.
+        RouteNote response = *n;
+        response.set_session_id(note.session_id());
+        logger.info("RESPONSE | RouteNote: {}", protobuf_utils::ToString(response));
+        stream->Write(response);
       }
-      received_notes_.push_back(note);
+      received_notes_.Insert(note);
     }
     logger.info("EXIT     |");
     return Status::OK;
@@ -131,20 +166,45 @@ class RouteGuideImpl final : public RouteGuide::Service {
 
  private:
   std::mutex mu_;
-  std::vector<RouteNote> received_notes_;
+  rg_index::NoteIndex received_notes_{FLAGS_chat_radius_m};
 };
 
 void RunServer() {
   spdlog::info("-------------- Server creation --------------");
-  static const std::string server_address("0.0.0.0:50051");
+  const std::string& server_address = FLAGS_address;
 
   RouteGuideImpl service;
   ServerBuilder builder;
   builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
   builder.RegisterService(&service);
+  rg_interceptors::FaultPlan faults;
+  if (!rg_interceptors::ParseFaultPlan(FLAGS_faults, faults)) return;
+  rg_affinity::PlacementOptions placement_options;
+  if (!rg_affinity::ParseCpuList(FLAGS_grpc_cpus, placement_options.others)) return;
+  std::vector<std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>> interceptors;
+  if (!faults.Empty()) {
+    // First, so that the metrics see the injected delays and statuses.
+    spdlog::info("Injecting faults: {}", FLAGS_faults);
+    interceptors.push_back(std::make_unique<rg_interceptors::FaultInterceptorFactory>(faults));
+  }
+  if (FLAGS_metrics_port != 0) {
+    interceptors.push_back(std::make_unique<rg_interceptors::MetricsInterceptorFactory>());
+  }
+  if (!interceptors.empty()) builder.experimental().SetInterceptorCreators(std::move(interceptors));
   spdlog::info("Server BuildAndStart");
   auto server = builder.BuildAndStart();
+  if (!server) {
+    spdlog::error("Server failed to listen on {}", server_address);
+    return;
+  }
   spdlog::info("Server listening on {}", server_address);
+  rg_metrics::HttpExporter metrics_exporter;
+  if (FLAGS_metrics_port != 0 && !metrics_exporter.Start(FLAGS_metrics_port)) return;
+  // Once the threads of the server exist; the ones gRPC adds under load are caught by the periodic sweep.
+  rg_affinity::Placement placement;
+  if (!placement.Start(placement_options)) return;
+  rg_hugepages::MemoryReporter memory_reporter;
+  memory_reporter.Start(std::chrono::seconds(FLAGS_memory_report_seconds));
   server->Wait();
 }
 
@@ -156,7 +216,19 @@ int main(int argc, char** argv) {
 
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
-  feature_list_ = rg_db::GetInitialFeatures();
+  rg_hugepages::Mode huge_pages;
+  if (!rg_hugepages::ParseMode(FLAGS_huge_pages, huge_pages)) return 1;
+  rg_hugepages::SetMode(huge_pages);
+  const auto mode = FLAGS_lazy_features ? rg_db::FeatureStore::Mode::kLazy : rg_db::FeatureStore::Mode::kEager;
+  if (FLAGS_features_file.empty()) {
+    feature_store_ = rg_db::GetInitialFeatureStore(mode);
+  } else if (auto store = rg_import::ImportFeatures(FLAGS_features_file, FLAGS_import_threads, mode)) {
+    feature_store_ = std::move(*store);
+  } else {
+    return 1;
+  }
+  feature_index_ = rg_index::FeatureIndex(feature_store_, FLAGS_import_threads);
+  spdlog::info("Feature store: {} features, {} KiB", feature_store_.size(), feature_store_.MemoryBytes() / 1024);
   RunServer();
 
   gflags::ShutDownCommandLineFlags();
@@ -15,11 +15,15 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <gflags/gflags.h>
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <latch>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -27,6 +31,7 @@
 #include "rg_service/route_guide_service.h"
 
 #include "rg_service/rg_db.h"
+#include "rg_service/rg_stats.h"
 #include "rg_service/rg_utils.h"
 #include "protobuf_utils/protobuf_utils.h"
 
@@ -40,9 +45,67 @@ using routeguide::RouteGuide;
 using routeguide::RouteNote;
 using routeguide::RouteSummary;
 
+DEFINE_string(address, "localhost:50051",
+              "Address of the server: host:port, unix:/path/to/socket or unix-abstract:name");
+DEFINE_uint32(pipeline_window, 0,
+              "When non-zero, run the pipelined mode with this many calls in flight instead of the demo calls");
+DEFINE_uint32(pipeline_rpcs, 10000, "Number of GetFeature calls, then of ListFeatures calls, of the pipelined mode");
+
 namespace {
 std::thread::id main_thread = std::this_thread::get_id();
 FeatureList feature_list_;
+
+/// Completion tracking of one pipelined run. Calls are claimed by index with an atomic counter, so the
+/// initial window and every completion callback can issue the next call without a lock. The latch
+/// releases Wait() once every call is done.
+class PipelineTracker {
+ public:
+  explicit PipelineTracker(const size_t total) : total_(total), done_(static_cast<std::ptrdiff_t>(total)) {}
+
+  /// Claims the index of the next call to issue.
+  /// @return false when every call is already issued
+  bool Claim(size_t& index) {
+    index = issued_.fetch_add(1, std::memory_order_relaxed);
+    return index < total_;
+  }
+
+  /// Accounts for one finished call. Must be the last access of the call to the tracker, since the
+  /// last one releases Wait().
+  void Complete(const bool ok, const size_t messages, const std::chrono::steady_clock::duration latency) {
+    if (!ok) failed_.fetch_add(1, std::memory_order_relaxed);
+    messages_.fetch_add(messages, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      latency_.Record(latency);
+    }
+    done_.count_down();
+  }
+
+  /// Blocks until every call is done, then logs throughput and latency.
+  void WaitAndReport(spdlog::logger& logger, const std::string_view rpc, const size_t window,
+                     const std::chrono::steady_clock::time_point start) {
+    done_.wait();
+    if (total_ == 0) {
+      // No call: the rates and the latency summary have nothing to divide.
+      logger.info("PIPELINE | {} window={} calls=0", rpc, window);
+      return;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    logger.info("PIPELINE | {} window={} calls={} failed={} messages={} elapsed={:.3f}s {:.0f} calls/s {:.0f} msg/s",
+                rpc, window, total_, failed_.load(), messages_.load(), elapsed.count(), total_ / elapsed.count(),
+                messages_.load() / elapsed.count());
+    rg_stats::LogSummary(logger, "PIPELINE | latency", latency_);
+  }
+
+ private:
+  const size_t total_;
+  std::atomic_size_t issued_{0};
+  std::atomic_size_t failed_{0};
+  std::atomic_size_t messages_{0};
+  std::latch done_;
+  std::mutex mu_;
+  rg_stats::LatencyHistogram latency_;
+};
 }  // anonymous namespace
 
 namespace rg_logger = routeguide::logger;
@@ -302,6 +365,91 @@ class RouteGuideClient {
     logger.info("EXIT     | post-Await() OK: {} msg: {}", status.ok(), status.error_message());
   }
 
+  /// Pipelined mode of GetFeature: keeps `window` calls in flight until `total` calls are done. Each
+  /// completion callback issues the next call, so nothing blocks between calls. Requests are built
+  /// before the first call so that the measured path is only the RPC.
+  void PipelineGetFeature(const size_t window, const size_t total) {
+    struct Call {
+      ClientContext context;
+      Feature feature;
+      std::chrono::steady_clock::time_point start;
+    };
+    std::vector<Point> points;
+    points.reserve(total);
+    for (size_t i = 0; i < total; ++i) {
+      points.push_back(rg_utils::GetRandomPoint(feature_list_));
+    }
+    PipelineTracker tracker(total);
+    std::function<void()> issue = [this, &tracker, &points, &issue] {
+      size_t index;
+      if (!tracker.Claim(index)) return;
+      auto* call = new Call;
+      call->start = std::chrono::steady_clock::now();
+      stub_->async()->GetFeature(&call->context, &points[index], &call->feature,
+                                 [&tracker, &issue, call](const Status& status) {
+        const auto latency = std::chrono::steady_clock::now() - call->start;
+        delete call;
+        issue();
+        tracker.Complete(status.ok(), 1, latency);
+      });
+    };
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < window; ++i) {
+      issue();
+    }
+    tracker.WaitAndReport(rg_logger::Get(routeguide::RpcMethods::kGetFeature), "GetFeature", window, start);
+  }
+
+  /// Pipelined mode of ListFeatures: keeps `window` streams in flight until `total` streams are done.
+  /// Each stream reads the whole rectangle, and the next stream is issued from OnDone().
+  void PipelineListFeatures(const size_t window, const size_t total) {
+    class Reader : public grpc::ClientReadReactor<Feature> {
+     public:
+      Reader(RouteGuide::Stub* stub, const Rectangle& rectangle, PipelineTracker& tracker,
+             const std::function<void()>& issue)
+          : tracker_(tracker), issue_(issue), start_(std::chrono::steady_clock::now()) {
+        stub->async()->ListFeatures(&context_, &rectangle, this);
+        StartRead(&feature_);
+        StartCall();
+      }
+      void OnReadDone(bool ok) override {
+        if (ok) {
+          ++messages_;
+          StartRead(&feature_);
+        }
+      }
+      void OnDone(const Status& status) override {
+        const auto latency = std::chrono::steady_clock::now() - start_;
+        auto& tracker = tracker_;
+        const auto& issue = issue_;
+        const auto messages = messages_;
+        delete this;
+        issue();
+        tracker.Complete(status.ok(), messages, latency);
+      }
+
+     private:
+      ClientContext context_;
+      Feature feature_;
+      PipelineTracker& tracker_;
+      const std::function<void()>& issue_;
+      const std::chrono::steady_clock::time_point start_;
+      size_t messages_ = 0;
+    };
+    const auto rectangle = rg_utils::MakeRectangle(400000000, -750000000, 420000000, -730000000);
+    PipelineTracker tracker(total);
+    std::function<void()> issue = [this, &tracker, &rectangle, &issue] {
+      size_t index;
+      if (!tracker.Claim(index)) return;
+      new Reader(stub_.get(), rectangle, tracker, issue);  // deletes itself in OnDone()
+    };
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < window; ++i) {
+      issue();
+    }
+    tracker.WaitAndReport(rg_logger::Get(routeguide::RpcMethods::kListFeatures), "ListFeatures", window, start);
+  }
+
  private:
   std::unique_ptr<RouteGuide::Stub> stub_;
 };
@@ -316,7 +464,15 @@ int main(int argc, char** argv) {
 
   feature_list_ = rg_db::GetInitialFeatures();
   RouteGuideClient guide(
-      grpc::CreateChannel("localhost:50051", grpc::InsecureChannelCredentials()));
+      grpc::CreateChannel(FLAGS_address, grpc::InsecureChannelCredentials()));
+
+  if (FLAGS_pipeline_window > 0) {
+    spdlog::info("-------------- GetFeature pipelined --------------");
+    guide.PipelineGetFeature(FLAGS_pipeline_window, FLAGS_pipeline_rpcs);
+    spdlog::info("-------------- ListFeatures pipelined --------------");
+    guide.PipelineListFeatures(FLAGS_pipeline_window, FLAGS_pipeline_rpcs);
+    return 0;
+  }
 
   spdlog::info("-------------- GetFeature --------------");
   guide.GetFeature();
@@ -18,14 +18,23 @@
 #include <chrono>
 #include <cmath>
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "rg_service/route_guide_service.h"
 
+#include "rg_service/rg_affinity.h"
 #include "rg_service/rg_db.h"
+#include "rg_service/rg_hugepages.h"
+#include "rg_service/rg_import.h"
+#include "rg_service/rg_index.h"
+#include "rg_service/rg_interceptors.h"
+#include "rg_service/rg_metrics.h"
 #include "rg_service/rg_utils.h"
 #include "protobuf_utils/protobuf_utils.h"
 
@@ -41,9 +50,44 @@ using routeguide::RouteNote;
 using routeguide::RouteSummary;
 using std::chrono::system_clock;
 
+DEFINE_string(address, "0.0.0.0:50051",
+              "Address the server listens on: host:port, unix:/path/to/socket or unix-abstract:name");
+DEFINE_double(chat_radius_m, 0, "RouteChat echoes the previous notes within that distance, in meters, of a new "
+              "note. 0 echoes only the notes at the exact same location");
+DEFINE_string(features_file, "", "CSV or GeoJSON dataset to serve instead of the built-in features");
+DEFINE_uint32(import_threads, 0, "Threads importing --features_file and indexing the features, 0 for one per core");
+DEFINE_bool(lazy_features, false, "Keep the features as compact records, and build their Feature messages only for "
+            "the responses");
+DEFINE_bool(chat_push, false, "RouteChat pushes every new note to the live streams that sent a note nearby, "
+            "instead of echoing matches only when a stream sends a note itself");
+DEFINE_uint32(chat_queue_depth, 64, "With --chat_push, pushed notes a stream can have waiting to be written. "
+              "Notes pushed to a full queue are skipped for that stream");
+DEFINE_string(faults, "", "Faults injected in the RPCs: latency, errors and stream stalls per method, e.g. "
+              "\"GetFeature:delay=exp:2ms,error=0.01;ListFeatures:stall=0.05:50ms\", see rg_interceptors.h");
+DEFINE_uint32(metrics_port, 0, "Port of the HTTP listener exporting the metrics in the Prometheus format, 0 for "
+              "no metrics");
+DEFINE_string(grpc_cpus, "", "CPUs of the threads of the server, gRPC and metrics exporter, e.g. \"0-3\", "
+              "empty to leave them to the scheduler");
+DEFINE_string(huge_pages, "off", "Back the feature store and the RPC arenas with huge pages: off, transparent "
+              "(madvise) or explicit (MAP_HUGETLB, falling back to transparent)");
+DEFINE_uint32(memory_report_seconds, 0, "Period of the log of the huge pages held and the dTLB load misses per "
+              "second, 0 for none");
+
 namespace {
 std::thread::id main_thread = std::this_thread::get_id();
-FeatureList feature_list_;
+rg_db::FeatureStore feature_store_;
+rg_index::FeatureIndex feature_index_;  // locations of feature_store_
+
+/// RouteChat stream receiving the notes of the other sessions (--chat_push), the stream of the subscribers of
+/// rg_index::InterestIndex.
+class ChatSubscriber {
+ public:
+  virtual ~ChatSubscriber() = default;
+  /// Queues a note to write, without waiting for the writes. The note is shared, read-only, by every session of
+  /// its session id it is pushed to.
+  /// @param note already in the session it is pushed to
+  virtual void Push(std::shared_ptr<const RouteNote> note) = 0;
+};
 }  // anonymous namespace
 
 class RouteGuideImpl final : public RouteGuide::CallbackService {
@@ -54,7 +98,7 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
     auto& logger = routeguide::logger::Get(routeguide::RpcMethods::kGetFeature);
     logger.info("ENTER    |");
     logger.info("REQUEST  | Point: {}", protobuf_utils::ToString(*point));
-    *feature = rg_utils::GetFeatureFromPoint(feature_list_, *point);
+    *feature = rg_utils::GetFeatureFromPoint(feature_index_, *point);
     auto* reactor = context->DefaultReactor();
     logger.info("RESPONSE | Feature: {}", protobuf_utils::ToString(*feature));
     reactor->Finish(Status::OK);
@@ -66,10 +110,9 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
                                                   const Rectangle* rectangle) override {
     class Lister : public grpc::ServerWriteReactor<Feature> {
      public:
-      Lister(const Rectangle& rectangle, const FeatureList& feature_list)
+      Lister(const Rectangle& rectangle, const rg_db::FeatureStore& feature_store)
           : rectangle_(rectangle),
-            feature_list_(feature_list),
-            next_feature_(feature_list_.begin()) {
+            feature_store_(feature_store) {
         logger_.info("ENTER    |");
         logger_.info("REQUEST  | Rectangle: {}", protobuf_utils::ToString(rectangle_));
         NextWrite();
@@ -91,9 +134,11 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
           Finish(Status::OK);
         }
       }*/
-        while (next_feature_ != feature_list_.end()) {
-          const Feature& f = *next_feature_++;
-          if (rg_utils::IsPointWithinRectangle(rectangle_, f.location())) {
+        while (next_feature_ < feature_store_.size()) {
+          const auto i = next_feature_++;
+          if (rg_utils::IsPointWithinRectangle(rectangle_, feature_store_.location(i))) {
+            // In lazy mode, the message is built in the scratch feature, on the arena of the RPC.
+            const Feature& f = feature_store_.Get(i, *scratch_);
             logger_.info("RESPONSE | Feature: {}", protobuf_utils::ToString(f));
             StartWrite(&f);
             return;
@@ -106,19 +151,21 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
       }
       spdlog::logger& logger_ = routeguide::logger::Get(routeguide::RpcMethods::kListFeatures);
       const Rectangle& rectangle_;
-      const FeatureList& feature_list_;
-      FeatureList::const_iterator next_feature_;
+      const rg_db::FeatureStore& feature_store_;
+      size_t next_feature_ = 0;
+      google::protobuf::Arena arena_{rg_hugepages::ArenaOptions()};
+      Feature* scratch_ = google::protobuf::Arena::Create<Feature>(&arena_);
     };
-    return new Lister(*rectangle, feature_list_);
+    return new Lister(*rectangle, feature_store_);
   }
 
   grpc::ServerReadReactor<Point>* RecordRoute(CallbackServerContext* context,
                                               RouteSummary* summary) override {
     class Recorder : public grpc::ServerReadReactor<Point> {
      public:
-      Recorder(RouteSummary& summary, const FeatureList& feature_list)
+      Recorder(RouteSummary& summary, const rg_index::FeatureIndex& feature_index)
           : summary_(summary),
-            feature_list_(feature_list) {
+            feature_index_(feature_index) {
         logger_.info("ENTER    |");
         StartRead(&point_);
       }
@@ -130,11 +177,11 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
         if (ok) {
           logger_.info("REQUEST  | Point: {}", protobuf_utils::ToString(point_));
           point_count_++;
-          if (const auto name = rg_utils::GetFeatureName(point_, feature_list_); name && strlen(name) > 0) {
+          if (const auto name = rg_utils::GetFeatureName(point_, feature_index_); name && strlen(name) > 0) {
             feature_count_++;
           }
           if (point_count_ != 1) {
-            distance_ += rg_utils::GetDistance(previous_, point_);
+            distance_ += rg_utils::GetApproxDistance(previous_, point_);
           }
           previous_ = point_;
           StartRead(&point_);
@@ -153,7 +200,7 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
      private:
       system_clock::time_point start_time_ = system_clock::now();
       RouteSummary& summary_;
-      const FeatureList& feature_list_;
+      const rg_index::FeatureIndex& feature_index_;
       spdlog::logger& logger_ = routeguide::logger::Get(routeguide::RpcMethods::kRecordRoute);
       Point point_;
       int point_count_ = 0;
@@ -161,13 +208,13 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
       double distance_ = 0.0;
       Point previous_;
     };
-    return new Recorder(*summary, feature_list_);
+    return new Recorder(*summary, feature_index_);
   }
 
   grpc::ServerBidiReactor<RouteNote, RouteNote>* RouteChat(CallbackServerContext* context) override {
     class Chatter : public grpc::ServerBidiReactor<RouteNote, RouteNote> {
      public:
-      Chatter(std::mutex& mu, std::vector<RouteNote>& received_notes)
+      Chatter(std::mutex& mu, rg_index::NoteIndex& received_notes)
           : mu_(mu), received_notes_(received_notes) {
         logger_.info("ENTER    |");
         StartRead(&note_);
@@ -178,21 +225,34 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
       }
       void OnReadDone(const bool ok) override {
         if (ok) {
-          if (note_.message().empty()) {
+          to_send_notes_.clear();
+          if (note_.message().empty() && note_.session_id() == 0) {
             logger_.info("RESPONSE | RouteNote: {}", protobuf_utils::ToString(note_));
             StartWriteAndFinish(&note_, grpc::WriteOptions(), Status::OK);
             logger_.info("EXIT     | StartWriteAndFinish()");
             return;
           }
-          // Unlike the non-reactor examples, locks twice instead of once around the whole exchange.
-          // See "Comparison with direct callbacks" in reactor_client.md for why.
-          mu_.lock();
-          logger_.info("REQUEST  | RouteNote: {}", protobuf_utils::ToString(note_));
-          std::ranges::copy_if(received_notes_, std::back_inserter(to_send_notes_),
-                               [this](const RouteNote& note) {
-                                 return (note.location() == note_.location());
-                               });
-          mu_.unlock();
+          if (note_.message().empty()) {
+            // Closes the session alone, acknowledged by the same empty note, on a stream shared by several.
+            logger_.info("REQUEST  | session {} closed after {} notes", note_.session_id(),
+                         sessions_[note_.session_id()]);
+            sessions_.erase(note_.session_id());
+            to_send_notes_.push_back(note_);
+            store_note_ = false;
+          } else {
+            ++sessions_[note_.session_id()];
+            // Unlike the non-reactor examples, locks twice instead of once around the whole exchange.
+            // See "Comparison with direct callbacks" in reactor_client.md for why.
+            mu_.lock();
+            logger_.info("REQUEST  | RouteNote: {}", protobuf_utils::ToString(note_));
+            for (const RouteNote* note : received_notes_.FindNear(note_.location())) {
+              to_send_notes_.push_back(*note);
+              // Answered in the session of the note.
+              to_send_notes_.back().set_session_id(note_.session_id());
+            }
+            mu_.unlock();
+            store_note_ = true;
+          }
           notes_iterator_ = to_send_notes_.begin();
           NextWrite();
         } else {
@@ -210,9 +270,11 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
           StartWrite(&*notes_iterator_);
           ++notes_iterator_;
         } else {
-          mu_.lock();
-          received_notes_.push_back(note_);
-          mu_.unlock();
+          if (store_note_) {
+            mu_.lock();
+            received_notes_.Insert(note_);
+            mu_.unlock();
+          }
           logger_.info("         | no more response, waiting for next read");
           StartRead(&note_);
         }
@@ -220,29 +282,197 @@ class RouteGuideImpl final : public RouteGuide::CallbackService {
       RouteNote note_;
       spdlog::logger& logger_ = routeguide::logger::Get(routeguide::RpcMethods::kRouteChat);
       std::mutex& mu_;
-      std::vector<RouteNote>& received_notes_;
+      rg_index::NoteIndex& received_notes_;
       std::vector<RouteNote> to_send_notes_;
       std::vector<RouteNote>::iterator notes_iterator_;
+      bool store_note_ = false;  // the note read is stored once answered, not a closing one
+      std::unordered_map<uint64_t, size_t> sessions_;  // notes received by the open sessions of the stream
     };
+    class PushChatter : public grpc::ServerBidiReactor<RouteNote, RouteNote>, public ChatSubscriber {
+     public:
+      PushChatter(std::mutex& mu, rg_index::NoteIndex& received_notes, rg_index::InterestIndex& interests)
+          : mu_(mu), received_notes_(received_notes), interests_(interests) {
+        logger_.info("ENTER    |");
+        StartRead(&note_);
+      }
+      void OnDone() override {
+        Unsubscribe();
+        logger_.info("EXIT     | OnDone(), {} pushed notes skipped", skipped_);
+        delete this;
+      }
+      void OnReadDone(const bool ok) override {
+        if (!ok) {
+          Unsubscribe();
+          FinishWhenWritten();
+          return;
+        }
+        if (note_.message().empty() && note_.session_id() == 0) {
+          Unsubscribe();
+          Write(std::make_shared<const RouteNote>(note_), false);
+          FinishWhenWritten();
+          return;
+        }
+        if (note_.message().empty()) {
+          // Closes the session alone, acknowledged by the same empty note, on a stream shared by several.
+          {
+            std::scoped_lock lock(mu_);
+            interests_.Remove(Subscriber(note_.session_id()));
+          }
+          logger_.info("REQUEST  | session {} closed", note_.session_id());
+          Write(std::make_shared<const RouteNote>(note_), false);
+          StartRead(&note_);
+          return;
+        }
+        logger_.info("REQUEST  | RouteNote: {}", protobuf_utils::ToString(note_));
+        Publish();
+        StartRead(&note_);
+      }
+      void OnWriteDone(const bool ok) override {
+        std::shared_ptr<const RouteNote> next;
+        {
+          std::scoped_lock lock(queue_mu_);
+          if (!ok) queue_.clear();  // cancelled: the next writes would fail too
+          if (!queue_.empty()) {
+            next = std::move(queue_.front());
+            queue_.pop_front();
+          }
+          writing_ = next;
+          if (!next && !finishing_) return;
+        }
+        if (next) {
+          logger_.info("RESPONSE | RouteNote: {}", protobuf_utils::ToString(*next));
+          StartWrite(next.get());
+        } else {
+          logger_.info("EXIT     | Pre-Finish()");
+          Finish(Status::OK);
+        }
+      }
+      void Push(std::shared_ptr<const RouteNote> note) override { Write(std::move(note), true); }
+
+     private:
+      /// Stores the note, queues its matches for its session the first time the session sends a note there,
+      /// and pushes the note to the other sessions interested in its location, on this stream or the others.
+      /// Every session then sees the notes of a location once: the stored ones on its first note there, the new
+      /// ones as they arrive. The note is copied once per session id it goes to, whatever the streams.
+      void Publish() {
+        std::scoped_lock lock(mu_);
+        if (interests_.Add(Subscriber(note_.session_id()), note_.location())) {
+          for (const RouteNote* note : received_notes_.FindNear(note_.location())) {
+            auto match = std::make_shared<RouteNote>(*note);
+            match->set_session_id(note_.session_id());
+            Write(std::move(match), false);
+          }
+        }
+        received_notes_.Insert(note_);
+        std::vector<std::shared_ptr<const RouteNote>> tagged{std::make_shared<const RouteNote>(note_)};
+        for (const auto& subscriber : interests_.FindNear(note_.location())) {
+          if (subscriber == Subscriber(note_.session_id())) continue;
+          auto found = std::ranges::find_if(
+              tagged, [&subscriber](const auto& tag) { return tag->session_id() == subscriber.session; });
+          if (found == tagged.end()) {
+            auto copy = std::make_shared<RouteNote>(note_);
+            copy->set_session_id(subscriber.session);
+            found = tagged.insert(tagged.end(), std::move(copy));
+          }
+          // The streams leave the index before their end, under mu_.
+          static_cast<ChatSubscriber*>(subscriber.stream)->Push(*found);
+        }
+      }
+      void Unsubscribe() {
+        std::scoped_lock lock(mu_);
+        interests_.RemoveStream(static_cast<ChatSubscriber*>(this));
+      }
+      /// @return a session of this stream in the interest index, keyed by its ChatSubscriber
+      rg_index::InterestIndex::Subscriber Subscriber(const uint64_t session) {
+        return {static_cast<ChatSubscriber*>(this), session};
+      }
+      /// Starts the write of the note, or queues it behind the ongoing write. A bounded write is skipped when
+      /// --chat_queue_depth notes are already queued, so a slow stream never blocks the publisher.
+      void Write(std::shared_ptr<const RouteNote> note, const bool bounded) {
+        {
+          std::scoped_lock lock(queue_mu_);
+          if (writing_) {
+            if (bounded && queue_.size() >= FLAGS_chat_queue_depth) {
+              ++skipped_;
+            } else {
+              queue_.push_back(std::move(note));
+            }
+            return;
+          }
+          writing_ = note;
+        }
+        logger_.info("RESPONSE | RouteNote: {}", protobuf_utils::ToString(*note));
+        StartWrite(note.get());
+      }
+      /// Finishes once the queued notes are written.
+      void FinishWhenWritten() {
+        {
+          std::scoped_lock lock(queue_mu_);
+          finishing_ = true;
+          if (writing_) return;
+        }
+        logger_.info("EXIT     | Pre-Finish()");
+        Finish(Status::OK);
+      }
+      RouteNote note_;
+      spdlog::logger& logger_ = routeguide::logger::Get(routeguide::RpcMethods::kRouteChat);
+      std::mutex& mu_;
+      rg_index::NoteIndex& received_notes_;           // guarded by mu_
+      rg_index::InterestIndex& interests_;            // guarded by mu_
+      std::mutex queue_mu_;
+      std::shared_ptr<const RouteNote> writing_;      // guarded by queue_mu_, the note of the ongoing write
+      std::deque<std::shared_ptr<const RouteNote>> queue_;  // guarded by queue_mu_
+      bool finishing_ = false;                        // guarded by queue_mu_
+      size_t skipped_ = 0;                            // guarded by queue_mu_
+    };
+    if (FLAGS_chat_push) {
+      return new PushChatter(mu_, received_notes_, interests_);
+    }
     return new Chatter(mu_, received_notes_);
   }
 
  private:
   std::mutex mu_;
-  std::vector<RouteNote> received_notes_;
+  rg_index::NoteIndex received_notes_{FLAGS_chat_radius_m};
+  rg_index::InterestIndex interests_{FLAGS_chat_radius_m};  // of the --chat_push sessions, guarded by mu_
 };
 
 void RunServer() {
   spdlog::info("-------------- Server creation --------------");
-  static const std::string server_address("0.0.0.0:50051");
+  const std::string& server_address = FLAGS_address;
 
   RouteGuideImpl service;
   ServerBuilder builder;
   builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
   builder.RegisterService(&service);
+  rg_interceptors::FaultPlan faults;
+  if (!rg_interceptors::ParseFaultPlan(FLAGS_faults, faults)) return;
+  rg_affinity::PlacementOptions placement_options;
+  if (!rg_affinity::ParseCpuList(FLAGS_grpc_cpus, placement_options.others)) return;
+  std::vector<std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>> interceptors;
+  if (!faults.Empty()) {
+    // First, so that the metrics see the injected delays and statuses.
+    spdlog::info("Injecting faults: {}", FLAGS_faults);
+    interceptors.push_back(std::make_unique<rg_interceptors::FaultInterceptorFactory>(faults));
+  }
+  if (FLAGS_metrics_port != 0) {
+    interceptors.push_back(std::make_unique<rg_interceptors::MetricsInterceptorFactory>());
+  }
+  if (!interceptors.empty()) builder.experimental().SetInterceptorCreators(std::move(interceptors));
   spdlog::info("Server BuildAndStart");
   auto server = builder.BuildAndStart();
+  if (!server) {
+    spdlog::error("Server failed to listen on {}", server_address);
+    return;
+  }
   spdlog::info("Server listening on {}", server_address);
+  rg_metrics::HttpExporter metrics_exporter;
+  if (FLAGS_metrics_port != 0 && !metrics_exporter.Start(FLAGS_metrics_port)) return;
+  // Once the threads of the server exist; the ones gRPC adds under load are caught by the periodic sweep.
+  rg_affinity::Placement placement;
+  if (!placement.Start(placement_options)) return;
+  rg_hugepages::MemoryReporter memory_reporter;
+  memory_reporter.Start(std::chrono::seconds(FLAGS_memory_report_seconds));
   server->Wait();
 }
 
@@ -254,7 +484,19 @@ int main(int argc, char** argv) {
 
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
-  feature_list_ = rg_db::GetInitialFeatures();
+  rg_hugepages::Mode huge_pages;
+  if (!rg_hugepages::ParseMode(FLAGS_huge_pages, huge_pages)) return 1;
+  rg_hugepages::SetMode(huge_pages);
+  const auto mode = FLAGS_lazy_features ? rg_db::FeatureStore::Mode::kLazy : rg_db::FeatureStore::Mode::kEager;
+  if (FLAGS_features_file.empty()) {
+    feature_store_ = rg_db::GetInitialFeatureStore(mode);
+  } else if (auto store = rg_import::ImportFeatures(FLAGS_features_file, FLAGS_import_threads, mode)) {
+    feature_store_ = std::move(*store);
+  } else {
+    return 1;
+  }
+  feature_index_ = rg_index::FeatureIndex(feature_store_, FLAGS_import_threads);
+  spdlog::info("Feature store: {} features, {} KiB", feature_store_.size(), feature_store_.MemoryBytes() / 1024);
   RunServer();
   return 0;
 }
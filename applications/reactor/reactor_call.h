@@ -0,0 +1,152 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <grpcpp/client_context.h>
+#include <grpcpp/support/client_callback.h>
+
+#include <memory>
+#include <utility>
+
+#include "applications/reactor/reactor_client.h"
+#include "applications/reactor/reactor_metrics.h"
+
+/************************
+ * Active Object Pattern: Method Request components bound to a stub method
+ *
+ * A specialized reactor only calls its `stub.async()->Method(...)` and starts the RPC, so ActiveCall builds it from
+ * the address of the method: the shape of the RPC, its request and response types, its callbacks and its generic
+ * reactor (reactor_client.h) are deduced from the signature of the method, for any service:
+ *
+ *   using ClientReactor = RpcReactor::Client::ActiveCall<&RouteGuide::Stub::async::ListFeatures>;
+ *   auto* reactor = new ClientReactor(stub, std::move(context), rectangle, std::move(cbs));
+ *
+ * The unary methods are overloaded by gRPC (a std::function one and a reactor one), so their address goes through
+ * ReactorMethod(), which picks the reactor one:
+ *
+ *   using ClientReactor = RpcReactor::Client::ActiveCall<RpcReactor::Client::ReactorMethod(&Stub::async::GetFeature)>;
+ *
+ * The method is a template argument, so the call is direct. Through `Stub::async`, a final class, it is not even
+ * virtual; through `Stub::async_interface`, it goes through the vtable of the interface, like `stub.async()->...`
+ * on a StubInterface.
+ ************************/
+namespace RpcReactor::Client {
+
+namespace internal {
+enum class Shape { kUnary, kRead, kWrite, kBidi };
+
+/// Shape, messages and generic reactor of an async stub method, by the type of its address.
+template <class MethodT>
+struct MethodTraits;
+
+template <class AsyncT, class Request, class Response>
+struct MethodTraits<void (AsyncT::*)(grpc::ClientContext*, const Request*, Response*, grpc::ClientUnaryReactor*)> {
+  static constexpr Shape kShape = Shape::kUnary;
+  using RequestT = Request;
+  using ResponseT = Response;
+  using Callbacks = ActiveUnaryCallbacks<Response>;
+  using Reactor = ActiveUnaryReactor<Response>;
+};
+
+template <class AsyncT, class Request, class Response>
+struct MethodTraits<void (AsyncT::*)(grpc::ClientContext*, const Request*, grpc::ClientReadReactor<Response>*)> {
+  static constexpr Shape kShape = Shape::kRead;
+  using RequestT = Request;
+  using ResponseT = Response;
+  using Callbacks = ActiveReadCallbacks<Response>;
+  using Reactor = ActiveReadReactor<Response>;
+};
+
+template <class AsyncT, class Request, class Response>
+struct MethodTraits<void (AsyncT::*)(grpc::ClientContext*, Response*, grpc::ClientWriteReactor<Request>*)> {
+  static constexpr Shape kShape = Shape::kWrite;
+  using RequestT = Request;
+  using ResponseT = Response;
+  using Callbacks = ActiveWriteCallbacks<Request, Response>;
+  using Reactor = ActiveWriteReactor<Request, Response>;
+};
+
+template <class AsyncT, class Request, class Response>
+struct MethodTraits<void (AsyncT::*)(grpc::ClientContext*, grpc::ClientBidiReactor<Request, Response>*)> {
+  static constexpr Shape kShape = Shape::kBidi;
+  using RequestT = Request;
+  using ResponseT = Response;
+  using Callbacks = ActiveBidiCallbacks<Request, Response>;
+  using Reactor = ActiveBidiReactor<Request, Response>;
+};
+}  // namespace internal
+
+/// Address of the reactor overload of a unary async stub method, the one ActiveCall can call.
+/// @param method address of the overloaded method, e.g. `&RouteGuide::Stub::async::GetFeature`
+template <class AsyncT, class Request, class Response>
+constexpr auto ReactorMethod(void (AsyncT::*method)(grpc::ClientContext*, const Request*, Response*,
+                                                    grpc::ClientUnaryReactor*)) {
+  return method;
+}
+
+/// Reactor of an async stub method, specializing the generic reactor of its shape (Method Request component).
+/// @tparam Method address of the async stub method, `&Service::Stub::async::Method` or
+///                `&Service::Stub::async_interface::Method`, through ReactorMethod() for the unary ones
+template <auto Method>
+class ActiveCall final : public internal::MethodTraits<decltype(Method)>::Reactor {
+  using Traits = internal::MethodTraits<decltype(Method)>;
+  using Reactor = typename Traits::Reactor;
+  static constexpr bool kHasRequest = Traits::kShape == internal::Shape::kUnary ||
+                                      Traits::kShape == internal::Shape::kRead;
+
+ public:
+  using RequestT = typename Traits::RequestT;
+  using ResponseT = typename Traits::ResponseT;
+  using Callbacks = typename Traits::Callbacks;
+
+  /// Constructor of the unary and server-streaming reactors. It calls the RPC method, with the address of the
+  /// response of the unary RPC, starts the read of the server-streaming one, then starts the RPC.
+  /// @param stub of the service
+  /// @param context given to the reactor and is associated with the called RPC method
+  /// @param request to send to the server
+  /// @param cbs given to the reactor to be used as callable functions
+  template <class StubT>
+  requires kHasRequest
+  ActiveCall(StubT& stub, std::unique_ptr<grpc::ClientContext> context, const RequestT& request, Callbacks&& cbs)
+      : Reactor(std::move(context), std::move(cbs)) {
+    if constexpr (Traits::kShape == internal::Shape::kUnary) {
+      // (Point 1.2, 1.3) async RPC call
+      (stub.async()->*Method)(this->context_.get(), &request, &this->response_, this);
+      Metrics::CountBytes(Metrics::Get().bytes_sent, request);
+    } else {
+      // (Point 1.2, 1.3) async RPC call, then (Point 1.4) starting reading
+      (stub.async()->*Method)(this->context_.get(), &request, this);
+      Metrics::CountBytes(Metrics::Get().bytes_sent, request);
+      this->StartRead(&this->response_);
+    }
+    // Starting RPC call, send request to server
+    this->StartCall();
+  }
+
+  /// Constructor of the client-streaming and bidirectional reactors. It calls the RPC method, with the address of
+  /// the response of the client-streaming RPC, starts the read of the bidirectional one, then starts the RPC. The
+  /// requests are sent afterwards, by SendRequest().
+  /// @param stub of the service
+  /// @param context given to the reactor and is associated with the called RPC method
+  /// @param cbs given to the reactor to be used as callable functions
+  template <class StubT>
+  requires(!kHasRequest)
+  ActiveCall(StubT& stub, std::unique_ptr<grpc::ClientContext> context, Callbacks&& cbs)
+      : Reactor(std::move(context), std::move(cbs)) {
+    if constexpr (Traits::kShape == internal::Shape::kWrite) {
+      // gRPC writes the final response into response_ directly when the RPC completes.
+      (stub.async()->*Method)(this->context_.get(), &this->response_, this);
+    } else {
+      // (Point 1.2, 1.3) async RPC call establishing the stream, then (Point 1.4) starting reading
+      (stub.async()->*Method)(this->context_.get(), this);
+      this->StartRead(&this->response_);
+    }
+    // Starting RPC call
+    this->StartCall();
+  }
+};
+
+}  // namespace RpcReactor::Client
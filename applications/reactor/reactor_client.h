@@ -13,6 +13,9 @@
 #include <memory>
 #include <utility>  // swap
 
+#include "applications/reactor/reactor_hold.h"
+#include "applications/reactor/reactor_overload.h"
+
 /************************
  * gRPC Reactor: Following code belongs to the API implementation
  * It is generic as much as possible
@@ -105,6 +108,8 @@ class ActiveUnaryReactor : public grpc::ClientUnaryReactor {
   void OnDone(const grpc::Status& status) override {
     // (Point 3.1, 3.2, 3.3) RPC termination
     response_ready_ = status.ok();
+    Metrics::Get().Rpcs(Metrics::ReactorType::kUnary, status).Add();
+    if (status.ok()) Metrics::CountBytes(Metrics::Get().bytes_received, response_);
     if (cbs_.done) {
       status_ = status;  // doing deep-copy unfortunately
       // (Point 3.4) TriggerEvent: OnDone
@@ -119,6 +124,7 @@ class ActiveUnaryReactor : public grpc::ClientUnaryReactor {
  private:
   grpc::Status status_;
   ActiveUnaryCallbacks<ResponseT> cbs_;
+  Metrics::InFlight in_flight_{Metrics::ReactorType::kUnary};
 
   // The application MAY call (but should not) GetResponse() while a gRPC thread is on OnDone().
   // That concurrent situation should not happen by design, unless the application
@@ -209,14 +215,35 @@ class ActiveReadReactor : public grpc::ClientReadReactor<ResponseT> {
   /// @return true when the returned response is valid, false otherwise.
   bool GetResponse(ResponseT& response) {
     if (!response_ready_) return false;
+    // The hold deadline may have cancelled the RPC already, see reactor_hold.h.
+    if (!hold_.Claim()) return false;
     // (Point 2.8, 2.14) extracts response
     swap(response_, response);  // Moving the read content on the user side
     response_ready_ = false;
+    if (!stream_no_more_ && Overload::PauseReads()) {
+      // The application is overloaded: the RPC stays held until ResumeReads().
+      reads_paused_ = true;
+      return true;
+    }
     if (!stream_no_more_) {
       // (Point 2.9, 2.10) Restart reading
       this->StartRead(&response_);
     }
     // (Point 2.11) Resuming RPC - must run regardless of whether reading restarted, see above.
+    hold_.Release();
+    this->RemoveHold();
+    return true;
+  }
+
+  /// Restarts the reading paused by GetResponse() while the application was overloaded, with the
+  /// `pause_reads` option of reactor_overload.h, and releases the hold. A paused RPC can't end,
+  /// even cancelled, until this call. To be called by the same thread as GetResponse().
+  /// @return true if reading was paused
+  bool ResumeReads() {
+    if (!reads_paused_) return false;
+    reads_paused_ = false;
+    if (!stream_no_more_) this->StartRead(&response_);
+    hold_.Release();
     this->RemoveHold();
     return true;
   }
@@ -244,17 +271,30 @@ class ActiveReadReactor : public grpc::ClientReadReactor<ResponseT> {
       return;
     }
     // (Point 2.3) OnReadDone: true
-    if (cbs_.ok && cbs_.ok(this, response_)) {
+    Metrics::CountBytes(Metrics::Get().bytes_received, response_);
+    if (cbs_.ok) {
       // Hold the RPC until the application thread calls StartRead() again from GetResponse().
       // See "Why OnReadDone holds before returning" in reactor_client.md for why this hold
       // exists: https://github.com/grpc/grpc/pull/18072
+      // The hold is taken before the callback hands the response over, so that GetResponse()
+      // always finds it, however fast the application thread is.
       // (Point 2.5) Holding the RPC
       this->AddHold();
-      return;
+      hold_.Start([this] {
+        context_->TryCancel();
+        this->RemoveHold();
+      });
+      if (cbs_.ok(this, response_)) return;
+      // Not handed over: the hold is given back below, unless its deadline did already.
+      if (!hold_.Claim()) return;
     }
     response_ready_ = false;
     // (Point 2.15, 2.16) Restart reading
     this->StartRead(&response_);
+    if (cbs_.ok) {
+      hold_.Release();
+      this->RemoveHold();
+    }
   }
   /// This event function is called by gRPC when the RPC is done and no more operation is possible with that reactor
   /// instance. The OnDoneCallback is then called, but on the same gRPC thread. The received status
@@ -263,10 +303,13 @@ class ActiveReadReactor : public grpc::ClientReadReactor<ResponseT> {
   void OnDone(const grpc::Status& status) override {
     // (Point 4.4, 4.5) RPC termination
     stream_no_more_ = true;
+    // The expired hold cancelled the RPC, see reactor_hold.h.
+    const auto& done_status = hold_.Expired() ? Hold::ExpiredStatus() : status;
+    Metrics::Get().Rpcs(Metrics::ReactorType::kRead, done_status).Add();
     if (cbs_.done) {
-      status_ = status;  // doing deep-copy unfortunately
+      status_ = done_status;  // doing deep-copy unfortunately
       // (Point 4.5) OnDone
-      cbs_.done(this, status);
+      cbs_.done(this, done_status);
     }
   }
 
@@ -277,6 +320,8 @@ class ActiveReadReactor : public grpc::ClientReadReactor<ResponseT> {
  private:
   grpc::Status status_;
   ActiveReadCallbacks<ResponseT> cbs_;
+  Metrics::InFlight in_flight_{Metrics::ReactorType::kRead};
+  Hold::Tracker hold_{Metrics::ReactorType::kRead};  ///< hold taken by OnReadDone()
 
   // The application MAY call GetResponse() while a gRPC thread is on OnReadDone().
   // That concurrent situation should not happen by design, unless the application
@@ -288,6 +333,10 @@ class ActiveReadReactor : public grpc::ClientReadReactor<ResponseT> {
   // Once we got OnReadDone(false) or OnDone(), no more StartRead() must be called.
   // Set by gRPC thread, read by application thread.
   std::atomic_bool stream_no_more_{false};
+
+  // GetResponse() kept the hold instead of restarting the read, see ResumeReads().
+  // Application thread only.
+  bool reads_paused_ = false;
 };
 
 /// Template callbacks for stream-writer RPC client reactor. It contains all available callbacks slots
@@ -364,6 +413,7 @@ class ActiveWriteReactor : public grpc::ClientWriteReactor<RequestT> {
     if (write_pending_) return false;  // Write already in progress
     pending_request_ = std::move(request);
     write_pending_ = true;
+    Metrics::CountBytes(Metrics::Get().bytes_sent, pending_request_);
     this->StartWrite(&pending_request_);
     return true;
   }
@@ -380,6 +430,7 @@ class ActiveWriteReactor : public grpc::ClientWriteReactor<RequestT> {
     if (write_pending_) return false;   // Write already in progress
     pending_request_ = std::move(request);
     write_pending_ = true;
+    Metrics::CountBytes(Metrics::Get().bytes_sent, pending_request_);
     // Per gRPC's contract, calling this already forbids any further StartWrite/StartWriteLast/
     // StartWritesDone, the same as CloseRequestStream() - set writes_done_ now, synchronously.
     writes_done_ = true;
@@ -459,6 +510,8 @@ class ActiveWriteReactor : public grpc::ClientWriteReactor<RequestT> {
   void OnDone(const grpc::Status& status) override {
     stream_no_more_ = true;
     response_ready_ = status.ok();
+    Metrics::Get().Rpcs(Metrics::ReactorType::kWrite, status).Add();
+    if (status.ok()) Metrics::CountBytes(Metrics::Get().bytes_received, response_);
     if (cbs_.done) {
       status_ = status;  // doing deep-copy unfortunately
       cbs_.done(this, status, response_);
@@ -472,6 +525,7 @@ class ActiveWriteReactor : public grpc::ClientWriteReactor<RequestT> {
  private:
   grpc::Status status_;
   ActiveWriteCallbacks<RequestT, ResponseT> cbs_;
+  Metrics::InFlight in_flight_{Metrics::ReactorType::kWrite};
 
   // Storage for the request currently being written. SendRequest() moves the caller's argument
   // here so StartWrite() has a stable pointer that survives past the caller's own statement -
@@ -592,6 +646,7 @@ class ActiveBidiReactor : public grpc::ClientBidiReactor<RequestT, ResponseT> {
     if (write_pending_) return false;  // Write already in progress
     pending_request_ = std::move(request);
     write_pending_ = true;
+    Metrics::CountBytes(Metrics::Get().bytes_sent, pending_request_);
     this->StartWrite(&pending_request_);
     return true;
   }
@@ -609,6 +664,7 @@ class ActiveBidiReactor : public grpc::ClientBidiReactor<RequestT, ResponseT> {
     if (write_pending_) return false;   // Write already in progress
     pending_request_ = std::move(request);
     write_pending_ = true;
+    Metrics::CountBytes(Metrics::Get().bytes_sent, pending_request_);
     // Per gRPC's contract, calling this already forbids any further StartWrite/StartWriteLast/
     // StartWritesDone, the same as CloseRequestStream() - set writes_done_ now, synchronously.
     writes_done_ = true;
@@ -653,13 +709,34 @@ class ActiveBidiReactor : public grpc::ClientBidiReactor<RequestT, ResponseT> {
   /// @return true when the returned response is valid, false otherwise.
   bool GetResponse(ResponseT& response) {
     if (!response_ready_) return false;
+    // The hold deadline may have cancelled the RPC already, see reactor_hold.h.
+    if (!hold_.Claim()) return false;
     swap(response_, response);  // Moving the read content on the user side
     response_ready_ = false;
+    if (!stream_no_more_ && Overload::PauseReads()) {
+      // The application is overloaded: the RPC stays held until ResumeReads().
+      reads_paused_ = true;
+      return true;
+    }
     if (!stream_no_more_) {
       // Restart reading
       this->StartRead(&response_);
     }
     // Resuming RPC - must run regardless of whether reading restarted, see above.
+    hold_.Release();
+    this->RemoveHold();
+    return true;
+  }
+
+  /// Restarts the reading paused by GetResponse() while the application was overloaded, with the
+  /// `pause_reads` option of reactor_overload.h, and releases the hold. A paused RPC can't end,
+  /// even cancelled, until this call. To be called by the same thread as GetResponse().
+  /// @return true if reading was paused
+  bool ResumeReads() {
+    if (!reads_paused_) return false;
+    reads_paused_ = false;
+    if (!stream_no_more_) this->StartRead(&response_);
+    hold_.Release();
     this->RemoveHold();
     return true;
   }
@@ -693,15 +770,27 @@ class ActiveBidiReactor : public grpc::ClientBidiReactor<RequestT, ResponseT> {
       if (cbs_.read_nok) cbs_.read_nok(this);
       return;
     }
-    if (cbs_.read_ok && cbs_.read_ok(this, response_)) {
+    Metrics::CountBytes(Metrics::Get().bytes_received, response_);
+    if (cbs_.read_ok) {
       // Hold the RPC until the application thread calls StartRead() again from GetResponse().
       // See "Why OnReadDone holds before returning" in reactor_client.md for why this hold
       // exists: https://github.com/grpc/grpc/pull/18072
+      // Taken before the callback hands the response over, as in ActiveReadReactor.
       this->AddHold();
-      return;
+      hold_.Start([this] {
+        context_->TryCancel();
+        this->RemoveHold();
+      });
+      if (cbs_.read_ok(this, response_)) return;
+      // Not handed over: the hold is given back below, unless its deadline did already.
+      if (!hold_.Claim()) return;
     }
     response_ready_ = false;
     this->StartRead(&response_);
+    if (cbs_.read_ok) {
+      hold_.Release();
+      this->RemoveHold();
+    }
   }
 
   /// This event function is called by gRPC when a write operation completes.
@@ -726,9 +815,12 @@ class ActiveBidiReactor : public grpc::ClientBidiReactor<RequestT, ResponseT> {
   /// @param status info coming from gRPC
   void OnDone(const grpc::Status& status) override {
     stream_no_more_ = true;
+    // The expired hold cancelled the RPC, see reactor_hold.h.
+    const auto& done_status = hold_.Expired() ? Hold::ExpiredStatus() : status;
+    Metrics::Get().Rpcs(Metrics::ReactorType::kBidi, done_status).Add();
     if (cbs_.done) {
-      status_ = status;  // doing deep-copy unfortunately
-      cbs_.done(this, status);
+      status_ = done_status;  // doing deep-copy unfortunately
+      cbs_.done(this, done_status);
     }
   }
 
@@ -739,6 +831,8 @@ class ActiveBidiReactor : public grpc::ClientBidiReactor<RequestT, ResponseT> {
  private:
   grpc::Status status_;
   ActiveBidiCallbacks<RequestT, ResponseT> cbs_;
+  Metrics::InFlight in_flight_{Metrics::ReactorType::kBidi};
+  Hold::Tracker hold_{Metrics::ReactorType::kBidi};  ///< hold taken by OnReadDone()
 
   // Storage for the request currently being written. SendRequest() moves the caller's argument
   // here so StartWrite() has a stable pointer that survives past the caller's own statement -
@@ -767,5 +861,9 @@ class ActiveBidiReactor : public grpc::ClientBidiReactor<RequestT, ResponseT> {
   // After this, no more SendRequest() calls are allowed.
   // Set by application thread, read by application thread.
   std::atomic_bool writes_done_{false};
+
+  // GetResponse() kept the hold instead of restarting the read, see ResumeReads().
+  // Application thread only.
+  bool reads_paused_ = false;
 };
 }  // namespace RpcReactor::Client
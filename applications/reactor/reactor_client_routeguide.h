@@ -7,122 +7,81 @@
 
 #include <grpcpp/client_context.h>
 
+#include <chrono>
+#include <future>
 #include <memory>
 #include <utility>
 
 #include "rg_service/route_guide_service.h"
 
+#include "applications/reactor/reactor_call.h"
 #include "applications/reactor/reactor_client.h"
 
 /************************
  * Active Object Pattern: Specialized Method Request components
  * These RouteGuide-specific reactors specialize the generic Method Request classes
- * from reactor_client.h. See reactor_client.md for architecture details.
+ * from reactor_client.h, bound to their stub method by ActiveCall (reactor_call.h).
+ * See reactor_client.md for architecture details.
  ************************/
 
 /************************
- * ClientReactor/GetFeature: Following code belongs to the API implementation
- * That code could be auto-generated by jinja template files (because of the stub.async()->rpc_method() call).
+ * ClientReactor/GetFeature
  ************************/
 namespace routeguide::GetFeature {
-/// Specialized callback slots for RouteGuide::GetFeature unary RPC client
-using Callbacks = RpcReactor::Client::ActiveUnaryCallbacks<ResponseT>;
-
 /// Specialized reactor class for RouteGuide::GetFeature unary RPC client.
 /// Specializes the generic ActiveUnaryReactor (Method Request component).
-class ClientReactor final : public RpcReactor::Client::ActiveUnaryReactor<ResponseT> {
- public:
-  /// Constructor of the specialized class. It calls the RPC method with the address pointer where
-  /// the response is wanted to be written. The context and the callbacks objects are moved to the
-  /// underlying generic class.
-  /// @param stub of the RouteGuide API
-  /// @param context given to the reactor and is associated with the called RPC method
-  /// @param request to send to the server
-  /// @param cbs given to the reactor to be used as callable functions
-  ClientReactor(RouteGuide::Stub& stub,
-                std::unique_ptr<grpc::ClientContext> context,
-                const RequestT& request,
-                Callbacks&& cbs)
-      : ActiveUnaryReactor(std::move(context), std::move(cbs)) {
-    // (Point 1.2, 1.3) async RPC call
-    stub.async()->GetFeature(context_.get(), &request, &response_, this);
-    // (Point 1.4, 1.5) Starting RPC call, send request to server
-    StartCall();
-  }
-};
+using ClientReactor =
+    RpcReactor::Client::ActiveCall<RpcReactor::Client::ReactorMethod(&RouteGuide::Stub::async::GetFeature)>;
+/// Specialized callback slots for RouteGuide::GetFeature unary RPC client
+using Callbacks = ClientReactor::Callbacks;
+
+/// Issues one GetFeature RPC through a ClientReactor and blocks until it is done. Meant as the priming RPC of
+/// the warmup phase (see reactor_warmup.h), before the application thread runs its EventLoop. The request is an
+/// empty Point, answered by the server with an unnamed Feature, so it primes the channel, the transport and the
+/// reactor's callback path without depending on the content of the feature database.
+/// @param stub of the RouteGuide API
+/// @param timeout deadline given to the RPC
+/// @return status of the RPC
+inline grpc::Status Prime(RouteGuide::Stub& stub, const std::chrono::milliseconds timeout) {
+  std::promise<grpc::Status> done;
+  Callbacks cbs;
+  cbs.done = [&done](grpc::ClientUnaryReactor*, const grpc::Status& status, const ResponseT&) {
+    done.set_value(status);
+  };
+  auto context = std::make_unique<grpc::ClientContext>();
+  context->set_deadline(std::chrono::system_clock::now() + timeout);
+  auto future = done.get_future();
+  ClientReactor reactor(stub, std::move(context), RequestT{}, std::move(cbs));
+  return future.get();
+}
 }  // namespace routeguide::GetFeature
 
 /************************
- * ClientReactor/ListFeatures: Following code belongs to the API implementation
- * That code could be auto-generated by jinja template files (because of the stub.async()->rpc_method() call).
+ * ClientReactor/ListFeatures
  ************************/
 namespace routeguide::ListFeatures {
-/// Specialized callback slots for RouteGuide::ListFeatures stream-reader RPC client
-using Callbacks = RpcReactor::Client::ActiveReadCallbacks<ResponseT>;
-
 /// Specialized reactor class for RouteGuide::ListFeatures stream-reader RPC client.
 /// Specializes the generic ActiveReadReactor (Method Request component).
-class ClientReactor final : public RpcReactor::Client::ActiveReadReactor<ResponseT> {
- public:
-  /// Constructor of the specialized class. It calls the RPC method and start the stream reading
-  /// with the address pointer where the response is wanted to be written.
-  /// @param stub of the RouteGuide API
-  /// @param context given to the reactor and is associated with the called RPC method
-  /// @param request to send to the server
-  /// @param cbs given to the reactor to be used as callable functions
-  ClientReactor(RouteGuide::Stub& stub,
-                std::unique_ptr<grpc::ClientContext> context,
-                const RequestT& request,
-                Callbacks&& cbs)
-      : ActiveReadReactor(std::move(context), std::move(cbs)) {
-    // (Point 1.2, 1.3) async RPC call
-    stub.async()->ListFeatures(context_.get(), &request, this);
-    // (Point 1.4) Starting reading
-    StartRead(&response_);
-    // (Point 1.5, 1.6) Starting RPC call, send request to server
-    StartCall();
-  }
-};
+using ClientReactor = RpcReactor::Client::ActiveCall<&RouteGuide::Stub::async::ListFeatures>;
+/// Specialized callback slots for RouteGuide::ListFeatures stream-reader RPC client
+using Callbacks = ClientReactor::Callbacks;
 }  // namespace routeguide::ListFeatures
 
 /************************
- * ClientReactor/RecordRoute: Following code belongs to the API implementation
- * That code could be auto-generated by jinja template files (because of the stub.async()->rpc_method() call).
+ * ClientReactor/RecordRoute
  ************************/
 namespace routeguide::RecordRoute {
-/// Specialized callback slots for RouteGuide::RecordRoute stream-writer RPC client
-using Callbacks = RpcReactor::Client::ActiveWriteCallbacks<RequestT, ResponseT>;
-
 /// Specialized reactor class for RouteGuide::RecordRoute stream-writer RPC client.
 /// Specializes the generic ActiveWriteReactor (Method Request component).
-class ClientReactor final : public RpcReactor::Client::ActiveWriteReactor<RequestT, ResponseT> {
- public:
-  /// Constructor of the specialized class. It calls the RPC method with the address pointer where
-  /// the response is wanted to be written.
-  /// @param stub of the RouteGuide API
-  /// @param context given to the reactor and is associated with the called RPC method
-  /// @param cbs given to the reactor to be used as callable functions
-  ClientReactor(RouteGuide::Stub& stub,
-                std::unique_ptr<grpc::ClientContext> context,
-                Callbacks&& cbs)
-      : ActiveWriteReactor(std::move(context), std::move(cbs)) {
-    // async RPC call - gRPC writes the final response into response_ directly when the RPC
-    // completes; there is no separate read event for a client-streaming RPC's response.
-    stub.async()->RecordRoute(context_.get(), &response_, this);
-    // Starting RPC call
-    StartCall();
-  }
-};
+using ClientReactor = RpcReactor::Client::ActiveCall<&RouteGuide::Stub::async::RecordRoute>;
+/// Specialized callback slots for RouteGuide::RecordRoute stream-writer RPC client
+using Callbacks = ClientReactor::Callbacks;
 }  // namespace routeguide::RecordRoute
 
 /************************
- * ClientReactor/RouteChat: Following code belongs to the API implementation
- * That code could be auto-generated by jinja template files (because of the stub.async()->rpc_method() call).
+ * ClientReactor/RouteChat
  ************************/
 namespace routeguide::RouteChat {
-/// Specialized callback slots for RouteGuide::RouteChat bidirectional streaming RPC client
-using Callbacks = RpcReactor::Client::ActiveBidiCallbacks<RequestT, ResponseT>;
-
 /// Specialized reactor class for RouteGuide::RouteChat bidirectional streaming RPC client.
 /// Specializes the generic ActiveBidiReactor (Method Request component).
 ///
@@ -138,23 +97,7 @@ using Callbacks = RpcReactor::Client::ActiveBidiCallbacks<RequestT, ResponseT>;
 /// - GetResponse(RouteNote&): Extract received response via swap
 /// - TryCancel(): Cancel the RPC from any thread
 /// - Status(): Get completion status after OnDone()
-class ClientReactor final : public RpcReactor::Client::ActiveBidiReactor<RequestT, ResponseT> {
- public:
-  /// Constructor of the specialized class. It calls the RPC method and starts the stream reading
-  /// with the address pointer where the response is wanted to be written.
-  /// @param stub of the RouteGuide API
-  /// @param context given to the reactor and is associated with the called RPC method
-  /// @param cbs given to the reactor to be used as callable functions
-  ClientReactor(RouteGuide::Stub& stub,
-                std::unique_ptr<grpc::ClientContext> context,
-                Callbacks&& cbs)
-      : ActiveBidiReactor(std::move(context), std::move(cbs)) {
-    // (Point 1.2, 1.3) async RPC call - establishes bidirectional stream
-    stub.async()->RouteChat(context_.get(), this);
-    // (Point 1.4) Starting reading
-    StartRead(&response_);
-    // (Point 1.5, 1.6) Starting RPC call, send request to server
-    StartCall();
-  }
-};
+using ClientReactor = RpcReactor::Client::ActiveCall<&RouteGuide::Stub::async::RouteChat>;
+/// Specialized callback slots for RouteGuide::RouteChat bidirectional streaming RPC client
+using Callbacks = ClientReactor::Callbacks;
 }  // namespace routeguide::RouteChat
@@ -8,12 +8,201 @@
 #include <Event.h>
 #include <EventLoop.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#include "applications/reactor/reactor_overload.h"
+#include "applications/reactor/reactor_scheduler.h"
 
 namespace RpcReactor {
 
+namespace internal {
+/// Event data queued by TriggerEvent(): the application data and the enqueue time.
+struct QueuedEvent {
+  void* data;
+  std::chrono::steady_clock::time_point enqueued;
+  std::atomic<uint32_t> next;  ///< next free slot, while in the free list
+};
+
+/// Fixed pool of the QueuedEvent slots. TriggerEvent() takes a slot and the dispatch of its event gives it back,
+/// through a lock-free free list whose head carries a tag against the ABA problem. The address range of the pool
+/// also tells a queued slot from the data of a raw EventLoop::TriggerEvent(), given through untouched.
+class QueuedEventPool {
+ public:
+  static constexpr uint32_t kCapacity = 1 << 16;
+
+  QueuedEventPool() : slots_(new QueuedEvent[kCapacity]) {
+    for (uint32_t index = 0; index < kCapacity; ++index) slots_[index].next.store(index + 1, std::memory_order_relaxed);
+  }
+
+  /// @return free slot, nullptr if kCapacity events are already queued
+  QueuedEvent* Acquire() {
+    auto head = head_.load(std::memory_order_acquire);
+    while (true) {
+      const auto index = static_cast<uint32_t>(head);
+      if (index == kCapacity) return nullptr;
+      const auto next = slots_[index].next.load(std::memory_order_relaxed);
+      if (head_.compare_exchange_weak(head, Tagged(head, next), std::memory_order_acquire)) return &slots_[index];
+    }
+  }
+
+  void Release(QueuedEvent* slot) {
+    const auto index = static_cast<uint32_t>(slot - slots_.get());
+    auto head = head_.load(std::memory_order_relaxed);
+    do {
+      slot->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, Tagged(head, index), std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  /// @return slot of the pool at this address, nullptr for any other data
+  QueuedEvent* Find(void* data) const {
+    const auto address = reinterpret_cast<uintptr_t>(data);
+    const auto begin = reinterpret_cast<uintptr_t>(slots_.get());
+    if (address < begin || address >= begin + sizeof(QueuedEvent) * kCapacity) return nullptr;
+    return static_cast<QueuedEvent*>(data);
+  }
+
+ private:
+  /// @return head pointing at a slot, with the tag of the previous head incremented
+  static uint64_t Tagged(const uint64_t previous, const uint32_t index) {
+    return ((previous >> 32) + 1) << 32 | index;
+  }
+
+  const std::unique_ptr<QueuedEvent[]> slots_;
+  std::atomic<uint64_t> head_{0};  ///< tag in the high half, index of the first free slot in the low half
+};
+
+inline QueuedEventPool& GetQueuedEventPool() {
+  static QueuedEventPool pool;
+  return pool;
+}
+
+/// Callbacks of an event name. Once a name has an entry, its dispatcher stays registered with both schedulers for
+/// the process lifetime, so that every event queued for the name is dispatched, and its slot given back, once,
+/// whatever the EventConnections alive for the name.
+struct EventEntry {
+  struct Connection {
+    const void* owner;
+    std::function<void(EventLoop::Event*)> callback;
+  };
+
+  explicit EventEntry(std::string evt_name) : name(std::move(evt_name)) {}
+
+  const std::string name;
+  std::atomic_bool dispatched{false};  ///< dispatcher registered with both schedulers
+  Scheduler::EventId scheduler_event = nullptr;  ///< dispatcher interned by the busy-poll scheduler, once dispatched
+  /// Replaced on every change, so that a dispatch runs the callbacks out of the lock. Guarded by EventTable::mu.
+  std::shared_ptr<const std::vector<Connection>> connections = std::make_shared<const std::vector<Connection>>();
+};
+
+struct EventTable {
+  std::shared_mutex mu;
+  std::unordered_map<std::string, std::unique_ptr<EventEntry>> entries;  // guarded by mu
+};
+
+inline EventTable& GetEventTable() {
+  static EventTable table;
+  return table;
+}
+
+/// @return entry of the name once its events are dispatched by DispatchEvent(), nullptr before. Entries are never
+/// erased, the pointer stays valid.
+inline const EventEntry* FindDispatched(const std::string& evt_name) {
+  auto& table = GetEventTable();
+  std::shared_lock lock(table.mu);
+  const auto it = table.entries.find(evt_name);
+  if (it == table.entries.end() || !it->second->dispatched.load(std::memory_order_acquire)) return nullptr;
+  return it->second.get();
+}
+
+/// Dispatches an event to the callbacks of its name, on the application thread: the single place where a queued
+/// slot is given back and the event counted as dispatched.
+inline void DispatchEvent(const EventEntry& entry, void* data) {
+  std::shared_ptr<const std::vector<EventEntry::Connection>> connections;
+  {
+    std::shared_lock lock(GetEventTable().mu);
+    connections = entry.connections;
+  }
+  auto& pool = GetQueuedEventPool();
+  if (auto* queued = pool.Find(data)) {
+    data = queued->data;
+    const auto enqueued = queued->enqueued;
+    pool.Release(queued);
+    Overload::OnDispatch(enqueued);
+  }
+  EventLoop::Event event(entry.name, data);
+  for (const auto& connection : *connections) connection.callback(&event);
+}
+
+inline void Connect(const std::string& evt_name, const void* owner, std::function<void(EventLoop::Event*)> callback) {
+  auto& table = GetEventTable();
+  EventEntry* created = nullptr;
+  {
+    std::unique_lock lock(table.mu);
+    auto& entry = table.entries[evt_name];
+    if (!entry) {
+      entry = std::make_unique<EventEntry>(evt_name);
+      created = entry.get();
+    }
+    auto connections = std::make_shared<std::vector<EventEntry::Connection>>(*entry->connections);
+    connections->push_back({owner, std::move(callback)});
+    entry->connections = std::move(connections);
+  }
+  if (created) {
+    // Out of the lock: a scheduler may hold its own lock while it dispatches, and the dispatch takes this one.
+    EventLoop::RegisterEvent(evt_name,
+                             [created](EventLoop::Event* event) { DispatchEvent(*created, event->getData()); });
+    created->scheduler_event = Scheduler::internal::Register([created](void* data) { DispatchEvent(*created, data); });
+    created->dispatched.store(true, std::memory_order_release);
+  }
+}
+
+inline void Disconnect(const std::string& evt_name, const void* owner) {
+  auto& table = GetEventTable();
+  std::unique_lock lock(table.mu);
+  auto& entry = *table.entries.at(evt_name);
+  auto connections = std::make_shared<std::vector<EventEntry::Connection>>(*entry.connections);
+  std::erase_if(*connections, [owner](const auto& connection) { return connection.owner == owner; });
+  entry.connections = std::move(connections);
+}
+}  // namespace internal
+
+/// EventLoop::TriggerEvent() on the scheduling path of the overload signal (reactor_overload.h): the event is
+/// counted in the queue depth and timestamped until its dispatch, in a slot of a fixed pool. The slot is given
+/// back at the dispatch whatever the EventConnections of the name, none or several, and a raw
+/// EventLoop::TriggerEvent() of the name reaches them with its data untouched. An event of a name that never had
+/// an EventConnection, or triggered while the pool is exhausted, is passed through uncounted. Once the busy-poll
+/// scheduler is enabled (reactor_scheduler.h), the event goes to its queue instead of the EventLoop one, with the
+/// dispatcher its name interned.
+/// @param evt_name event name registered by an EventConnection
+/// @param data given to the callback, usually the reactor
+inline void TriggerEvent(const std::string& evt_name, void* data) {
+  const auto* entry = internal::FindDispatched(evt_name);
+  auto* queued = entry ? internal::GetQueuedEventPool().Acquire() : nullptr;
+  if (queued) {
+    Overload::OnTrigger();
+    queued->data = data;
+    queued->enqueued = std::chrono::steady_clock::now();
+    data = queued;
+  }
+  if (Scheduler::Enabled()) {
+    // A name that never had an EventConnection has no handler: nothing to dispatch.
+    if (entry) Scheduler::internal::Push(entry->scheduler_event, data);
+  } else {
+    EventLoop::TriggerEvent(evt_name, data);
+  }
+}
+
 /// RAII wrapper for EventLoop::RegisterEvent()/DeregisterEvent().
 ///
 /// EventLoop::RegisterEvent() has no lifetime binding to the caller. The underlying library
@@ -22,25 +211,25 @@ namespace RpcReactor {
 /// and every later TriggerEvent() call for that name then invokes all of them, including
 /// callbacks that reference state their original owner has already destroyed.
 ///
-/// An EventConnection ties the registration to whatever scope or object holds it. While it lives,
-/// the callback is active. When it is destroyed, EventLoop::DeregisterEvent() runs automatically,
-/// so RegisterEvent()/DeregisterEvent() stay symmetric without every call site having to remember.
+/// An EventConnection ties the callback to whatever scope or object holds it. While it lives, the
+/// callback is active. When it is destroyed, the callback is removed, so it is never called with the
+/// state of a destroyed owner. The EventLoop library only sees one dispatcher per name, registered by
+/// the first EventConnection of the name and kept afterwards, which runs the callbacks of the
+/// EventConnections alive for the name: several of them all receive each event.
 ///
 /// Non-copyable and non-movable, since it owns exactly one registration for its own lifetime.
 class EventConnection {
  public:
   /// Registers a callback for evt_name for the lifetime of this object.
   /// @param evt_name event name to register with EventLoop
-  /// @param callback function invoked by EventLoop::TriggerEvent(evt_name, ...)
+  /// @param callback function invoked by RpcReactor::TriggerEvent(evt_name, ...)
   EventConnection(std::string evt_name, std::function<void(EventLoop::Event*)> callback)
       : evt_name_(std::move(evt_name)) {
-    EventLoop::RegisterEvent(evt_name_, callback);
+    internal::Connect(evt_name_, this, std::move(callback));
   }
 
   /// Deregisters the event, so a later TriggerEvent(evt_name) no longer reaches this callback.
-  ~EventConnection() {
-    EventLoop::DeregisterEvent(evt_name_);
-  }
+  ~EventConnection() { internal::Disconnect(evt_name_, this); }
 
   EventConnection(const EventConnection&) = delete;
   EventConnection& operator=(const EventConnection&) = delete;
@@ -0,0 +1,125 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <grpcpp/alarm.h>
+#include <grpcpp/support/status.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "applications/reactor/reactor_metrics.h"
+
+/************************
+ * Hold accounting of the read and bidi reactors
+ *
+ * OnReadDone() holds the RPC until the application consumes the response with GetResponse(), see "Guards component"
+ * in reactor_client.md. A servant that never calls GetResponse() pins the RPC and its gRPC resources forever, so
+ * every hold is timed, from AddHold() to RemoveHold(), in a histogram per reactor type. With a timeout configured,
+ * a hold still outstanding at its deadline cancels the RPC and releases itself: the reactor then reports
+ * ExpiredStatus() instead of the CANCELLED status of gRPC.
+ ************************/
+namespace RpcReactor {
+
+/// Options of the holds. A timeout of 0 lets the holds last forever.
+struct HoldOptions {
+  std::chrono::nanoseconds timeout{0};  ///< time given to the application to consume a response
+};
+
+namespace Hold {
+
+/// Status code of the RPCs cancelled by an expired hold. Neither the client nor the RouteGuide servers use it
+/// otherwise, together with kExpiredMessage it tells the expiry apart from the other failures.
+inline constexpr grpc::StatusCode kExpiredCode = grpc::StatusCode::ABORTED;
+inline constexpr const char* kExpiredMessage = "hold deadline exceeded, the response was not consumed in time";
+
+namespace internal {
+inline HoldOptions& GetOptions() {
+  static HoldOptions options;
+  return options;
+}
+}  // namespace internal
+
+/// Sets the options. Call it before the first reactor is created.
+inline void Configure(const HoldOptions& options) {
+  internal::GetOptions() = options;
+}
+
+/// @return status reported by the reactors whose hold expired
+inline const grpc::Status& ExpiredStatus() {
+  static const grpc::Status status(kExpiredCode, kExpiredMessage);
+  return status;
+}
+
+/// @return true if the status is the one of an expired hold
+inline bool IsExpired(const grpc::Status& status) {
+  return status.error_code() == kExpiredCode && status.error_message() == kExpiredMessage;
+}
+
+/// Hold of a reactor, taken by OnReadDone() on a gRPC thread and given back by the application thread.
+/// The deadline and the application race to release the hold: whichever claims it first owns the RemoveHold().
+class Tracker {
+ public:
+  explicit Tracker(const Metrics::ReactorType type) : type_(type) {}
+
+  Tracker(const Tracker&) = delete;
+  Tracker& operator=(const Tracker&) = delete;
+
+  /// A hold was added, on the gRPC thread.
+  /// @param expire called on a gRPC thread at the deadline if the hold was not claimed yet. It cancels the RPC and
+  ///               calls RemoveHold() last, the reactor may be gone right after.
+  void Start(std::function<void()> expire) {
+    start_ = std::chrono::steady_clock::now();
+    Metrics::Get().holds->Increment();
+    held_.store(true, std::memory_order_release);
+    const auto timeout = internal::GetOptions().timeout;
+    if (timeout.count() <= 0) return;
+    alarm_ = std::make_unique<grpc::Alarm>();
+    alarm_->Set(std::chrono::system_clock::now() + timeout, [this, expire = std::move(expire)](const bool fired) {
+      // Not fired: the alarm was cancelled by Claim() or by the destruction of the reactor.
+      if (!fired || !held_.exchange(false, std::memory_order_acq_rel)) return;
+      expired_ = true;
+      Record();
+      Metrics::Get().HoldsExpired(type_).Add();
+      expire();
+    });
+  }
+
+  /// The application takes the hold back, before releasing it or keeping it paused.
+  /// @return false if the deadline released it already: the RPC is cancelled, the response must not be read
+  bool Claim() {
+    if (!held_.exchange(false, std::memory_order_acq_rel)) return false;
+    alarm_.reset();
+    return true;
+  }
+
+  /// The application releases a claimed hold, right before RemoveHold().
+  void Release() { Record(); }
+
+  /// @return true if the deadline released the hold
+  bool Expired() const { return expired_; }
+
+ private:
+  void Record() {
+    const auto& metrics = Metrics::Get();
+    metrics.holds->Decrement();
+    metrics.HoldDuration(type_).Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count()));
+  }
+
+  const Metrics::ReactorType type_;
+  std::chrono::steady_clock::time_point start_;  // Written by Start(), read by the owner of the hold.
+  std::atomic_bool held_{false};
+  std::atomic_bool expired_{false};
+  std::unique_ptr<grpc::Alarm> alarm_;  // Only with a timeout. Set by Start(), reset by Claim().
+};
+
+}  // namespace Hold
+}  // namespace RpcReactor
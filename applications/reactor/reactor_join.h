@@ -0,0 +1,192 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <grpcpp/client_context.h>
+
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "applications/reactor/reactor_client.h"
+#include "applications/reactor/reactor_eventloop.h"
+
+/************************
+ * Completion combinators: one application event for a group of unary RPCs
+ *
+ * A fan-out, e.g. the same lookup on several shards, starts its RPCs in a join, which triggers a single event once
+ * its condition is met, with the join as the data of the event:
+ * - WhenAll: all the RPCs are done, whatever their status
+ * - WhenAny: the first RPC done with an OK status, the winner; the others are cancelled. If none succeeds, once all
+ *   of them are done, without a winner.
+ *
+ *   RpcReactor::Client::WhenAny<routeguide::GetFeature::ClientReactor> lookup("OnLookupDone");
+ *   for (auto& shard : shards) lookup.Add(*shard.stub, std::make_unique<grpc::ClientContext>(), point);
+ *   lookup.Seal();
+ *
+ * The join counts the completions from the gRPC threads; its RPCs are read on the application thread, by index,
+ * through the reactors themselves (Status(), GetResponse()).
+ ************************/
+namespace RpcReactor::Client {
+
+enum class JoinMode { kAll, kAny };
+
+/// Group of unary RPCs of a same method, completed by a single event.
+/// @tparam ReactorT unary reactor of the RPCs, e.g. an ActiveCall (reactor_call.h)
+/// @tparam kMode completion condition of the join
+template <class ReactorT, JoinMode kMode>
+requires std::derived_from<ReactorT, ActiveUnaryReactor<typename ReactorT::ResponseT>>
+class Join final {
+ public:
+  using RequestT = typename ReactorT::RequestT;
+  using ResponseT = typename ReactorT::ResponseT;
+
+  /// @param event name of the event triggered once complete, registered by an EventConnection
+  explicit Join(std::string event) : event_(std::move(event)) {}
+
+  /// Cancels the RPCs still running, e.g. the losers of a WhenAny, and waits for them to be done, which is prompt
+  /// once cancelled. Not from a gRPC thread.
+  ~Join() {
+    for (auto* reactor : Running()) reactor->TryCancel();
+    std::unique_lock lock(mu_);
+    returned_cv_.wait(lock, [this] { return returned_ == reactors_.size(); });
+  }
+
+  Join(const Join&) = delete;
+  Join& operator=(const Join&) = delete;
+  Join(Join&&) = delete;
+  Join& operator=(Join&&) = delete;
+
+  /// Starts an RPC of the join, before Seal(). An RPC added once a WhenAny has its winner is cancelled right away.
+  /// @param stub of the service, the stub of the shard
+  /// @param context associated with the RPC
+  /// @param request to send to the server
+  /// @return index of the RPC in the join
+  template <class StubT>
+  size_t Add(StubT& stub, std::unique_ptr<grpc::ClientContext> context, const RequestT& request) {
+    size_t index = 0;
+    typename ReactorT::Callbacks cbs;
+    {
+      std::lock_guard lock(mu_);
+      index = reactors_.size();
+      reactors_.emplace_back();
+      done_.push_back(false);
+    }
+    cbs.done = [this, index](grpc::ClientUnaryReactor*, const grpc::Status& status, const ResponseT&) {
+      OnDone(index, status.ok());
+    };
+    // Out of the lock: the RPC may complete on a gRPC thread before the reactor is stored.
+    auto reactor = std::make_unique<ReactorT>(stub, std::move(context), request, std::move(cbs));
+    bool cancel = false;
+    {
+      std::lock_guard lock(mu_);
+      reactors_[index] = std::move(reactor);
+      cancel = winner_.has_value();
+    }
+    if (cancel) Reactor(index).TryCancel();
+    return index;
+  }
+
+  /// Ends the additions: the join may complete from now on. A join already complete triggers its event right away.
+  void Seal() {
+    bool trigger = false;
+    {
+      std::lock_guard lock(mu_);
+      sealed_ = true;
+      trigger = Complete();
+    }
+    if (trigger) RpcReactor::TriggerEvent(event_, this);
+  }
+
+  /// @return RPCs of the join
+  size_t Size() const {
+    std::lock_guard lock(mu_);
+    return reactors_.size();
+  }
+
+  /// @return reactor of an RPC, to read its Status() and GetResponse() once the event is received
+  ReactorT& Reactor(const size_t index) {
+    std::lock_guard lock(mu_);
+    return *reactors_[index];
+  }
+
+  /// @return index of the first RPC done with an OK status, WhenAny only
+  std::optional<size_t> Winner() const requires(kMode == JoinMode::kAny) {
+    std::lock_guard lock(mu_);
+    return winner_;
+  }
+
+ private:
+  /// Counts a completion, on a gRPC thread.
+  void OnDone(const size_t index, const bool ok) {
+    bool trigger = false;
+    bool cancel = false;
+    {
+      std::lock_guard lock(mu_);
+      done_[index] = true;
+      ++completed_;
+      if (kMode == JoinMode::kAny && ok && !winner_.has_value()) {
+        winner_ = index;
+        cancel = true;
+      }
+      trigger = Complete();
+    }
+    // Out of the lock: the cancels may complete the losers on this thread.
+    if (cancel) {
+      for (auto* reactor : Running()) reactor->TryCancel();
+    }
+    if (trigger) RpcReactor::TriggerEvent(event_, this);
+    // Last access of this completion: the destructor may run from now on.
+    std::lock_guard lock(mu_);
+    ++returned_;
+    returned_cv_.notify_all();
+  }
+
+  /// @return true the first time the condition of the join is met. Under mu_.
+  bool Complete() {
+    if (triggered_ || !sealed_) return false;
+    const bool all_done = completed_ == reactors_.size();
+    triggered_ = kMode == JoinMode::kAny ? winner_.has_value() || all_done : all_done;
+    return triggered_;
+  }
+
+  /// @return reactors not done yet
+  std::vector<ReactorT*> Running() {
+    std::lock_guard lock(mu_);
+    std::vector<ReactorT*> running;
+    for (size_t i = 0; i < reactors_.size(); ++i) {
+      if (!done_[i] && reactors_[i]) running.push_back(reactors_[i].get());
+    }
+    return running;
+  }
+
+  const std::string event_;
+  mutable std::mutex mu_;
+  std::condition_variable returned_cv_;
+  std::vector<std::unique_ptr<ReactorT>> reactors_;  // guarded by mu_
+  std::vector<bool> done_;  // guarded by mu_
+  size_t completed_ = 0;  // guarded by mu_
+  size_t returned_ = 0;  // guarded by mu_
+  bool sealed_ = false;  // guarded by mu_
+  bool triggered_ = false;  // guarded by mu_
+  std::optional<size_t> winner_;  // guarded by mu_
+};
+
+/// Join triggering its event once all its RPCs are done.
+template <class ReactorT>
+using WhenAll = Join<ReactorT, JoinMode::kAll>;
+
+/// Join triggering its event at the first RPC done with an OK status, and cancelling the others.
+template <class ReactorT>
+using WhenAny = Join<ReactorT, JoinMode::kAny>;
+
+}  // namespace RpcReactor::Client
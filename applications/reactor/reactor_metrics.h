@@ -0,0 +1,161 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <grpcpp/support/status.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/************************
+ * Reactor metrics hook
+ *
+ * The reactor classes update these metrics on every reaction, through the interfaces below, which the
+ * application binds to its own metrics library with Install() before it starts any reactor, e.g.
+ * reactor_metrics_routeguide.h for rg_metrics.h. A metric left unbound costs a call to an empty function.
+ *
+ * The serialized sizes are the exception: counting them walks every message with ByteSizeLong(), so the
+ * reactors skip that walk unless the application binds `bytes_sent` and `bytes_received`.
+ ************************/
+namespace RpcReactor::Metrics {
+
+/// Kinds of generic reactor, the `type` label of the reactor metrics.
+enum class ReactorType : size_t { kUnary, kRead, kWrite, kBidi, kQty };
+
+/// Monotonic counter of the application's metrics library.
+class Counter {
+ public:
+  virtual ~Counter() = default;
+  virtual void Add(uint64_t value = 1) = 0;
+};
+
+/// Gauge of the application's metrics library.
+class Gauge {
+ public:
+  virtual ~Gauge() = default;
+  virtual void Add(int64_t delta) = 0;
+  virtual void Set(int64_t value) = 0;
+  void Increment() { Add(1); }
+  void Decrement() { Add(-1); }
+};
+
+/// Histogram of the application's metrics library.
+class Histogram {
+ public:
+  virtual ~Histogram() = default;
+  virtual void Record(uint64_t value) = 0;
+};
+
+/// Reactor and EventLoop metrics, as bound by the application. Null members of an installed set stay unbound.
+struct ReactorMetrics {
+  static constexpr size_t kTypeQty = static_cast<size_t>(ReactorType::kQty);
+  static constexpr size_t kCodeQty = 17;  ///< gRPC status codes, OK to UNAUTHENTICATED
+
+  std::array<Gauge*, kTypeQty> in_flight{};  ///< reactors alive
+  std::array<std::array<Counter*, kCodeQty>, kTypeQty> rpcs{};  ///< RPCs done, by status code
+  Gauge* holds = nullptr;  ///< holds taken by OnReadDone() and not yet removed by GetResponse()
+  std::array<Histogram*, kTypeQty> hold_duration{};  ///< nanoseconds from AddHold() to RemoveHold()
+  std::array<Counter*, kTypeQty> holds_expired{};  ///< holds released by their deadline
+  Counter* bytes_sent = nullptr;  ///< serialized size of the requests, null to skip ByteSizeLong()
+  Counter* bytes_received = nullptr;  ///< serialized size of the responses, null to skip ByteSizeLong()
+  Gauge* queue_depth = nullptr;  ///< events triggered and not yet dispatched, see reactor_eventloop.h
+  Counter* events_dispatched = nullptr;  ///< events dispatched to their EventConnection
+  Histogram* dispatch_delay = nullptr;  ///< nanoseconds from TriggerEvent() to the dispatch
+  Gauge* events_per_second = nullptr;  ///< events dispatched during the last second
+  Gauge* overloaded = nullptr;  ///< 1 while the overload signal is raised, see reactor_overload.h
+  Counter* overloads = nullptr;  ///< overload signals raised
+  /// Wakeups of the busy-poll scheduler by phase of its wait, spin, yield and park, see reactor_scheduler.h
+  std::array<Counter*, 3> scheduler_wakeups{};
+  Counter* pool_messages_allocated = nullptr;  ///< messages created by the pools, see reactor_pool.h
+  Counter* pool_messages_reused = nullptr;  ///< messages recycled by the pools
+
+  /// @return counter of the RPCs of a reactor type done with a status
+  Counter& Rpcs(ReactorType type, const grpc::Status& status) const {
+    const auto code = static_cast<size_t>(status.error_code());
+    return *rpcs[static_cast<size_t>(type)][code < kCodeQty ? code : static_cast<size_t>(grpc::StatusCode::UNKNOWN)];
+  }
+  Gauge& InFlight(ReactorType type) const { return *in_flight[static_cast<size_t>(type)]; }
+  Histogram& HoldDuration(ReactorType type) const { return *hold_duration[static_cast<size_t>(type)]; }
+  Counter& HoldsExpired(ReactorType type) const { return *holds_expired[static_cast<size_t>(type)]; }
+};
+
+namespace internal {
+class UnboundCounter final : public Counter {
+ public:
+  void Add(uint64_t) override {}
+};
+class UnboundGauge final : public Gauge {
+ public:
+  void Add(int64_t) override {}
+  void Set(int64_t) override {}
+};
+class UnboundHistogram final : public Histogram {
+ public:
+  void Record(uint64_t) override {}
+};
+
+/// @return the metrics with their null members, but the byte counters, bound to the empty metrics
+inline ReactorMetrics BindUnbound(ReactorMetrics metrics) {
+  static UnboundCounter counter;
+  static UnboundGauge gauge;
+  static UnboundHistogram histogram;
+  const auto bind = [](auto*& metric, auto& unbound) {
+    if (!metric) metric = &unbound;
+  };
+  for (size_t type = 0; type < ReactorMetrics::kTypeQty; ++type) {
+    bind(metrics.in_flight[type], gauge);
+    bind(metrics.hold_duration[type], histogram);
+    bind(metrics.holds_expired[type], counter);
+    for (auto*& rpcs : metrics.rpcs[type]) bind(rpcs, counter);
+  }
+  for (auto*& wakeups : metrics.scheduler_wakeups) bind(wakeups, counter);
+  bind(metrics.holds, gauge);
+  bind(metrics.queue_depth, gauge);
+  bind(metrics.events_dispatched, counter);
+  bind(metrics.dispatch_delay, histogram);
+  bind(metrics.events_per_second, gauge);
+  bind(metrics.overloaded, gauge);
+  bind(metrics.overloads, counter);
+  bind(metrics.pool_messages_allocated, counter);
+  bind(metrics.pool_messages_reused, counter);
+  return metrics;
+}
+
+inline ReactorMetrics& Installed() {
+  static ReactorMetrics metrics = BindUnbound({});
+  return metrics;
+}
+}  // namespace internal
+
+/// Binds the reactor metrics to the application's ones. Before the first reactor, event or scheduler: the
+/// reactors read the metrics without synchronization.
+/// @param metrics to update from now on, which must outlive the reactors
+inline void Install(const ReactorMetrics& metrics) { internal::Installed() = internal::BindUnbound(metrics); }
+
+/// @return reactor metrics, the empty ones until Install()
+inline const ReactorMetrics& Get() { return internal::Installed(); }
+
+/// Adds the serialized size of a message to a byte counter, if bound: the size is only computed then.
+template <class MessageT>
+void CountBytes(Counter* bytes, const MessageT& message) {
+  if (bytes) bytes->Add(message.ByteSizeLong());
+}
+
+/// Counts a reactor in the in-flight gauge of its type for the lifetime of this member.
+class InFlight {
+ public:
+  explicit InFlight(const ReactorType type) : gauge_(Get().InFlight(type)) { gauge_.Increment(); }
+  ~InFlight() { gauge_.Decrement(); }
+
+  InFlight(const InFlight&) = delete;
+  InFlight& operator=(const InFlight&) = delete;
+
+ private:
+  Gauge& gauge_;
+};
+
+}  // namespace RpcReactor::Metrics
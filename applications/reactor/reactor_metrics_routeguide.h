@@ -0,0 +1,185 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "rg_service/rg_metrics.h"
+
+#include "applications/reactor/reactor_metrics.h"
+
+/************************
+ * Reactor metrics bound to rg_metrics.h
+ *
+ * Registers the metrics of the reactor library (reactor_metrics.h) in the default registry of rg_metrics.h and
+ * installs them, for the route guide applications exporting that registry.
+ ************************/
+namespace routeguide::reactor_metrics {
+
+namespace internal {
+class CounterAdapter final : public RpcReactor::Metrics::Counter {
+ public:
+  explicit CounterAdapter(rg_metrics::Counter& counter) : counter_(counter) {}
+  void Add(const uint64_t value) override { counter_.Add(value); }
+
+ private:
+  rg_metrics::Counter& counter_;
+};
+
+class GaugeAdapter final : public RpcReactor::Metrics::Gauge {
+ public:
+  explicit GaugeAdapter(rg_metrics::Gauge& gauge) : gauge_(gauge) {}
+  void Add(const int64_t delta) override { gauge_.Add(delta); }
+  void Set(const int64_t value) override { gauge_.Set(value); }
+
+ private:
+  rg_metrics::Gauge& gauge_;
+};
+
+class HistogramAdapter final : public RpcReactor::Metrics::Histogram {
+ public:
+  explicit HistogramAdapter(rg_metrics::Histogram& histogram) : histogram_(histogram) {}
+  void Record(const uint64_t value) override { histogram_.Record(value); }
+
+ private:
+  rg_metrics::Histogram& histogram_;
+};
+}  // namespace internal
+
+/// Registered reactor and EventLoop metrics, to read them back, e.g. from the tests.
+struct Registered {
+  using ReactorType = RpcReactor::Metrics::ReactorType;
+  static constexpr size_t kTypeQty = RpcReactor::Metrics::ReactorMetrics::kTypeQty;
+  static constexpr size_t kCodeQty = RpcReactor::Metrics::ReactorMetrics::kCodeQty;
+
+  std::array<rg_metrics::Gauge*, kTypeQty> in_flight{};
+  std::array<std::array<rg_metrics::Counter*, kCodeQty>, kTypeQty> rpcs{};
+  rg_metrics::Gauge* holds = nullptr;
+  std::array<rg_metrics::Histogram*, kTypeQty> hold_duration{};
+  std::array<rg_metrics::Counter*, kTypeQty> holds_expired{};
+  rg_metrics::Counter* bytes_sent = nullptr;
+  rg_metrics::Counter* bytes_received = nullptr;
+  rg_metrics::Gauge* queue_depth = nullptr;
+  rg_metrics::Counter* events_dispatched = nullptr;
+  rg_metrics::Histogram* dispatch_delay = nullptr;
+  rg_metrics::Gauge* events_per_second = nullptr;
+  rg_metrics::Gauge* overloaded = nullptr;
+  rg_metrics::Counter* overloads = nullptr;
+  std::array<rg_metrics::Counter*, 3> scheduler_wakeups{};
+  rg_metrics::Counter* pool_messages_allocated = nullptr;
+  rg_metrics::Counter* pool_messages_reused = nullptr;
+
+  rg_metrics::Counter& Rpcs(ReactorType type, const grpc::Status& status) const {
+    const auto code = static_cast<size_t>(status.error_code());
+    return *rpcs[static_cast<size_t>(type)][code < kCodeQty ? code : static_cast<size_t>(grpc::StatusCode::UNKNOWN)];
+  }
+  rg_metrics::Gauge& InFlight(ReactorType type) const { return *in_flight[static_cast<size_t>(type)]; }
+  rg_metrics::Histogram& HoldDuration(ReactorType type) const { return *hold_duration[static_cast<size_t>(type)]; }
+  rg_metrics::Counter& HoldsExpired(ReactorType type) const { return *holds_expired[static_cast<size_t>(type)]; }
+};
+
+/// @return reactor metrics, registered in the default registry on the first call
+inline const Registered& Get() {
+  static const Registered registered = [] {
+    static constexpr const char* kTypeNames[] = {"unary", "read", "write", "bidi"};
+    auto& registry = rg_metrics::DefaultRegistry();
+    Registered metrics;
+    for (size_t type = 0; type < Registered::kTypeQty; ++type) {
+      metrics.in_flight[type] = &registry.GetGauge("rg_reactor_in_flight", "Client reactors alive, by type",
+                                                   {{"type", kTypeNames[type]}});
+      metrics.hold_duration[type] =
+          &registry.GetHistogram("rg_reactor_hold_duration_seconds",
+                                 "Time the RPCs are held for the application, by reactor type", 1e-9,
+                                 {{"type", kTypeNames[type]}});
+      metrics.holds_expired[type] =
+          &registry.GetCounter("rg_reactor_holds_expired_total",
+                               "Holds released by their deadline, cancelling the RPC", {{"type", kTypeNames[type]}});
+      for (size_t code = 0; code < Registered::kCodeQty; ++code) {
+        metrics.rpcs[type][code] = &registry.GetCounter(
+            "rg_reactor_rpcs_total", "Client RPCs done, by reactor type and status code",
+            {{"type", kTypeNames[type]}, {"code", std::string(rg_metrics::StatusCodeName(static_cast<int>(code)))}});
+      }
+    }
+    metrics.holds = &registry.GetGauge("rg_reactor_holds", "Holds taken on streams until the application reads");
+    metrics.bytes_sent = &registry.GetCounter("rg_reactor_bytes_sent_total", "Serialized bytes of the requests");
+    metrics.bytes_received =
+        &registry.GetCounter("rg_reactor_bytes_received_total", "Serialized bytes of the responses");
+    metrics.queue_depth =
+        &registry.GetGauge("rg_eventloop_queue_depth", "Reactor events triggered and not dispatched yet");
+    metrics.events_dispatched =
+        &registry.GetCounter("rg_eventloop_events_dispatched_total", "Reactor events dispatched to the application");
+    metrics.dispatch_delay =
+        &registry.GetHistogram("rg_eventloop_dispatch_delay_seconds",
+                               "Delay of the reactor events from their trigger to their dispatch", 1e-9);
+    metrics.events_per_second =
+        &registry.GetGauge("rg_eventloop_events_per_second", "Reactor events dispatched during the last second");
+    metrics.overloaded = &registry.GetGauge("rg_eventloop_overloaded", "1 while the application is overloaded");
+    metrics.overloads = &registry.GetCounter("rg_eventloop_overloads_total", "Overload signals raised");
+    static constexpr const char* kPhaseNames[] = {"spin", "yield", "park"};
+    for (size_t phase = 0; phase < metrics.scheduler_wakeups.size(); ++phase) {
+      metrics.scheduler_wakeups[phase] =
+          &registry.GetCounter("rg_scheduler_wakeups_total", "Wakeups of the busy-poll scheduler, by phase of its wait",
+                               {{"phase", kPhaseNames[phase]}});
+    }
+    metrics.pool_messages_allocated =
+        &registry.GetCounter("rg_reactor_pool_messages_total", "Messages handed out by the message pools, by origin",
+                             {{"origin", "allocated"}});
+    metrics.pool_messages_reused =
+        &registry.GetCounter("rg_reactor_pool_messages_total", "Messages handed out by the message pools, by origin",
+                             {{"origin", "reused"}});
+    return metrics;
+  }();
+  return registered;
+}
+
+/// Registers the reactor metrics and installs them in the reactor library, before the first reactor, see
+/// RpcReactor::Metrics::Install().
+/// @param bytes also count the serialized bytes of the messages, which costs a ByteSizeLong() per message
+inline void Install(const bool bytes = false) {
+  static const RpcReactor::Metrics::ReactorMetrics adapted = [] {
+    const auto& registered = Get();
+    // The adapters live as long as the registered metrics: for the process lifetime.
+    const auto counter = [](rg_metrics::Counter* metric) { return new internal::CounterAdapter(*metric); };
+    const auto gauge = [](rg_metrics::Gauge* metric) { return new internal::GaugeAdapter(*metric); };
+    const auto histogram = [](rg_metrics::Histogram* metric) { return new internal::HistogramAdapter(*metric); };
+    RpcReactor::Metrics::ReactorMetrics metrics;
+    for (size_t type = 0; type < Registered::kTypeQty; ++type) {
+      metrics.in_flight[type] = gauge(registered.in_flight[type]);
+      metrics.hold_duration[type] = histogram(registered.hold_duration[type]);
+      metrics.holds_expired[type] = counter(registered.holds_expired[type]);
+      for (size_t code = 0; code < Registered::kCodeQty; ++code) {
+        metrics.rpcs[type][code] = counter(registered.rpcs[type][code]);
+      }
+    }
+    metrics.holds = gauge(registered.holds);
+    metrics.bytes_sent = counter(registered.bytes_sent);
+    metrics.bytes_received = counter(registered.bytes_received);
+    metrics.queue_depth = gauge(registered.queue_depth);
+    metrics.events_dispatched = counter(registered.events_dispatched);
+    metrics.dispatch_delay = histogram(registered.dispatch_delay);
+    metrics.events_per_second = gauge(registered.events_per_second);
+    metrics.overloaded = gauge(registered.overloaded);
+    metrics.overloads = counter(registered.overloads);
+    for (size_t phase = 0; phase < metrics.scheduler_wakeups.size(); ++phase) {
+      metrics.scheduler_wakeups[phase] = counter(registered.scheduler_wakeups[phase]);
+    }
+    metrics.pool_messages_allocated = counter(registered.pool_messages_allocated);
+    metrics.pool_messages_reused = counter(registered.pool_messages_reused);
+    return metrics;
+  }();
+
+  auto installed = adapted;
+  if (!bytes) {
+    installed.bytes_sent = nullptr;
+    installed.bytes_received = nullptr;
+  }
+  RpcReactor::Metrics::Install(installed);
+}
+
+}  // namespace routeguide::reactor_metrics
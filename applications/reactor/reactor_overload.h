@@ -0,0 +1,146 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "applications/reactor/reactor_metrics.h"
+
+/************************
+ * Overload signal of the reactor scheduling path
+ *
+ * Every event goes from a gRPC thread (RpcReactor::TriggerEvent()) to the EventLoop queue, then to the application
+ * thread (RpcReactor::EventConnection), see reactor_eventloop.h. When the application thread falls behind, the events
+ * pile up in the queue. The scheduling path measures the queue depth and the enqueue-to-dispatch delay of every
+ * event, and raises the overload signal when one of them goes above its threshold. The signal clears once the
+ * depth is back to half its threshold and the delay to half its own, or the queue is empty.
+ *
+ * The application acts on the signal: the Proxy rejects new RPCs while Active(), and with `pause_reads` the read and
+ * bidi reactors stop restarting their reads until the application calls their ResumeReads(), usually from the
+ * listener once the signal clears.
+ ************************/
+namespace RpcReactor {
+
+/// Thresholds of the overload signal. A threshold of 0 is not checked.
+struct OverloadOptions {
+  int64_t max_queue_depth = 0;  ///< events waiting in the EventLoop queue
+  std::chrono::nanoseconds max_dispatch_delay{0};  ///< time from TriggerEvent() to the dispatch of an event
+  /// While overloaded, GetResponse() of the read and bidi reactors keeps the RPC held instead of restarting the read
+  bool pause_reads = false;
+};
+
+namespace Overload {
+
+/// Listener of the signal transitions, called on the application thread before the dispatch of the event that
+/// changed the signal.
+using Listener = std::function<void(bool overloaded)>;
+
+namespace internal {
+struct State {
+  OverloadOptions options;
+  Listener listener;
+  std::atomic<int64_t> depth{0};  ///< events triggered and not dispatched yet
+  std::atomic_bool active{false};
+  // Application thread only.
+  bool notified = false;  ///< last state given to the listener
+  std::chrono::steady_clock::time_point window_start = std::chrono::steady_clock::now();
+  uint64_t window_events = 0;
+};
+
+inline State& GetState() {
+  static State state;
+  return state;
+}
+}  // namespace internal
+
+/// Sets the thresholds. Call it before events flow, e.g. before EventLoop::Run().
+inline void Configure(const OverloadOptions& options) {
+  internal::GetState().options = options;
+}
+
+/// Sets the listener of the signal transitions. Same constraint as Configure().
+inline void SetListener(Listener listener) {
+  internal::GetState().listener = std::move(listener);
+}
+
+/// @return true while the application is overloaded. Any thread.
+inline bool Active() {
+  return internal::GetState().active.load(std::memory_order_relaxed);
+}
+
+/// @return true if the read reactors must pause their reads now
+inline bool PauseReads() {
+  return internal::GetState().options.pause_reads && Active();
+}
+
+/// @return events triggered and not dispatched yet
+inline int64_t QueueDepth() {
+  return internal::GetState().depth.load(std::memory_order_relaxed);
+}
+
+/// Scheduling path: an event is triggered, on a gRPC thread.
+inline void OnTrigger() {
+  auto& state = internal::GetState();
+  const auto depth = state.depth.fetch_add(1, std::memory_order_relaxed) + 1;
+  Metrics::Get().queue_depth->Increment();
+  // Raised here already, so that the Proxy sees it even while the application thread is stuck.
+  if (state.options.max_queue_depth > 0 && depth > state.options.max_queue_depth) {
+    state.active.store(true, std::memory_order_relaxed);
+  }
+}
+
+/// Scheduling path: an event is dispatched, on the application thread.
+/// @param enqueued time of its TriggerEvent()
+inline void OnDispatch(const std::chrono::steady_clock::time_point enqueued) {
+  auto& state = internal::GetState();
+  const auto& metrics = Metrics::Get();
+  const auto now = std::chrono::steady_clock::now();
+  const auto delay = now - enqueued;
+  const auto depth = state.depth.fetch_sub(1, std::memory_order_relaxed) - 1;
+  metrics.queue_depth->Decrement();
+  metrics.events_dispatched->Add();
+  metrics.dispatch_delay->Record(
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count()));
+  ++state.window_events;
+  if (now - state.window_start >= std::chrono::seconds(1)) {
+    const auto window = std::chrono::duration<double>(now - state.window_start).count();
+    metrics.events_per_second->Set(static_cast<int64_t>(static_cast<double>(state.window_events) / window));
+    state.window_start = now;
+    state.window_events = 0;
+  }
+
+  const auto& options = state.options;
+  const bool depth_check = options.max_queue_depth > 0;
+  const bool delay_check = options.max_dispatch_delay.count() > 0;
+  // An empty queue means the application caught up, whatever the delay of its last event.
+  const bool raise = (depth_check && depth > options.max_queue_depth) ||
+                     (delay_check && depth > 0 && delay > options.max_dispatch_delay);
+  const bool clear = (!depth_check || depth <= options.max_queue_depth / 2) &&
+                     (!delay_check || depth == 0 || delay <= options.max_dispatch_delay / 2);
+  // Only the transitions are written, by a CAS: a plain store of the state read before could undo the signal raised
+  // meanwhile by OnTrigger() on a gRPC thread.
+  auto active = state.active.load(std::memory_order_relaxed);
+  while (true) {
+    const bool next = raise || (active && !clear);
+    if (next == active || state.active.compare_exchange_weak(active, next, std::memory_order_relaxed)) {
+      active = next;
+      break;
+    }
+  }
+  if (active != state.notified) {
+    state.notified = active;
+    metrics.overloaded->Set(active ? 1 : 0);
+    if (active) metrics.overloads->Add();
+    if (state.listener) state.listener(active);
+  }
+}
+
+}  // namespace Overload
+}  // namespace RpcReactor
@@ -0,0 +1,105 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <google/protobuf/message.h>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "applications/reactor/reactor_metrics.h"
+
+/************************
+ * Message recycling pool of the application thread
+ *
+ * GetResponse() swaps the response read by the reactor with the message given by the servant, and the reactor reads
+ * the next response into the message it got back. With a new message per GetResponse(), every read of a stream
+ * parses into an empty message, whose strings, repeated fields and sub-messages are allocated again, and the message
+ * dropped by the servant frees them. A message of the pool goes back to it once consumed, cleared with Clear(): the
+ * message keeps the capacity of its strings and repeated fields, so the reactor reads the next response into buffers
+ * already allocated; depending on the protobuf version, Clear() frees the singular sub-messages instead. A stream then
+ * cycles through a few messages:
+ *
+ *   auto response = pool.Acquire();  // recycled message, or a new one
+ *   reactor->GetResponse(*response);
+ *   LogResponse(logger, *response);
+ *   // back to the pool here, or wherever the servant drops it
+ *
+ * The pool is for the application thread only, and outlives the messages it hands out.
+ ************************/
+namespace RpcReactor {
+
+/// Pool of cleared messages of a type, recycled instead of destroyed.
+/// @tparam MessageT type of protobuf message
+template <class MessageT>
+requires std::derived_from<MessageT, google::protobuf::Message>
+class MessagePool {
+ public:
+  /// Returns a message to its pool once the servant drops it.
+  class Recycler {
+   public:
+    Recycler() = default;
+    explicit Recycler(MessagePool* pool) : pool_(pool) {}
+    void operator()(MessageT* message) const { pool_->Recycle(message); }
+
+   private:
+    MessagePool* pool_ = nullptr;
+  };
+  /// Message handed out by the pool.
+  using Handle = std::unique_ptr<MessageT, Recycler>;
+
+  /// @param max_idle messages kept by the pool once recycled, the others are destroyed. It bounds the memory held by
+  ///                 the pool, each message keeping the capacity of the largest one it held.
+  explicit MessagePool(const size_t max_idle = 64) : max_idle_(max_idle) { idle_.reserve(max_idle); }
+
+  ~MessagePool() {
+    for (auto* message : idle_) delete message;
+  }
+
+  MessagePool(const MessagePool&) = delete;
+  MessagePool& operator=(const MessagePool&) = delete;
+
+  /// @return a recycled message, empty, or a new one if the pool has none
+  Handle Acquire() {
+    if (idle_.empty()) {
+      ++allocated_;
+      Metrics::Get().pool_messages_allocated->Add();
+      return Handle(new MessageT(), Recycler(this));
+    }
+    auto* message = idle_.back();
+    idle_.pop_back();
+    ++reused_;
+    Metrics::Get().pool_messages_reused->Add();
+    return Handle(message, Recycler(this));
+  }
+
+  /// @return messages waiting in the pool
+  size_t Idle() const { return idle_.size(); }
+  /// @return messages created by Acquire() since the construction
+  uint64_t Allocated() const { return allocated_; }
+  /// @return messages recycled by Acquire() since the construction
+  uint64_t Reused() const { return reused_; }
+
+ private:
+  void Recycle(MessageT* message) {
+    if (idle_.size() >= max_idle_) {
+      delete message;
+      return;
+    }
+    message->Clear();
+    idle_.push_back(message);
+  }
+
+  const size_t max_idle_;
+  std::vector<MessageT*> idle_;  // cleared messages, owned
+  uint64_t allocated_ = 0;
+  uint64_t reused_ = 0;
+};
+
+}  // namespace RpcReactor
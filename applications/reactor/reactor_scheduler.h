@@ -0,0 +1,294 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "applications/reactor/reactor_metrics.h"
+
+/************************
+ * Busy-poll scheduler of the application thread
+ *
+ * By default, the events of the reactors go through the EventLoop library (reactor_eventloop.h), whose application
+ * thread sleeps on a condition variable while its queue is empty: every event then pays the wakeup of the thread,
+ * several microseconds, on top of its own latency. Once enabled, the reactor scheduler takes over the queue and the
+ * dispatch of the events triggered by RpcReactor::TriggerEvent(), and waits for them in three phases:
+ * - spin: polls the queue with the `pause` instruction in between, for `spin`; the wakeup costs a cache miss
+ * - yield: polls the queue and gives the CPU back to the other runnable threads in between, for `yield`
+ * - park: sleeps on a futex, woken up by the next event, like the EventLoop thread
+ *
+ * Spinning trades a CPU for the latency: the application thread burns its CPU while the queue is empty, so it pays
+ * off only with a CPU dedicated to it (see rg_affinity.h). The same EventConnection handlers are dispatched, on the
+ * thread calling Scheduler::Run().
+ ************************/
+namespace RpcReactor {
+
+/// Wait strategy of the reactor scheduler. Both phases at 0 park right away.
+struct SchedulerOptions {
+  std::chrono::nanoseconds spin{0};  ///< time spinning on the queue once it is empty
+  std::chrono::nanoseconds yield{0};  ///< time yielding the CPU after the spin, before parking
+};
+
+namespace Scheduler {
+
+/// Phase of the wait in which a new event woke the scheduler up.
+enum class WakeupPhase : size_t { kSpin, kYield, kPark, kQty };
+
+/// Handler of an event, given the data of RpcReactor::TriggerEvent().
+using Handler = std::function<void(void* data)>;
+
+/// Event name interned by Register(): its handler, kept for the process lifetime.
+using EventId = const Handler*;
+
+namespace internal {
+/// Bounded queue of the events, many producers (the gRPC threads) and a single consumer (the scheduler thread),
+/// lock-free. Every cell carries a sequence telling whether it is free for the push of a position or filled for
+/// its pop, so that the producers only contend on the tail.
+class EventQueue {
+ public:
+  static constexpr uint64_t kCapacity = 1 << 16;
+
+  EventQueue() : cells_(new Cell[kCapacity]) {
+    for (uint64_t position = 0; position < kCapacity; ++position) {
+      cells_[position].sequence.store(position, std::memory_order_relaxed);
+    }
+  }
+
+  /// Any thread.
+  /// @return false if the queue is full
+  bool TryPush(const EventId event, void* data) {
+    auto position = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = cells_[position & (kCapacity - 1)];
+      const auto sequence = cell.sequence.load(std::memory_order_acquire);
+      const auto lag = static_cast<int64_t>(sequence - position);
+      if (lag == 0) {
+        if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          cell.event = event;
+          cell.data = data;
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (lag < 0) {
+        return false;  // the consumer did not pop the cell a lap ago yet
+      } else {
+        position = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Scheduler thread only. An event pushed but not filled yet by its producer ends the pop: it comes with the
+  /// Signal() of its push.
+  /// @return false if no event is ready
+  bool TryPop(EventId& event, void*& data) {
+    auto& cell = cells_[head_ & (kCapacity - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) return false;
+    event = cell.event;
+    data = cell.data;
+    cell.sequence.store(head_ + kCapacity, std::memory_order_release);
+    ++head_;
+    return true;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<uint64_t> sequence;
+    EventId event;
+    void* data;
+  };
+
+  const std::unique_ptr<Cell[]> cells_;
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) uint64_t head_ = 0;  // scheduler thread only
+};
+
+struct Pending {
+  EventId event;
+  void* data;
+};
+
+struct State {
+  std::atomic_bool enabled{false};
+  SchedulerOptions options;
+  std::mutex handlers_mu;
+  std::deque<Handler> handlers;  // guarded by handlers_mu, never erased: the EventIds point at them
+  EventQueue queue;
+  /// Thread in Run(). Its own pushes go to the overflow while the queue is full, it can't wait for itself.
+  std::atomic<std::thread::id> runner;
+  std::vector<Pending> overflow;  // scheduler thread only
+  /// Incremented by every push, the futex word of the parked scheduler.
+  std::atomic<uint32_t> sequence{0};
+  std::atomic_bool parked{false};
+  std::atomic_bool halted{false};
+  // Scheduler thread only.
+  std::array<uint64_t, static_cast<size_t>(WakeupPhase::kQty)> wakeups{};
+};
+
+inline State& GetState() {
+  static State state;
+  return state;
+}
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+inline void FutexWait(std::atomic<uint32_t>& word, const uint32_t expected) {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+inline void FutexWake(std::atomic<uint32_t>& word) {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+/// Wakes the scheduler up if it is parked. Pairs with the sequentially consistent accesses of Wait().
+inline void Signal(State& state) {
+  state.sequence.fetch_add(1, std::memory_order_seq_cst);
+  if (state.parked.load(std::memory_order_seq_cst)) FutexWake(state.sequence);
+}
+
+/// Queues an event, on a gRPC thread. While the queue is full, the producer yields until the scheduler catches up,
+/// and the scheduler thread itself, pushing from a handler, keeps its events in the overflow.
+inline void Push(const EventId event, void* data) {
+  auto& state = GetState();
+  if (state.runner.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+    // Behind the overflow once it started, in their order.
+    if (!state.overflow.empty() || !state.queue.TryPush(event, data)) state.overflow.push_back({event, data});
+    return;
+  }
+  while (!state.queue.TryPush(event, data)) {
+    Signal(state);
+    std::this_thread::yield();
+  }
+  Signal(state);
+}
+
+/// Interns an event name: its handler is resolved once, here, instead of at every dispatch. Called once per name,
+/// see EventConnection.
+/// @return id of the name, given to Push()
+inline EventId Register(Handler handler) {
+  auto& state = GetState();
+  std::lock_guard lock(state.handlers_mu);
+  return &state.handlers.emplace_back(std::move(handler));
+}
+
+/// Dispatches the events queued so far, in their order, at most a queue worth of them so that Halt() is seen.
+/// @param[in,out] batch empty, swapped with the overflow, so that both keep their capacity
+/// @return events dispatched
+inline size_t Dispatch(State& state, std::vector<Pending>& batch) {
+  size_t dispatched = 0;
+  EventId event = nullptr;
+  void* data = nullptr;
+  while (dispatched < EventQueue::kCapacity) {
+    if (!state.queue.TryPop(event, data)) {
+      // Pushed by the handlers once the queue was full, after all of its events.
+      batch.swap(state.overflow);
+      break;
+    }
+    (*event)(data);
+    ++dispatched;
+  }
+  for (const auto& pending : batch) (*pending.event)(pending.data);
+  dispatched += batch.size();
+  batch.clear();
+  return dispatched;
+}
+
+/// Waits for the sequence to move past `seen`, or for Halt().
+inline void Wait(State& state, const uint32_t seen) {
+  const auto& metrics = Metrics::Get();
+  auto woken = [&state, seen] { return state.sequence.load(std::memory_order_acquire) != seen; };
+  auto count = [&state, &metrics](const WakeupPhase phase) {
+    ++state.wakeups[static_cast<size_t>(phase)];
+    metrics.scheduler_wakeups[static_cast<size_t>(phase)]->Add();
+  };
+  const auto start = std::chrono::steady_clock::now();
+  const auto spin_end = start + state.options.spin;
+  const auto yield_end = spin_end + state.options.yield;
+  if (state.options.spin.count() > 0) {
+    // Reads the clock once every 64 polls, it costs more than the poll itself.
+    do {
+      for (int i = 0; i < 64; ++i) {
+        if (woken()) return count(WakeupPhase::kSpin);
+        CpuRelax();
+      }
+    } while (std::chrono::steady_clock::now() < spin_end);
+  }
+  if (state.options.yield.count() > 0) {
+    do {
+      if (woken()) return count(WakeupPhase::kYield);
+      std::this_thread::yield();
+    } while (std::chrono::steady_clock::now() < yield_end);
+  }
+  state.parked.store(true, std::memory_order_seq_cst);
+  // The futex returns right away once the sequence moved past `seen`, so a push after the check is not lost.
+  while (state.sequence.load(std::memory_order_seq_cst) == seen) FutexWait(state.sequence, seen);
+  state.parked.store(false, std::memory_order_relaxed);
+  count(WakeupPhase::kPark);
+}
+}  // namespace internal
+
+/// Routes the events of RpcReactor::TriggerEvent() to this scheduler instead of the EventLoop library. Call it
+/// before events flow, e.g. before the first RPC, and then Run() instead of EventLoop::Run().
+inline void Enable(const SchedulerOptions& options) {
+  auto& state = internal::GetState();
+  state.options = options;
+  state.enabled.store(true, std::memory_order_release);
+}
+
+/// @return true once Enable() was called
+inline bool Enabled() {
+  return internal::GetState().enabled.load(std::memory_order_acquire);
+}
+
+/// Dispatches the events on the calling thread, the application thread, until Halt().
+inline void Run() {
+  auto& state = internal::GetState();
+  std::vector<internal::Pending> batch;
+  state.runner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+  while (!state.halted.load(std::memory_order_acquire)) {
+    // Read before the dispatch: an event pushed during the dispatch ends the wait right away.
+    const auto seen = state.sequence.load(std::memory_order_acquire);
+    if (internal::Dispatch(state, batch) > 0) continue;
+    internal::Wait(state, seen);
+  }
+  state.runner.store(std::thread::id(), std::memory_order_relaxed);
+  state.halted.store(false, std::memory_order_relaxed);
+}
+
+/// Makes Run() return once its current event is dispatched. Any thread. A Halt() before Run() makes it return
+/// right away.
+inline void Halt() {
+  auto& state = internal::GetState();
+  state.halted.store(true, std::memory_order_release);
+  internal::Signal(state);
+}
+
+/// @return wakeups of the scheduler in a phase of its wait since the start. Scheduler thread only.
+inline uint64_t Wakeups(const WakeupPhase phase) {
+  return internal::GetState().wakeups[static_cast<size_t>(phase)];
+}
+
+}  // namespace Scheduler
+}  // namespace RpcReactor
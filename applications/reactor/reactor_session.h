@@ -0,0 +1,236 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <grpcpp/client_context.h>
+
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "applications/reactor/reactor_client.h"
+#include "applications/reactor/reactor_eventloop.h"
+
+/************************
+ * Multiplexed sessions: many logical conversations over one bidirectional stream
+ *
+ * A conversation per stream pays the setup of the RPC and the HTTP/2 state of the stream, for each conversation. A
+ * SessionMux carries many of them, the sessions, over one ActiveBidiReactor: every message is tagged with the id of
+ * its session (the `session_id` field of RouteNote), the requests of all the sessions are written one at a time, in
+ * their order, and the responses are dispatched to the callbacks of their session, on the application thread.
+ *
+ * A session is closed by an empty message of its own, acknowledged by the server with the same empty message, while
+ * the stream and the other sessions go on. Session 0 is the conversation of a stream that is not multiplexed, and
+ * can't be opened. With the `pause_reads` overload option, the stream stops reading like any bidi reactor, until
+ * ResumeReads().
+ *
+ *   RpcReactor::Client::SessionMux<routeguide::RouteChat::ClientReactor> chat("Chat", stub, std::move(context));
+ *   chat.Open(42, {.read = on_note, .closed = on_closed});
+ *   chat.Send(42, note);
+ *   chat.Close(42);
+ ************************/
+namespace RpcReactor::Client {
+
+/// Protobuf message with a session id field.
+template <class MessageT>
+concept SessionMessage = requires(MessageT message, const uint64_t id) {
+  { message.session_id() } -> std::convertible_to<uint64_t>;
+  message.set_session_id(id);
+  message.clear_session_id();
+};
+
+/// Sessions multiplexed over one bidirectional stream. Application thread only, the thread of the EventLoop.
+/// @tparam ReactorT bidirectional reactor of the stream, e.g. an ActiveCall (reactor_call.h)
+template <class ReactorT>
+requires std::derived_from<ReactorT, ActiveBidiReactor<typename ReactorT::RequestT, typename ReactorT::ResponseT>> &&
+         SessionMessage<typename ReactorT::RequestT> && SessionMessage<typename ReactorT::ResponseT>
+class SessionMux final {
+ public:
+  using RequestT = typename ReactorT::RequestT;
+  using ResponseT = typename ReactorT::ResponseT;
+  using SessionId = uint64_t;
+
+  /// Callbacks of a session, on the application thread.
+  struct SessionCallbacks {
+    /// Response of the session, which the callback may swap out.
+    std::function<void(SessionId, ResponseT&)> read;
+    /// End of the session: OK once its close is acknowledged, or the status of the stream once it ends.
+    std::function<void(SessionId, const grpc::Status&)> closed;
+  };
+
+  /// Starts the stream. Its events are dispatched by EventConnections of the mux.
+  /// @param name prefix of the event names of the mux, unique among the live muxes
+  /// @param stub of the service
+  /// @param context associated with the stream
+  template <class StubT>
+  SessionMux(const std::string& name, StubT& stub, std::unique_ptr<grpc::ClientContext> context)
+      : on_read_(name + "OnReadDoneOk", [this](EventLoop::Event*) { OnRead(); }),
+        on_write_(name + "OnWriteDone", [this](EventLoop::Event*) { OnWrite(); }),
+        on_done_(name + "OnDone", [this](EventLoop::Event*) { OnDone(); }) {
+    typename ReactorT::Callbacks cbs;
+    cbs.read_ok = [event = name + "OnReadDoneOk"](auto* reactor, const ResponseT&) -> bool {
+      RpcReactor::TriggerEvent(event, reactor);
+      return true;  // held until OnRead() gets the response
+    };
+    cbs.write_done = [event = name + "OnWriteDone"](auto* reactor, bool) { RpcReactor::TriggerEvent(event, reactor); };
+    cbs.done = [event = name + "OnDone"](auto* reactor, const grpc::Status&) {
+      RpcReactor::TriggerEvent(event, reactor);
+    };
+    reactor_ = std::make_unique<ReactorT>(stub, std::move(context), std::move(cbs));
+  }
+
+  /// Destroy it once Done(): the reactor of the stream can't go before its OnDone().
+  ~SessionMux() { assert(!reactor_); }
+
+  SessionMux(const SessionMux&) = delete;
+  SessionMux& operator=(const SessionMux&) = delete;
+
+  /// Opens a session, whose messages can be sent from now on.
+  /// @param id of the session, not 0
+  /// @param cbs of the session
+  /// @return false if the id is 0 or already open, or the stream is done or closed
+  bool Open(const SessionId id, SessionCallbacks&& cbs) {
+    if (id == 0 || !reactor_ || stream_closing_) return false;
+    return sessions_.try_emplace(id, Session{std::move(cbs), false}).second;
+  }
+
+  /// Queues a request of a session, written once the ones before it are.
+  /// @param id of an open session
+  /// @param request of the session, its session id set by the mux
+  /// @return false if the session is not open, or closing
+  bool Send(const SessionId id, RequestT request) {
+    const auto it = sessions_.find(id);
+    if (it == sessions_.end() || it->second.closing || !reactor_) return false;
+    request.set_session_id(id);
+    pending_.push_back(std::move(request));
+    Flush();
+    return true;
+  }
+
+  /// Closes a session: queues its empty request, and its `closed` callback comes with the acknowledgement.
+  /// @param id of an open session
+  /// @return false if the session is not open, or already closing
+  bool Close(const SessionId id) {
+    const auto it = sessions_.find(id);
+    if (it == sessions_.end() || it->second.closing || !reactor_) return false;
+    RequestT request;
+    request.set_session_id(id);
+    pending_.push_back(std::move(request));
+    it->second.closing = true;
+    Flush();
+    return true;
+  }
+
+  /// Ends the requests of the stream once the queued ones are written. The server may still answer them; the stream
+  /// then ends, closing the sessions still open.
+  void CloseStream() {
+    stream_closing_ = true;
+    Flush();
+  }
+
+  /// Restarts the reading of the stream paused while the application was overloaded, see ActiveBidiReactor::
+  /// ResumeReads(). Call it from the listener of the overload signal once it clears (reactor_overload.h).
+  /// @return true if reading was paused
+  bool ResumeReads() { return reactor_ && reactor_->ResumeReads(); }
+
+  /// Cancels the stream, which closes the sessions still open. Any thread.
+  void TryCancel() const {
+    if (reactor_) reactor_->TryCancel();
+  }
+
+  /// @return sessions open, including the closing ones
+  size_t Sessions() const { return sessions_.size(); }
+  /// @return responses dropped since they belong to no open session
+  uint64_t Dropped() const { return dropped_; }
+  /// @return true once the stream is done, and all the sessions closed
+  bool Done() const { return !reactor_; }
+  /// @return status of the stream, once Done()
+  const grpc::Status& Status() const { return status_; }
+
+ private:
+  struct Session {
+    SessionCallbacks cbs;
+    bool closing;  // its empty request is queued or sent, waiting for the acknowledgement
+  };
+
+  /// Writes the next queued request, unless one is being written, or ends the requests once all are written.
+  void Flush() {
+    if (writing_ || !reactor_) return;
+    if (pending_.empty()) {
+      if (stream_closing_ && !writes_done_) writes_done_ = reactor_->CloseRequestStream();
+      return;
+    }
+    if (!reactor_->SendRequest(std::move(pending_.front()))) {
+      // The stream is over: OnDone() comes and closes the sessions.
+      pending_.clear();
+      return;
+    }
+    pending_.pop_front();
+    writing_ = true;
+  }
+
+  void OnWrite() {
+    writing_ = false;
+    Flush();
+  }
+
+  void OnRead() {
+    // Swapped with the response read: the reactor reads the next one into the previous buffers.
+    if (!reactor_ || !reactor_->GetResponse(response_)) return;
+    const auto it = sessions_.find(response_.session_id());
+    if (it == sessions_.end()) {
+      ++dropped_;
+      return;
+    }
+    if (it->second.closing && IsEmpty(response_)) {
+      auto cbs = std::move(it->second.cbs);
+      sessions_.erase(it);
+      if (cbs.closed) cbs.closed(response_.session_id(), grpc::Status::OK);
+      return;
+    }
+    if (it->second.cbs.read) it->second.cbs.read(it->first, response_);
+  }
+
+  void OnDone() {
+    status_ = reactor_->Status();
+    reactor_.reset();
+    auto sessions = std::move(sessions_);
+    sessions_.clear();
+    pending_.clear();
+    for (auto& [id, session] : sessions) {
+      if (session.cbs.closed) session.cbs.closed(id, status_);
+    }
+  }
+
+  /// @return true if the message is empty, but its session id
+  static bool IsEmpty(const ResponseT& response) {
+    ResponseT copy = response;
+    copy.clear_session_id();
+    return copy.ByteSizeLong() == 0;
+  }
+
+  // The EventConnections go last: they are deregistered first on destruction.
+  std::unique_ptr<ReactorT> reactor_;
+  std::map<SessionId, Session> sessions_;
+  std::deque<RequestT> pending_;  // requests waiting for the write in progress
+  ResponseT response_;  // last response read
+  grpc::Status status_;
+  uint64_t dropped_ = 0;
+  bool writing_ = false;
+  bool stream_closing_ = false;
+  bool writes_done_ = false;
+  RpcReactor::EventConnection on_read_;
+  RpcReactor::EventConnection on_write_;
+  RpcReactor::EventConnection on_done_;
+};
+
+}  // namespace RpcReactor::Client
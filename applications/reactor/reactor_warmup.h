@@ -0,0 +1,97 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <grpcpp/channel.h>
+#include <grpcpp/support/status.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/************************
+ * Client startup warmup: Following code belongs to the API implementation
+ * It is generic: the service-specific priming RPC is supplied by the caller.
+ *
+ * A gRPC channel starts IDLE and only connects on its first RPC, so without a warmup phase the first RPCs of
+ * the application pay for name resolution, the TCP and HTTP/2 handshakes, and the first-use allocations of the
+ * callback path. Warmup() moves that cost to startup, before the application thread runs its EventLoop.
+ ************************/
+namespace RpcReactor::Client {
+
+/// Settings of the warmup phase run by Warmup().
+struct WarmupOptions {
+  /// Time given to all the channels together to reach GRPC_CHANNEL_READY, counted from the start of Warmup().
+  std::chrono::milliseconds connect_timeout{5000};
+
+  /// Number of priming RPCs issued on each connected channel. 0 skips priming.
+  unsigned prime_rpcs = 0;
+
+  /// Function signature of a priming RPC. It issues one RPC on the given channel and blocks until that RPC is
+  /// done. It runs on the thread calling Warmup(), which is not yet the EventLoop thread.
+  /// @param channel connected channel the RPC is issued on
+  /// @return status of the priming RPC
+  using PrimeFunction = std::function<grpc::Status(const std::shared_ptr<grpc::Channel>& channel)>;
+  PrimeFunction prime;  ///< Slot for the priming RPC, unused when prime_rpcs is 0
+};
+
+/// Outcome of the warmup phase returned by Warmup().
+struct WarmupReport {
+  size_t channels = 0;           ///< Number of channels given to Warmup()
+  size_t channels_ready = 0;     ///< Number of channels that reached GRPC_CHANNEL_READY before the deadline
+  size_t prime_ok = 0;           ///< Number of priming RPCs that ended with an OK status
+  size_t prime_failed = 0;       ///< Number of priming RPCs that ended with any other status
+  std::chrono::nanoseconds connect_time{};   ///< Time until every channel was ready, or the deadline passed
+  std::chrono::nanoseconds time_to_ready{};  ///< Whole warmup duration: connect_time plus priming
+
+  /// @return true when every channel is connected and no priming RPC failed
+  bool Ready() const { return channels_ready == channels && prime_failed == 0; }
+};
+
+/// Connects every channel eagerly, then optionally primes each connected channel with RPCs.
+/// All the channels are first kicked out of IDLE so their connection attempts overlap, and only then awaited
+/// one after the other against the same deadline. A channel that does not connect in time is not primed;
+/// the report tells how many did.
+/// @param channels channels the application is about to use
+/// @param options deadline and priming settings
+/// @return counts and durations of the warmup phase
+inline WarmupReport Warmup(const std::vector<std::shared_ptr<grpc::Channel>>& channels,
+                           const WarmupOptions& options) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = std::chrono::system_clock::now() + options.connect_timeout;
+  WarmupReport report;
+  report.channels = channels.size();
+
+  for (const auto& channel : channels) {
+    channel->GetState(/*try_to_connect=*/true);
+  }
+  std::vector<const std::shared_ptr<grpc::Channel>*> ready;
+  ready.reserve(channels.size());
+  for (const auto& channel : channels) {
+    if (channel->WaitForConnected(deadline)) {
+      ready.push_back(&channel);
+    }
+  }
+  report.channels_ready = ready.size();
+  report.connect_time = std::chrono::steady_clock::now() - start;
+
+  if (options.prime) {
+    for (const auto* channel : ready) {
+      for (unsigned i = 0; i < options.prime_rpcs; ++i) {
+        if (options.prime(*channel).ok()) {
+          ++report.prime_ok;
+        } else {
+          ++report.prime_failed;
+        }
+      }
+    }
+  }
+  report.time_to_ready = std::chrono::steady_clock::now() - start;
+  return report;
+}
+
+}  // namespace RpcReactor::Client
@@ -13,6 +13,9 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <chrono>
+#include <ctime>
 #include <functional>
 #include <map>
 #include <memory>
@@ -23,13 +26,64 @@
 
 #include "applications/reactor/reactor_client_routeguide.h"
 #include "applications/reactor/reactor_eventloop.h"
+#include "applications/reactor/reactor_hold.h"
+#include "applications/reactor/reactor_metrics_routeguide.h"
+#include "applications/reactor/reactor_overload.h"
+#include "applications/reactor/reactor_pool.h"
+#include "applications/reactor/reactor_scheduler.h"
+#include "applications/reactor/reactor_warmup.h"
 #include "protobuf_utils/protobuf_utils.h"
+#include "rg_service/rg_affinity.h"
+#include "rg_service/rg_binlog.h"
 #include "rg_service/rg_db.h"
+#include "rg_service/rg_interceptors.h"
+#include "rg_service/rg_metrics.h"
+#include "rg_service/rg_stats.h"
 #include "rg_service/rg_utils.h"
 #include "rg_service/route_guide_service.h"
 
+DEFINE_string(address, "localhost:50051",
+              "Address of the server: host:port, unix:/path/to/socket or unix-abstract:name");
+DEFINE_bool(warmup, false, "Connect the channel and prime it with RPCs before the application starts");
+DEFINE_uint32(warmup_rpcs, 10, "Number of priming GetFeature RPCs issued by the warmup phase");
+DEFINE_uint32(warmup_timeout_ms, 5000, "Deadline of the warmup phase to connect the channel, in milliseconds");
+DEFINE_uint32(probe_rpcs, 0,
+              "When non-zero, measure the latency of the first N GetFeature RPCs instead of running the demo calls");
+DEFINE_uint32(overload_queue_depth, 0, "Events waiting for the application thread above which the client is "
+              "overloaded and rejects new RPCs, 0 for no limit");
+DEFINE_uint32(overload_delay_ms, 0, "Delay of the events to the application thread above which the client is "
+              "overloaded and rejects new RPCs, in milliseconds, 0 for no limit");
+DEFINE_bool(overload_pause_reads, false, "While overloaded, the streams also stop reading until the overload clears");
+DEFINE_uint32(hold_timeout_ms, 0, "Time given to the application to consume a stream response before the RPC is "
+              "cancelled, in milliseconds, 0 for no limit");
+DEFINE_string(binlog_dir, "", "Directory of the binary log: the responses are logged there as binary records, to be "
+              "rendered by rg_binlog_decode, instead of text on the console");
+DEFINE_uint32(metrics_port, 0, "Port of the HTTP listener exporting the reactor metrics in the Prometheus format, "
+              "0 for no metrics");
+DEFINE_bool(serialization_metrics, false, "Record the serialized size of the messages, the time spent serializing "
+            "them and a sampled parse time, per method, next to the reactor metrics, and count the reactor bytes");
+DEFINE_bool(busy_poll, false, "The application thread polls for the reactor events instead of sleeping on the "
+            "EventLoop queue: it spins, then yields, then parks. Burns its CPU while idle, pin it with --app_cpus");
+DEFINE_uint32(busy_poll_spin_us, 50, "With --busy_poll, time spinning once the queue is empty, in microseconds");
+DEFINE_uint32(busy_poll_yield_us, 50, "With --busy_poll, time yielding the CPU after the spin before parking, in "
+              "microseconds");
+DEFINE_string(placement, "none", "Thread placement preset: none, isolated (the application thread alone on the last "
+              "allowed CPU, the gRPC threads on the others) or compact (the application thread and the gRPC threads on "
+              "the first two allowed CPUs)");
+DEFINE_string(app_cpus, "", "CPUs of the application thread, which runs the EventLoop scheduler, e.g. \"3\", "
+              "overriding the --placement preset");
+DEFINE_string(grpc_cpus, "", "CPUs of the other threads: gRPC, EventEngine, metrics exporter, e.g. \"0-2\", "
+              "overriding the --placement preset");
+
 namespace {
 std::thread::id main_thread = std::this_thread::get_id();
+
+/// @return CPU time of the calling thread
+std::chrono::nanoseconds ThreadCpuTime() {
+  timespec time{};
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+}
 FeatureList feature_list_;
 
 std::unique_ptr<grpc::ClientContext> CreateClientContext() {
@@ -37,6 +91,18 @@ std::unique_ptr<grpc::ClientContext> CreateClientContext() {
   // context->set_wait_for_ready(true);
   return context;
 }
+
+/// Servant logic of the responses: logs them as text, or as binary records with --binlog_dir (rg_binlog.h), which
+/// keeps the formatting off the application thread.
+template <class ResponseT>
+void LogResponse(spdlog::logger& logger, const ResponseT& response) {
+  static const rg_binlog::Format<std::string_view, ResponseT> kResponse("[{}] RESPONSE | {}");
+  if (rg_binlog::Enabled()) {
+    kResponse.Log(logger.name(), response);
+    return;
+  }
+  logger.info("RESPONSE | {}: {}", response.GetTypeName(), protobuf_utils::ToString(response));
+}
 }  // anonymous namespace
 
 /************************
@@ -80,7 +146,7 @@ class RouteGuideClient {
       : stub_(routeguide::RouteGuide::NewStub(channel)),
         get_feature_on_done_(
             kGetFeatureOnDone,
-            [&reactor_ = reactor_map_[routeguide::GetFeature::RpcKey],
+            [this, &reactor_ = reactor_map_[routeguide::GetFeature::RpcKey],
              &logger = routeguide::logger::Get(routeguide::RpcMethods::kGetFeature)](const EventLoop::Event* event) {
               // (Point 3.5) ProceedEvent: OnDone
               assert(main_thread == std::this_thread::get_id());  // application thread
@@ -91,7 +157,7 @@ class RouteGuideClient {
                 routeguide::GetFeature::ResponseT response;
                 reactor->GetResponse(response);
                 // (Point 3.7) update application with response
-                logger.info("RESPONSE | {}: {}", response.GetTypeName(), protobuf_utils::ToString(response));
+                LogResponse(logger, response);
               } else {
                 logger.info("         | {} reactor: {} Status: OK: {} msg: {}", event->getName(), fmt::ptr(reactor),
                             status.ok(), status.error_message());
@@ -99,6 +165,9 @@ class RouteGuideClient {
               // (Point 3.8) Destroy reactor
               reactor_.reset();
               logger.info("         | reactor[{}] ended", fmt::ptr(reactor));
+              if (probe_remaining_ > 0) {
+                OnProbeDone();
+              }
             }),
         list_features_on_read_done_ok_(
             kListFeaturesOnReadDoneOk,
@@ -108,16 +177,16 @@ class RouteGuideClient {
               assert(main_thread == std::this_thread::get_id());  // application thread
               auto* reactor = static_cast<routeguide::ListFeatures::ClientReactor*>(event->getData());
               assert(reactor == reactor_.get());
-              // (Point 2.8, 2.9, 2.10, 2.11) extracts response and restart RPC
-              routeguide::ListFeatures::ResponseT response;
-              reactor->GetResponse(response);
+              // (Point 2.8, 2.9, 2.10, 2.11) extracts response and restart RPC, reading into a recycled message
+              const auto response = feature_pool_.Acquire();
+              reactor->GetResponse(*response);
               // (Point 2.12) update application with response
-              logger.info("RESPONSE | {}: {}", response.GetTypeName(), protobuf_utils::ToString(response));
+              LogResponse(logger, *response);
 #if 0
           // Triggering extra concurrency: Un-comment that #IF block to probe the refusal of concurrent RPC calls.
           // Each received result from stream is reused to trigger a concurrent unary RPC request. If the RPC already
           // has a pending operation, the new call is refused.
-          GetFeature(response.location());
+          GetFeature(response->location());
 #endif
             }),
         list_features_on_read_done_nok_(
@@ -142,6 +211,7 @@ class RouteGuideClient {
               const auto status = reactor->Status();
               // (Point 4.10) update application with status
               logger.info("         | {} reactor: {}", event->getName(), fmt::ptr(reactor));
+              if (RpcReactor::Hold::IsExpired(status)) logger.warn("         | {}", status.error_message());
               // (Point 4.11) Destroy reactor
               reactor_.reset();
               logger.info("         | reactor[{}] ended", fmt::ptr(reactor));
@@ -173,7 +243,7 @@ class RouteGuideClient {
               if (const auto status = reactor->Status(); status.ok()) {
                 routeguide::RecordRoute::ResponseT response;
                 reactor->GetResponse(response);
-                logger.info("RESPONSE | {}: {}", response.GetTypeName(), protobuf_utils::ToString(response));
+                LogResponse(logger, response);
               } else {
                 logger.info("         | {} reactor: {} Status: OK: {} msg: {}", event->getName(), fmt::ptr(reactor),
                             status.ok(), status.error_message());
@@ -183,15 +253,15 @@ class RouteGuideClient {
             }),
         route_chat_on_read_done_ok_(
             kRouteChatOnReadDoneOk,
-            [&reactor_ = reactor_map_[routeguide::RouteChat::RpcKey],
+            [this, &reactor_ = reactor_map_[routeguide::RouteChat::RpcKey],
              &logger = routeguide::logger::Get(routeguide::RpcMethods::kRouteChat)](const EventLoop::Event* event) {
               // ProceedEvent: OnReadDoneOk
               assert(main_thread == std::this_thread::get_id());  // application thread
               auto* reactor = static_cast<routeguide::RouteChat::ClientReactor*>(event->getData());
               assert(reactor == reactor_.get());
-              routeguide::RouteChat::ResponseT response;
-              reactor->GetResponse(response);
-              logger.info("RESPONSE | {}: {}", response.GetTypeName(), protobuf_utils::ToString(response));
+              const auto response = note_pool_.Acquire();
+              reactor->GetResponse(*response);
+              LogResponse(logger, *response);
             }),
         route_chat_on_read_done_nok_(
             kRouteChatOnReadDoneNOk,
@@ -244,11 +314,15 @@ class RouteGuideClient {
                   protobuf_utils::ToString(point));
       return;
     }
+    if (RpcReactor::Overload::Active()) {
+      logger.warn("         | application overloaded, rejecting the RPC");
+      return;
+    }
     Callbacks cbs;
     // (Point 3.4) TriggerEvent: OnDone
     cbs.done = [](auto* reactor, const grpc::Status&, const ResponseT&) {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kGetFeatureOnDone, reactor);
+      RpcReactor::TriggerEvent(kGetFeatureOnDone, reactor);
     };
 
     // (Point 1.1) Create reactor
@@ -271,23 +345,27 @@ class RouteGuideClient {
                   protobuf_utils::ToString(rect));
       return;
     }
+    if (RpcReactor::Overload::Active()) {
+      logger.warn("         | application overloaded, rejecting the RPC");
+      return;
+    }
 
     Callbacks cbs;
     // (Point 2.4) TriggerEvent: OnReadDoneOk
     cbs.ok = [](auto* reactor, const ResponseT&) -> bool {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kListFeaturesOnReadDoneOk, reactor);
+      RpcReactor::TriggerEvent(kListFeaturesOnReadDoneOk, reactor);
       return true;  // true: hold the RPC until the application proceeded the response
     };
     // (Point 4.3) TriggerEvent: OnReadDoneNOk
     cbs.nok = [](auto* reactor) {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kListFeaturesOnReadDoneNOk, reactor);
+      RpcReactor::TriggerEvent(kListFeaturesOnReadDoneNOk, reactor);
     };
     // (Point 4.6) TriggerEvent: OnDone
     cbs.done = [](auto* reactor, const grpc::Status&) {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kListFeaturesOnDone, reactor);
+      RpcReactor::TriggerEvent(kListFeaturesOnDone, reactor);
     };
 
     // (Point 1.1) Create reactor
@@ -311,6 +389,10 @@ class RouteGuideClient {
                   fmt::ptr(reactor_map_[RpcKey].get()), points.size());
       return;
     }
+    if (RpcReactor::Overload::Active()) {
+      logger.warn("         | application overloaded, rejecting the RPC");
+      return;
+    }
     if (points.empty()) {
       logger.info("         | no points to send, ignoring");
       return;
@@ -321,12 +403,12 @@ class RouteGuideClient {
     // TriggerEvent: OnWriteDone
     cbs.write_done = [](auto* reactor, bool) {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kRecordRouteOnWriteDone, reactor);
+      RpcReactor::TriggerEvent(kRecordRouteOnWriteDone, reactor);
     };
     // TriggerEvent: OnDone
     cbs.done = [](auto* reactor, const grpc::Status&, const ResponseT&) {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kRecordRouteOnDone, reactor);
+      RpcReactor::TriggerEvent(kRecordRouteOnDone, reactor);
     };
 
     // (Point 1.1) Create reactor
@@ -350,6 +432,10 @@ class RouteGuideClient {
                   fmt::ptr(reactor_map_[RpcKey].get()), notes.size());
       return;
     }
+    if (RpcReactor::Overload::Active()) {
+      logger.warn("         | application overloaded, rejecting the RPC");
+      return;
+    }
     if (notes.empty()) {
       logger.info("         | no notes to send, ignoring");
       return;
@@ -360,23 +446,23 @@ class RouteGuideClient {
     // TriggerEvent: OnReadDoneOk
     cbs.read_ok = [](auto* reactor, const ResponseT&) -> bool {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kRouteChatOnReadDoneOk, reactor);
+      RpcReactor::TriggerEvent(kRouteChatOnReadDoneOk, reactor);
       return true;  // true: hold the RPC until the application proceeded the response
     };
     // TriggerEvent: OnReadDoneNOk
     cbs.read_nok = [](auto* reactor) {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kRouteChatOnReadDoneNOk, reactor);
+      RpcReactor::TriggerEvent(kRouteChatOnReadDoneNOk, reactor);
     };
     // TriggerEvent: OnWriteDone
     cbs.write_done = [](auto* reactor, bool) {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kRouteChatOnWriteDone, reactor);
+      RpcReactor::TriggerEvent(kRouteChatOnWriteDone, reactor);
     };
     // TriggerEvent: OnDone
     cbs.done = [](auto* reactor, const grpc::Status&) {
       assert(main_thread != std::this_thread::get_id());  // gRPC thread
-      EventLoop::TriggerEvent(kRouteChatOnDone, reactor);
+      RpcReactor::TriggerEvent(kRouteChatOnDone, reactor);
     };
 
     // (Point 1.1) Create reactor
@@ -385,7 +471,65 @@ class RouteGuideClient {
     SendNextRouteChatNote();
   }
 
+  /// Listener of the overload signal (reactor_overload.h), on the application thread. While overloaded, the Proxy
+  /// methods reject new RPCs, and with --overload_pause_reads the streams stop reading. Once the signal clears,
+  /// the paused streams resume.
+  void OnOverload(const bool overloaded) {
+    if (overloaded) {
+      spdlog::warn("OVERLOAD | raised: queue depth {}", RpcReactor::Overload::QueueDepth());
+      return;
+    }
+    spdlog::info("OVERLOAD | cleared: queue depth {}", RpcReactor::Overload::QueueDepth());
+    if (auto& reactor = reactor_map_[routeguide::ListFeatures::RpcKey]) {
+      static_cast<routeguide::ListFeatures::ClientReactor*>(reactor.get())->ResumeReads();
+    }
+    if (auto& reactor = reactor_map_[routeguide::RouteChat::RpcKey]) {
+      static_cast<routeguide::RouteChat::ClientReactor*>(reactor.get())->ResumeReads();
+    }
+  }
+
+  /// Proxy component: issues `count` GetFeature RPCs one after the other, each one from the OnDone handler of
+  /// the previous one, and logs the latency distribution once the last one is done. The latency of one RPC
+  /// spans from its Proxy call to its OnDone handler on the application thread. Meant to be the first RPCs of
+  /// the application, to measure the cold-start cost with or without a warmup phase.
+  void ProbeGetFeature(const size_t count) {
+    if (count == 0) return;
+    probe_remaining_ = count;
+    probe_latency_.Reset();
+    probe_start_ = std::chrono::steady_clock::now();
+    probe_run_start_ = probe_start_;
+    probe_cpu_start_ = ThreadCpuTime();
+    for (size_t phase = 0; phase < probe_wakeups_.size(); ++phase) {
+      probe_wakeups_[phase] = RpcReactor::Scheduler::Wakeups(static_cast<RpcReactor::Scheduler::WakeupPhase>(phase));
+    }
+    GetFeature(rg_utils::GetRandomPoint(feature_list_));
+  }
+
  private:
+  /// Records the latency of the probe RPC that just ended, then issues the next one or logs the summary.
+  void OnProbeDone() {
+    probe_latency_.Record(std::chrono::steady_clock::now() - probe_start_);
+    if (--probe_remaining_ > 0) {
+      probe_start_ = std::chrono::steady_clock::now();
+      GetFeature(rg_utils::GetRandomPoint(feature_list_));
+      return;
+    }
+    auto& logger = routeguide::logger::Get(routeguide::RpcMethods::kGetFeature);
+    rg_stats::LogSummary(logger, "PROBE    | latency", probe_latency_);
+    // The CPU side of the trade-off of the wait strategy: a spinning application thread stays busy between events.
+    const auto wall = std::chrono::steady_clock::now() - probe_run_start_;
+    const auto cpu = ThreadCpuTime() - probe_cpu_start_;
+    auto wakeups = [this](const RpcReactor::Scheduler::WakeupPhase phase) {
+      return RpcReactor::Scheduler::Wakeups(phase) - probe_wakeups_[static_cast<size_t>(phase)];
+    };
+    logger.info("PROBE    | application thread: {:.1f}% CPU over {:.3f}s, {}, wakeups spin {} yield {} park {}",
+                100.0 * std::chrono::duration<double>(cpu) / std::chrono::duration<double>(wall),
+                std::chrono::duration<double>(wall).count(),
+                RpcReactor::Scheduler::Enabled() ? "busy-poll scheduler" : "EventLoop scheduler",
+                wakeups(RpcReactor::Scheduler::WakeupPhase::kSpin), wakeups(RpcReactor::Scheduler::WakeupPhase::kYield),
+                wakeups(RpcReactor::Scheduler::WakeupPhase::kPark));
+  }
+
   /// Sends the next point queued for RecordRoute. Called once to fire the first write after
   /// creating the reactor, and again from the OnWriteDone handler until the list is exhausted.
   /// The last point is sent via SendLastRequest() to close the stream in the same operation.
@@ -425,6 +569,16 @@ class RouteGuideClient {
   // Points/notes still to be sent for the in-flight RecordRoute/RouteChat call, one at a time.
   std::vector<routeguide::Point> record_route_pending_;
   std::vector<routeguide::RouteNote> route_chat_pending_;
+  // Latency probe state, see ProbeGetFeature().
+  size_t probe_remaining_ = 0;
+  std::chrono::steady_clock::time_point probe_start_;
+  rg_stats::LatencyHistogram probe_latency_;
+  std::chrono::steady_clock::time_point probe_run_start_;
+  std::chrono::nanoseconds probe_cpu_start_{0};
+  std::array<uint64_t, static_cast<size_t>(RpcReactor::Scheduler::WakeupPhase::kQty)> probe_wakeups_{};
+  // Messages the streams are read into, recycled once logged instead of allocated per response.
+  RpcReactor::MessagePool<routeguide::ListFeatures::ResponseT> feature_pool_;
+  RpcReactor::MessagePool<routeguide::RouteChat::ResponseT> note_pool_;
   // EventLoop handler registrations, one per event name used above. Declared after reactor_map_
   // so it already exists when these are constructed, since their callbacks capture entries of it.
   RpcReactor::EventConnection get_feature_on_done_;
@@ -448,21 +602,87 @@ int main(int argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
   feature_list_ = rg_db::GetInitialFeatures();
-  RouteGuideClient guide(grpc::CreateChannel("localhost:50051", grpc::InsecureChannelCredentials()));
-
-  spdlog::info("-------------- ListFeatures --------------");
-  guide.ListFeatures(rg_utils::MakeRectangle(400000000, -750000000, 420000000, -730000000));
-  spdlog::info("-------------- GetFeature --------------");
-  guide.GetFeature(rg_utils::GetRandomPoint(feature_list_));
-  spdlog::info("-------------- RecordRoute --------------");
-  guide.RecordRoute({rg_utils::GetRandomPoint(feature_list_), rg_utils::GetRandomPoint(feature_list_),
-                     rg_utils::GetRandomPoint(feature_list_)});
-  spdlog::info("-------------- RouteChat --------------");
-  // The second note reuses the first note's location so the server echoes it back.
-  guide.RouteChat({rg_utils::MakeRouteNote("First message", 0, 0),
-                   rg_utils::MakeRouteNote("Second message", 0, 0),
-                   rg_utils::MakeRouteNote("Third message", 10000000, 0)});
-  EventLoop::Run();  // Scheduler component: Continuously processes queued events on main application thread
+  if (!FLAGS_binlog_dir.empty() && !rg_binlog::Open(FLAGS_binlog_dir, "route_guide_active_reactor_client")) return 1;
+  rg_metrics::HttpExporter metrics_exporter;
+  if (FLAGS_metrics_port != 0) {
+    // Before the first reactor. Without an exporter the reactor metrics stay unbound and cost nothing.
+    routeguide::reactor_metrics::Install(FLAGS_serialization_metrics);
+    if (!metrics_exporter.Start(FLAGS_metrics_port)) return 1;
+  }
+  std::vector<std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>> interceptors;
+  if (FLAGS_serialization_metrics) {
+    interceptors.push_back(std::make_unique<rg_interceptors::SerializationMetricsInterceptorFactory>());
+  }
+  const auto channel = grpc::experimental::CreateCustomChannelWithInterceptors(
+      FLAGS_address, grpc::InsecureChannelCredentials(), grpc::ChannelArguments(), std::move(interceptors));
+  // After the exporter and the channel: their threads exist, the later ones are caught by the periodic sweep.
+  rg_affinity::Placement placement;
+  {
+    rg_affinity::Preset preset;
+    rg_affinity::PlacementOptions options;
+    if (!rg_affinity::ParsePreset(FLAGS_placement, preset) ||
+        !rg_affinity::ParseCpuList(FLAGS_app_cpus, options.application) ||
+        !rg_affinity::ParseCpuList(FLAGS_grpc_cpus, options.others)) {
+      return 1;
+    }
+    options = rg_affinity::ApplyPreset(preset, rg_affinity::AllowedCpus(), std::move(options));
+    if (!placement.Start(options)) return 1;
+  }
+  if (FLAGS_warmup) {
+    spdlog::info("-------------- Warmup --------------");
+    RpcReactor::Client::WarmupOptions options;
+    options.connect_timeout = std::chrono::milliseconds(FLAGS_warmup_timeout_ms);
+    options.prime_rpcs = FLAGS_warmup_rpcs;
+    options.prime = [timeout = options.connect_timeout](const std::shared_ptr<grpc::Channel>& prime_channel) {
+      const auto stub = routeguide::RouteGuide::NewStub(prime_channel);
+      return routeguide::GetFeature::Prime(*stub, timeout);
+    };
+    const auto report = RpcReactor::Client::Warmup({channel}, options);
+    spdlog::info("Warmup {}: channels ready {}/{}, priming RPCs ok {} failed {}, connect {:.3f}ms, ready {:.3f}ms",
+                 report.Ready() ? "done" : "incomplete", report.channels_ready, report.channels, report.prime_ok,
+                 report.prime_failed, std::chrono::duration<double, std::milli>(report.connect_time).count(),
+                 std::chrono::duration<double, std::milli>(report.time_to_ready).count());
+  }
+  if (FLAGS_busy_poll) {
+    RpcReactor::SchedulerOptions scheduler;
+    scheduler.spin = std::chrono::microseconds(FLAGS_busy_poll_spin_us);
+    scheduler.yield = std::chrono::microseconds(FLAGS_busy_poll_yield_us);
+    RpcReactor::Scheduler::Enable(scheduler);
+  }
+  RouteGuideClient guide(channel);
+  RpcReactor::OverloadOptions overload;
+  overload.max_queue_depth = FLAGS_overload_queue_depth;
+  overload.max_dispatch_delay = std::chrono::milliseconds(FLAGS_overload_delay_ms);
+  overload.pause_reads = FLAGS_overload_pause_reads;
+  RpcReactor::Overload::Configure(overload);
+  RpcReactor::Overload::SetListener([&guide](const bool overloaded) { guide.OnOverload(overloaded); });
+  RpcReactor::HoldOptions hold;
+  hold.timeout = std::chrono::milliseconds(FLAGS_hold_timeout_ms);
+  RpcReactor::Hold::Configure(hold);
+
+  if (FLAGS_probe_rpcs > 0) {
+    spdlog::info("-------------- GetFeature latency probe --------------");
+    guide.ProbeGetFeature(FLAGS_probe_rpcs);
+  } else {
+    spdlog::info("-------------- ListFeatures --------------");
+    guide.ListFeatures(rg_utils::MakeRectangle(400000000, -750000000, 420000000, -730000000));
+    spdlog::info("-------------- GetFeature --------------");
+    guide.GetFeature(rg_utils::GetRandomPoint(feature_list_));
+    spdlog::info("-------------- RecordRoute --------------");
+    guide.RecordRoute({rg_utils::GetRandomPoint(feature_list_), rg_utils::GetRandomPoint(feature_list_),
+                       rg_utils::GetRandomPoint(feature_list_)});
+    spdlog::info("-------------- RouteChat --------------");
+    // The second note reuses the first note's location so the server echoes it back.
+    guide.RouteChat({rg_utils::MakeRouteNote("First message", 0, 0),
+                     rg_utils::MakeRouteNote("Second message", 0, 0),
+                     rg_utils::MakeRouteNote("Third message", 10000000, 0)});
+  }
+  // Scheduler component: Continuously processes queued events on main application thread
+  if (RpcReactor::Scheduler::Enabled()) {
+    RpcReactor::Scheduler::Run();
+  } else {
+    EventLoop::Run();
+  }
   spdlog::info("-------------- LEAVING APPLICATION --------------");
   return 0;
 }
@@ -112,6 +112,14 @@ class TestRouteGuideService final : public routeguide::RouteGuide::CallbackServi
 /// Test fixture with in-process server
 class ActiveReadReactorTest : public RouteGuideTestFixtureBase<TestRouteGuideService> {};
 
+/// Test fixture whose server stalls every ListFeatures response by 30ms
+class ActiveReadReactorStallTest : public RouteGuideTestFixtureBase<TestRouteGuideService> {
+ protected:
+  ActiveReadReactorStallTest() {
+    EXPECT_TRUE(rg_interceptors::ParseFaultPlan("ListFeatures:stall=1:30ms", server_faults_));
+  }
+};
+
 // =============================================================================
 // ListFeatures Server-Side Streaming Tests
 // =============================================================================
@@ -567,4 +575,43 @@ TEST_F(ActiveReadReactorTest, ListFeatures_NokCallback_FiresOnStreamEnd) {
   EXPECT_TRUE(nok_called) << "nok callback should fire when stream ends";
 }
 
+/// @test Validates that an injected stream stall delays the responses without failing the stream.
+///
+/// The server fault interceptor holds each of the 3 responses for 30ms before sending it.
+///
+/// Verifies that:
+/// - All 3 features are received and the status is OK
+/// - The stream lasts at least the 3 stalls
+TEST_F(ActiveReadReactorStallTest, ListFeatures_InjectedStall_DelaysResponses) {
+  std::vector<routeguide::Feature> features;
+  for (int i = 0; i < 3; ++i) {
+    features.push_back(rg_utils::MakeFeature("Feature " + std::to_string(i), 400000000 + i, -740000000));
+  }
+  test_service_.SetListFeaturesResponse(features);
+
+  std::atomic_int received{0};
+  std::promise<grpc::Status> done_promise;
+  std::future<grpc::Status> done_future = done_promise.get_future();
+
+  routeguide::ListFeatures::Callbacks cbs;
+  cbs.ok = [&received](grpc::ClientReadReactor<routeguide::Feature>*, const routeguide::Feature&) {
+    ++received;
+    return false;
+  };
+  cbs.done = [&done_promise](grpc::ClientReadReactor<routeguide::Feature>*, const grpc::Status& status) {
+    done_promise.set_value(status);
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  auto reactor = std::make_unique<routeguide::ListFeatures::ClientReactor>(
+      *stub_, CreateClientContext(), rg_utils::MakeRectangle(0, -800000000, 500000000, 0), std::move(cbs));
+
+  ASSERT_EQ(done_future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_TRUE(done_future.get().ok());
+  EXPECT_EQ(received, 3);
+  EXPECT_GE(elapsed, std::chrono::milliseconds(90));
+}
+
 }  // namespace
@@ -80,6 +80,43 @@ struct GetFeatureResult {
 /// Test fixture with in-process server
 class ActiveUnaryReactorTest : public RouteGuideTestFixtureBase<TestRouteGuideService> {};
 
+/// Test fixture with in-process server listening on a Unix domain socket
+class ActiveUnaryReactorUdsTest : public RouteGuideTestFixtureBase<TestRouteGuideService, FixtureTransport::kUnix> {};
+
+/// Test fixture whose server delays every GetFeature by 100ms, then fails it with UNAVAILABLE
+class ActiveUnaryReactorServerFaultTest : public RouteGuideTestFixtureBase<TestRouteGuideService> {
+ protected:
+  ActiveUnaryReactorServerFaultTest() {
+    EXPECT_TRUE(rg_interceptors::ParseFaultPlan("GetFeature:delay=100ms,error=1:UNAVAILABLE", server_faults_));
+  }
+};
+
+/// Test fixture whose stub fails every GetFeature with RESOURCE_EXHAUSTED, whatever the server answers
+class ActiveUnaryReactorClientFaultTest : public RouteGuideTestFixtureBase<TestRouteGuideService> {
+ protected:
+  ActiveUnaryReactorClientFaultTest() {
+    EXPECT_TRUE(rg_interceptors::ParseFaultPlan("GetFeature:error=1:RESOURCE_EXHAUSTED", client_faults_));
+  }
+};
+
+/// @return status of a GetFeature RPC issued with the given deadline
+grpc::Status CallGetFeature(routeguide::RouteGuide::Stub& stub, const std::chrono::milliseconds timeout) {
+  std::promise<grpc::Status> done_promise;
+  std::future<grpc::Status> done_future = done_promise.get_future();
+  routeguide::GetFeature::Callbacks cbs;
+  cbs.done = [&done_promise](grpc::ClientUnaryReactor*, const grpc::Status& status, const routeguide::Feature&) {
+    done_promise.set_value(status);
+  };
+  auto context = std::make_unique<grpc::ClientContext>();
+  context->set_deadline(std::chrono::system_clock::now() + timeout);
+  routeguide::GetFeature::ClientReactor reactor(stub, std::move(context), rg_utils::MakePoint(123, 456),
+                                                std::move(cbs));
+  if (done_future.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+    return grpc::Status(grpc::StatusCode::INTERNAL, "OnDone not called");
+  }
+  return done_future.get();
+}
+
 // =============================================================================
 // GetFeature Unary RPC Tests
 // =============================================================================
@@ -143,6 +180,47 @@ TEST_F(ActiveUnaryReactorTest, GetFeature_ValidPoint_ReturnsFeature) {
   EXPECT_EQ(result.feature.location().longitude(), expected_feature.location().longitude());
 }
 
+/// @test Validates the unary RPC flow over a Unix domain socket.
+///
+/// Same flow as GetFeature_ValidPoint_ReturnsFeature, with the in-process server listening on a
+/// `unix:` address instead of a TCP port. Verifies that the reactor is transport-agnostic.
+TEST_F(ActiveUnaryReactorUdsTest, GetFeature_UnixSocket_ReturnsFeature) {
+  ASSERT_EQ(server_address_.rfind("unix:", 0), 0U) << "Address: " << server_address_;
+  routeguide::Feature expected_feature;
+  expected_feature.set_name("Test Feature over UDS");
+  expected_feature.mutable_location()->set_latitude(407128000);
+  expected_feature.mutable_location()->set_longitude(-740060000);
+  test_service_.SetGetFeatureResponse(expected_feature);
+
+  std::promise<GetFeatureResult> result_promise;
+  std::future<GetFeatureResult> result_future = result_promise.get_future();
+
+  routeguide::GetFeature::Callbacks cbs;
+  cbs.done = [&result_promise](grpc::ClientUnaryReactor* base_reactor,
+                                const grpc::Status& status,
+                                const routeguide::Feature& response) {
+    GetFeatureResult result;
+    result.status = status;
+    if (status.ok()) {
+      auto* reactor = static_cast<routeguide::GetFeature::ClientReactor*>(base_reactor);
+      reactor->GetResponse(result.feature);
+    }
+    result.completed = true;
+    result_promise.set_value(std::move(result));
+  };
+
+  auto reactor = std::make_unique<routeguide::GetFeature::ClientReactor>(
+      *stub_, CreateClientContext(), rg_utils::MakePoint(407128000, -740060000), std::move(cbs));
+
+  auto wait_result = result_future.wait_for(std::chrono::seconds(5));
+  ASSERT_EQ(wait_result, std::future_status::ready) << "Timeout waiting for RPC completion";
+
+  GetFeatureResult result = result_future.get();
+  EXPECT_TRUE(result.completed);
+  EXPECT_TRUE(result.status.ok()) << "Status: " << result.status.error_message();
+  EXPECT_EQ(result.feature.name(), expected_feature.name());
+}
+
 /// @test Validates unary RPC with empty response (unknown point scenario).
 ///
 /// Tests the edge case where a valid RPC returns an empty feature:
@@ -444,4 +522,37 @@ TEST_F(ActiveUnaryReactorTest, GetFeature_GetResponseBeforeOnDone_ReturnsFalse)
   EXPECT_TRUE(get_response_after_done) << "GetResponse should return true after OnDone";
 }
 
+// =============================================================================
+// Injected Faults
+// =============================================================================
+
+/// @test Validates that the injected server error replaces the status, after the injected delay.
+TEST_F(ActiveUnaryReactorServerFaultTest, GetFeature_InjectedError_ReturnsCodeAfterDelay) {
+  test_service_.SetGetFeatureResponse(rg_utils::MakeFeature("Feature", 123, 456));
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto status = CallGetFeature(*stub_, std::chrono::seconds(5));
+
+  EXPECT_EQ(status.error_code(), grpc::StatusCode::UNAVAILABLE) << status.error_message();
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+}
+
+/// @test Validates that a deadline shorter than the injected delay expires.
+TEST_F(ActiveUnaryReactorServerFaultTest, GetFeature_InjectedDelay_ExceedsDeadline) {
+  test_service_.SetGetFeatureResponse(rg_utils::MakeFeature("Feature", 123, 456));
+
+  const auto status = CallGetFeature(*stub_, std::chrono::milliseconds(20));
+
+  EXPECT_EQ(status.error_code(), grpc::StatusCode::DEADLINE_EXCEEDED) << status.error_message();
+}
+
+/// @test Validates that the injected client error replaces the OK status of the server.
+TEST_F(ActiveUnaryReactorClientFaultTest, GetFeature_InjectedClientError_ReturnsCode) {
+  test_service_.SetGetFeatureResponse(rg_utils::MakeFeature("Feature", 123, 456));
+
+  const auto status = CallGetFeature(*stub_, std::chrono::seconds(5));
+
+  EXPECT_EQ(status.error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED) << status.error_message();
+}
+
 }  // namespace
@@ -12,7 +12,7 @@
 /// The test fixture creates:
 /// - An in-process gRPC server with controllable responses (TestRouteGuideService)
 /// - A real EventLoop running in NON_BLOCK mode (background thread)
-/// - Client reactors that dispatch via EventLoop::TriggerEvent()
+/// - Client reactors that dispatch via RpcReactor::TriggerEvent()
 ///
 /// @see /docs/testing.md for comprehensive test documentation
 
@@ -26,33 +26,23 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "rg_service/route_guide_service.h"
 #include "rg_service/rg_utils.h"
+#include "applications/reactor/reactor_call.h"
 #include "applications/reactor/reactor_eventloop.h"
 #include "applications/reactor/reactor_client_routeguide.h"
+#include "applications/reactor/reactor_metrics_routeguide.h"
 #include "applications/reactor/tests/route_guide_test_fixture.h"
 
 namespace {
 
-/// Global test environment to manage EventLoop lifecycle.
-/// EventLoop doesn't support restart after Halt(), so we start it once for all tests.
-class EventLoopEnvironment : public ::testing::Environment {
- public:
-  void SetUp() override {
-    EventLoop::SetMode(EventLoop::Mode::NON_BLOCK);
-    EventLoop::Run();
-  }
-
-  void TearDown() override {
-    EventLoop::Halt();
-  }
-};
-
 /// Controllable test service - returns preconfigured responses
 class TestRouteGuideService final : public routeguide::RouteGuide::CallbackService {
  public:
@@ -131,7 +121,7 @@ class ClientReactorIntegrationTest : public RouteGuideTestFixtureBase<TestRouteG
 ///
 /// Verifies the full production flow:
 /// 1. gRPC callback (OnDone) executes on gRPC thread pool
-/// 2. Callback triggers EventLoop::TriggerEvent()
+/// 2. Callback triggers RpcReactor::TriggerEvent()
 /// 3. EventLoop handler executes on EventLoop background thread
 /// 4. Response data is correctly extracted via GetResponse()
 ///
@@ -176,7 +166,7 @@ TEST_F(ClientReactorIntegrationTest, GetFeature_ValidPoint_DispatchesToEventLoop
                                                   const routeguide::Feature&) {
     // Verify we're on gRPC thread (NOT main thread)
     EXPECT_NE(std::this_thread::get_id(), main_thread_id);
-    EventLoop::TriggerEvent(kTestOnDone, r);
+    RpcReactor::TriggerEvent(kTestOnDone, r);
   };
 
   // Create reactor (Method Request in Active Object pattern)
@@ -264,14 +254,14 @@ TEST_F(ClientReactorIntegrationTest, ListFeatures_MultipleResponses_DispatchesTo
   cbs.ok = [&main_thread_id = main_thread_id_](grpc::ClientReadReactor<routeguide::Feature>* r,
                                                 const routeguide::Feature&) {
     EXPECT_NE(std::this_thread::get_id(), main_thread_id);
-    EventLoop::TriggerEvent(kTestOnReadOk, r);
+    RpcReactor::TriggerEvent(kTestOnReadOk, r);
     return true;  // Hold for GetResponse via EventLoop
   };
   cbs.nok = [](grpc::ClientReadReactor<routeguide::Feature>*) {};
   cbs.done = [&main_thread_id = main_thread_id_](grpc::ClientReadReactor<routeguide::Feature>* r,
                                                   const grpc::Status&) {
     EXPECT_NE(std::this_thread::get_id(), main_thread_id);
-    EventLoop::TriggerEvent(kTestOnDone, r);
+    RpcReactor::TriggerEvent(kTestOnDone, r);
   };
 
   // Create reactor
@@ -295,6 +285,310 @@ TEST_F(ClientReactorIntegrationTest, ListFeatures_MultipleResponses_DispatchesTo
   }
 }
 
+/// @test Validates the reactor metrics of a streaming RPC dispatched through the EventLoop.
+///
+/// Each response is counted in the received bytes and takes a hold until the handler calls
+/// `GetResponse()`; each event is counted in the queue depth until dispatched. Once the RPC is done
+/// and the reactor destroyed, the in-flight, hold and queue gauges are back to where they were,
+/// and the RPC is counted once under its status code.
+TEST_F(ClientReactorIntegrationTest, ListFeatures_MultipleResponses_UpdatesReactorMetrics) {
+  std::vector<routeguide::Feature> features;
+  uint64_t feature_bytes = 0;
+  for (int i = 0; i < 3; ++i) {
+    features.push_back(rg_utils::MakeFeature("Feature " + std::to_string(i), i * 100, i * -100));
+    feature_bytes += features.back().ByteSizeLong();
+  }
+  test_service_.SetListFeaturesResponse(features);
+
+  const auto& metrics = routeguide::reactor_metrics::Get();
+  const auto kRead = RpcReactor::Metrics::ReactorType::kRead;
+  const auto in_flight = metrics.InFlight(kRead).Value();
+  const auto holds = metrics.holds->Value();
+  const auto queue_depth = metrics.queue_depth->Value();
+  const auto dispatched = metrics.events_dispatched->Value();
+  const auto received = metrics.bytes_received->Value();
+  const auto rpcs_ok = metrics.Rpcs(kRead, grpc::Status::OK).Value();
+
+  std::atomic<bool> done{false};
+  std::unique_ptr<routeguide::ListFeatures::ClientReactor> reactor;
+  static constexpr auto kTestOnReadOk = "TestMetricsOnReadOk";
+  static constexpr auto kTestOnDone = "TestMetricsOnDone";
+  RpcReactor::EventConnection on_read_ok_guard(kTestOnReadOk, [](const EventLoop::Event* event) {
+    routeguide::Feature feature;
+    static_cast<routeguide::ListFeatures::ClientReactor*>(event->getData())->GetResponse(feature);
+  });
+  RpcReactor::EventConnection on_done_guard(kTestOnDone, [&done](const EventLoop::Event*) { done = true; });
+
+  routeguide::ListFeatures::Callbacks cbs;
+  cbs.ok = [](grpc::ClientReadReactor<routeguide::Feature>* r, const routeguide::Feature&) {
+    RpcReactor::TriggerEvent(kTestOnReadOk, r);
+    return true;
+  };
+  cbs.done = [](grpc::ClientReadReactor<routeguide::Feature>* r, const grpc::Status&) {
+    RpcReactor::TriggerEvent(kTestOnDone, r);
+  };
+  reactor = std::make_unique<routeguide::ListFeatures::ClientReactor>(*stub_, CreateClientContext(),
+                                                                      routeguide::Rectangle{}, std::move(cbs));
+  EXPECT_EQ(metrics.InFlight(kRead).Value(), in_flight + 1);
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done) {
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL() << "Timeout waiting for stream completion";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  reactor.reset();
+
+  EXPECT_EQ(metrics.InFlight(kRead).Value(), in_flight);
+  EXPECT_EQ(metrics.holds->Value(), holds);
+  EXPECT_EQ(metrics.queue_depth->Value(), queue_depth);
+  EXPECT_EQ(metrics.events_dispatched->Value(), dispatched + features.size() + 1);
+  EXPECT_EQ(metrics.bytes_received->Value(), received + feature_bytes);
+  EXPECT_EQ(metrics.Rpcs(kRead, grpc::Status::OK).Value(), rpcs_ok + 1);
+  EXPECT_NE(rg_metrics::DefaultRegistry().ExportText().find("rg_reactor_rpcs_total{type=\"read\",code=\"OK\"}"),
+            std::string::npos);
+}
+
+/// @test Validates the overload signal raised by the EventLoop queue depth.
+///
+/// The first event blocks the application thread while more events are triggered, so the queue
+/// grows past its threshold: the signal is raised at trigger time, before any dispatch. Once the
+/// application thread is released, the queue drains and the listener sees the signal raised, then
+/// cleared, on the application thread.
+TEST_F(ClientReactorIntegrationTest, Overload_QueueDepth_RaisesThenClears) {
+  constexpr int kEvents = 10;
+  RpcReactor::OverloadOptions options;
+  options.max_queue_depth = 4;
+  RpcReactor::Overload::Configure(options);
+  std::vector<bool> transitions;
+  RpcReactor::Overload::SetListener([&](const bool overloaded) {
+    EXPECT_NE(std::this_thread::get_id(), main_thread_id_);
+    transitions.push_back(overloaded);
+  });
+  const auto overloads = routeguide::reactor_metrics::Get().overloads->Value();
+
+  std::atomic<bool> release{false};
+  std::atomic<int> dispatched{0};
+  static constexpr auto kTestEvent = "TestOverloadEvent";
+  RpcReactor::EventConnection guard(kTestEvent, [&](const EventLoop::Event*) {
+    while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ++dispatched;
+  });
+  for (int i = 0; i < kEvents; ++i) {
+    RpcReactor::TriggerEvent(kTestEvent, nullptr);
+  }
+  EXPECT_TRUE(RpcReactor::Overload::Active());
+  release = true;
+
+  auto start = std::chrono::steady_clock::now();
+  while (dispatched < kEvents) {
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL() << "Timeout waiting for the queue to drain";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  RpcReactor::Overload::SetListener(nullptr);
+  RpcReactor::Overload::Configure({});
+
+  EXPECT_FALSE(RpcReactor::Overload::Active());
+  EXPECT_EQ(RpcReactor::Overload::QueueDepth(), 0);
+  EXPECT_EQ(transitions, (std::vector<bool>{true, false}));
+  EXPECT_EQ(routeguide::reactor_metrics::Get().overloads->Value(), overloads + 1);
+}
+
+/// @test Validates the events of a name with two EventConnections.
+///
+/// Both callbacks receive every event with its data, while the event is counted once in the queue
+/// depth and the dispatches: its queued slot is given back by a single dispatch.
+TEST_F(ClientReactorIntegrationTest, TriggerEvent_TwoConnections_DispatchedOnceToBoth) {
+  constexpr int kEvents = 5;
+  const auto& metrics = routeguide::reactor_metrics::Get();
+  const auto dispatched = metrics.events_dispatched->Value();
+  int data = 0;
+  std::atomic<int> first{0};
+  std::atomic<int> second{0};
+  static constexpr auto kTestEvent = "TestTwoConnectionsEvent";
+  RpcReactor::EventConnection first_guard(kTestEvent, [&](const EventLoop::Event* event) {
+    EXPECT_EQ(event->getData(), &data);
+    ++first;
+  });
+  RpcReactor::EventConnection second_guard(kTestEvent, [&](const EventLoop::Event* event) {
+    EXPECT_EQ(event->getData(), &data);
+    ++second;
+  });
+  for (int i = 0; i < kEvents; ++i) {
+    RpcReactor::TriggerEvent(kTestEvent, &data);
+  }
+
+  ASSERT_TRUE(WaitFor(second, kEvents));
+  EXPECT_EQ(first, kEvents);
+  EXPECT_EQ(RpcReactor::Overload::QueueDepth(), 0);
+  EXPECT_EQ(metrics.events_dispatched->Value(), dispatched + kEvents);
+}
+
+/// @test Validates the events that don't go through the scheduling path.
+///
+/// An event of a name that never had an EventConnection is not counted in the queue depth, and the
+/// data of a raw EventLoop::TriggerEvent() reaches the EventConnection of its name untouched.
+TEST_F(ClientReactorIntegrationTest, TriggerEvent_UnconnectedOrRaw_PassedThrough) {
+  RpcReactor::TriggerEvent("TestNeverConnectedEvent", nullptr);
+  EXPECT_EQ(RpcReactor::Overload::QueueDepth(), 0);
+
+  int data = 0;
+  std::atomic<void*> received{nullptr};
+  static constexpr auto kTestEvent = "TestRawEvent";
+  RpcReactor::EventConnection guard(kTestEvent, [&](const EventLoop::Event* event) { received = event->getData(); });
+  EventLoop::TriggerEvent(kTestEvent, &data);
+
+  auto start = std::chrono::steady_clock::now();
+  while (received == nullptr) {
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL() << "Timeout waiting for the event";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(received, &data);
+  EXPECT_EQ(RpcReactor::Overload::QueueDepth(), 0);
+}
+
+/// @test Validates the reads paused while overloaded.
+///
+/// With `pause_reads`, GetResponse() keeps the RPC held instead of restarting the read while the
+/// signal is raised, here by events that stay triggered and not dispatched. Every response is then
+/// only followed by the next one after ResumeReads(), and the stream completes once resumed.
+TEST_F(ClientReactorIntegrationTest, Overload_PauseReads_ResumesStream) {
+  std::vector<routeguide::Feature> features;
+  for (int i = 0; i < 3; ++i) {
+    features.push_back(rg_utils::MakeFeature("Feature " + std::to_string(i), i, i));
+  }
+  test_service_.SetListFeaturesResponse(features);
+
+  RpcReactor::OverloadOptions options;
+  options.max_queue_depth = 1;
+  options.pause_reads = true;
+  RpcReactor::Overload::Configure(options);
+  // Two events triggered and not dispatched keep the queue depth above its threshold.
+  RpcReactor::Overload::OnTrigger();
+  RpcReactor::Overload::OnTrigger();
+  ASSERT_TRUE(RpcReactor::Overload::PauseReads());
+
+  std::atomic<bool> done{false};
+  int paused = 0;
+  grpc::Status received_status;
+  std::unique_ptr<routeguide::ListFeatures::ClientReactor> reactor;
+  static constexpr auto kTestOnReadOk = "TestPauseOnReadOk";
+  static constexpr auto kTestOnDone = "TestPauseOnDone";
+  RpcReactor::EventConnection on_read_ok_guard(kTestOnReadOk, [&](const EventLoop::Event* event) {
+    auto* r = static_cast<routeguide::ListFeatures::ClientReactor*>(event->getData());
+    routeguide::Feature feature;
+    EXPECT_TRUE(r->GetResponse(feature));
+    if (r->ResumeReads()) ++paused;
+  });
+  RpcReactor::EventConnection on_done_guard(kTestOnDone, [&](const EventLoop::Event* event) {
+    received_status = static_cast<routeguide::ListFeatures::ClientReactor*>(event->getData())->Status();
+    done = true;
+  });
+
+  routeguide::ListFeatures::Callbacks cbs;
+  cbs.ok = [](grpc::ClientReadReactor<routeguide::Feature>* r, const routeguide::Feature&) {
+    RpcReactor::TriggerEvent(kTestOnReadOk, r);
+    return true;
+  };
+  cbs.done = [](grpc::ClientReadReactor<routeguide::Feature>* r, const grpc::Status&) {
+    RpcReactor::TriggerEvent(kTestOnDone, r);
+  };
+  reactor = std::make_unique<routeguide::ListFeatures::ClientReactor>(*stub_, CreateClientContext(),
+                                                                      routeguide::Rectangle{}, std::move(cbs));
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done) {
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL() << "Timeout waiting for stream completion";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // Dispatches the two pending events, which clears the signal.
+  RpcReactor::Overload::OnDispatch(std::chrono::steady_clock::now());
+  RpcReactor::Overload::OnDispatch(std::chrono::steady_clock::now());
+  RpcReactor::Overload::Configure({});
+
+  EXPECT_TRUE(received_status.ok()) << "Status: " << received_status.error_message();
+  EXPECT_EQ(paused, static_cast<int>(features.size()));
+  EXPECT_FALSE(RpcReactor::Overload::Active());
+}
+
+/// @test Validates the hold deadline of a response never consumed.
+///
+/// The handler ignores the first response, so its hold stays outstanding: at the deadline the hold
+/// cancels the RPC and releases itself, and the reactor reports the dedicated expired status instead
+/// of CANCELLED. The hold is timed and counted as expired, and the hold gauge is back to where it was.
+TEST_F(ClientReactorIntegrationTest, ListFeatures_HoldTimeout_CancelsStream) {
+  std::vector<routeguide::Feature> features;
+  for (int i = 0; i < 3; ++i) {
+    features.push_back(rg_utils::MakeFeature("Feature " + std::to_string(i), i, i));
+  }
+  test_service_.SetListFeaturesResponse(features);
+
+  RpcReactor::HoldOptions options;
+  options.timeout = std::chrono::milliseconds(50);
+  RpcReactor::Hold::Configure(options);
+  const auto& metrics = routeguide::reactor_metrics::Get();
+  const auto kRead = RpcReactor::Metrics::ReactorType::kRead;
+  const auto holds = metrics.holds->Value();
+  const auto expired = metrics.HoldsExpired(kRead).Value();
+  const auto rpcs_expired = metrics.Rpcs(kRead, RpcReactor::Hold::ExpiredStatus()).Value();
+  auto timed_holds = [&metrics, kRead] {
+    const auto snapshot = metrics.HoldDuration(kRead).Read();
+    return std::accumulate(snapshot.buckets.begin(), snapshot.buckets.end(), uint64_t{0});
+  };
+  const auto timed = timed_holds();
+
+  std::atomic<bool> done{false};
+  grpc::Status received_status;
+  bool late_response = true;
+  std::unique_ptr<routeguide::ListFeatures::ClientReactor> reactor;
+  static constexpr auto kTestOnReadOk = "TestHoldOnReadOk";
+  static constexpr auto kTestOnDone = "TestHoldOnDone";
+  RpcReactor::EventConnection on_read_ok_guard(kTestOnReadOk, [](const EventLoop::Event*) {});
+  RpcReactor::EventConnection on_done_guard(kTestOnDone, [&](const EventLoop::Event* event) {
+    auto* r = static_cast<routeguide::ListFeatures::ClientReactor*>(event->getData());
+    received_status = r->Status();
+    // The response left behind is not handed over anymore.
+    routeguide::Feature feature;
+    late_response = r->GetResponse(feature);
+    done = true;
+  });
+
+  routeguide::ListFeatures::Callbacks cbs;
+  cbs.ok = [](grpc::ClientReadReactor<routeguide::Feature>* r, const routeguide::Feature&) {
+    RpcReactor::TriggerEvent(kTestOnReadOk, r);
+    return true;
+  };
+  cbs.done = [](grpc::ClientReadReactor<routeguide::Feature>* r, const grpc::Status&) {
+    RpcReactor::TriggerEvent(kTestOnDone, r);
+  };
+  reactor = std::make_unique<routeguide::ListFeatures::ClientReactor>(*stub_, CreateClientContext(),
+                                                                      routeguide::Rectangle{}, std::move(cbs));
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done) {
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL() << "Timeout waiting for stream completion";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  reactor.reset();
+  RpcReactor::Hold::Configure({});
+
+  EXPECT_TRUE(RpcReactor::Hold::IsExpired(received_status)) << "Status: " << received_status.error_message();
+  EXPECT_FALSE(late_response);
+  EXPECT_EQ(metrics.holds->Value(), holds);
+  EXPECT_EQ(metrics.HoldsExpired(kRead).Value(), expired + 1);
+  EXPECT_EQ(metrics.Rpcs(kRead, RpcReactor::Hold::ExpiredStatus()).Value(), rpcs_expired + 1);
+  EXPECT_EQ(timed_holds(), timed + 1);
+}
+
 /// @test Validates cancellation triggers EventLoop dispatch.
 ///
 /// Verifies that `TryCancel()` correctly terminates an RPC and still dispatches
@@ -331,7 +625,7 @@ TEST_F(ClientReactorIntegrationTest, GetFeature_TryCancel_DispatchesToEventLoop)
 
   routeguide::GetFeature::Callbacks cbs;
   cbs.done = [](grpc::ClientUnaryReactor* r, const grpc::Status&, const routeguide::Feature&) {
-    EventLoop::TriggerEvent(kTestOnDone, r);
+    RpcReactor::TriggerEvent(kTestOnDone, r);
   };
 
   reactor = std::make_unique<routeguide::GetFeature::ClientReactor>(
@@ -353,10 +647,63 @@ TEST_F(ClientReactorIntegrationTest, GetFeature_TryCancel_DispatchesToEventLoop)
               received_status.error_code() == grpc::StatusCode::OK);
 }
 
+// =============================================================================
+// ActiveCall Binding Tests
+// =============================================================================
+
+/// @test Validates an ActiveCall bound to the method of the stub interface rather than of the stub.
+///
+/// The reactor, its messages and its callbacks are deduced from `&Stub::async_interface::GetFeature`,
+/// through ReactorMethod() for the overloaded unary method, and the RPC completes through the EventLoop
+/// like the RouteGuide specialization bound to `&Stub::async::GetFeature`.
+TEST_F(ClientReactorIntegrationTest, GetFeature_InterfaceMethodBinding_DispatchesToEventLoop) {
+  using Reactor = RpcReactor::Client::ActiveCall<RpcReactor::Client::ReactorMethod(
+      &routeguide::RouteGuide::StubInterface::async_interface::GetFeature)>;
+  static_assert(std::is_base_of_v<RpcReactor::Client::ActiveUnaryReactor<routeguide::Feature>, Reactor>);
+  static_assert(std::is_same_v<Reactor::RequestT, routeguide::Point>);
+  static_assert(std::is_same_v<Reactor::Callbacks, routeguide::GetFeature::Callbacks>);
+
+  routeguide::Feature expected_feature;
+  expected_feature.set_name("Interface Feature");
+  test_service_.SetGetFeatureResponse(expected_feature);
+
+  std::atomic<bool> done{false};
+  routeguide::Feature received_feature;
+  grpc::Status received_status;
+  std::unique_ptr<Reactor> reactor;
+
+  static constexpr auto kTestOnDone = "TestActiveCallOnDone";
+  RpcReactor::EventConnection on_done_guard(kTestOnDone, [&](const EventLoop::Event* event) {
+    auto* r = static_cast<Reactor*>(event->getData());
+    EXPECT_EQ(r, reactor.get());
+    received_status = r->Status();
+    if (received_status.ok()) r->GetResponse(received_feature);
+    done = true;
+  });
+
+  Reactor::Callbacks cbs;
+  cbs.done = [](grpc::ClientUnaryReactor* r, const grpc::Status&, const routeguide::Feature&) {
+    RpcReactor::TriggerEvent(kTestOnDone, r);
+  };
+  reactor = std::make_unique<Reactor>(*stub_, CreateClientContext(), rg_utils::MakePoint(1, 2), std::move(cbs));
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done) {
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL() << "Timeout waiting for RPC completion";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  EXPECT_TRUE(received_status.ok()) << "Status: " << received_status.error_message();
+  EXPECT_EQ(received_feature.name(), expected_feature.name());
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
+  routeguide::reactor_metrics::Install(true);  // before the first reactor
   // Register global environment to manage EventLoop lifecycle (start once, stop once)
   ::testing::AddGlobalTestEnvironment(new EventLoopEnvironment());
   return RUN_ALL_TESTS();
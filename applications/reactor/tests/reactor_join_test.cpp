@@ -0,0 +1,173 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Completion Combinator Tests
+///
+/// Tests the joins of reactor_join.h: a group of GetFeature RPCs triggers one application event, through the
+/// EventLoop, once all of them are done (WhenAll) or at the first success (WhenAny, cancelling the others).
+///
+/// The in-process server answers by the latitude of the requested point: a positive one is found, a negative one is
+/// not, and a zero one hangs until the client cancels it, like a slow shard.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <Event.h>
+#include <EventLoop.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rg_service/route_guide_service.h"
+#include "rg_service/rg_utils.h"
+#include "applications/reactor/reactor_client_routeguide.h"
+#include "applications/reactor/reactor_eventloop.h"
+#include "applications/reactor/reactor_join.h"
+#include "applications/reactor/tests/route_guide_test_fixture.h"
+
+namespace {
+
+using routeguide::GetFeature::ClientReactor;
+
+/// Shard service: found, not found, or hanging until cancelled, by the latitude of the point.
+class ShardService final : public routeguide::RouteGuide::CallbackService {
+ public:
+  grpc::ServerUnaryReactor* GetFeature(grpc::CallbackServerContext* context, const routeguide::Point* point,
+                                       routeguide::Feature* feature) override {
+    class Hanging : public grpc::ServerUnaryReactor {
+     public:
+      explicit Hanging(std::atomic<int>& cancelled) : cancelled_(cancelled) {}
+      void OnCancel() override {
+        ++cancelled_;
+        Finish(grpc::Status::CANCELLED);
+      }
+      void OnDone() override { delete this; }
+
+     private:
+      std::atomic<int>& cancelled_;
+    };
+    if (point->latitude() == 0) return new Hanging(cancelled_);
+    auto* reactor = context->DefaultReactor();
+    if (point->latitude() < 0) {
+      reactor->Finish(grpc::Status(grpc::StatusCode::NOT_FOUND, "not on this shard"));
+    } else {
+      feature->set_name("Shard " + std::to_string(point->latitude()));
+      *feature->mutable_location() = *point;
+      reactor->Finish(grpc::Status::OK);
+    }
+    return reactor;
+  }
+
+  std::atomic<int> cancelled_{0};  ///< hanging RPCs cancelled by the client
+};
+
+class ReactorJoinTest : public RouteGuideTestFixtureBase<ShardService> {};
+
+/// @test The event of a WhenAll is triggered once, after the last RPC, and every response is read by its index.
+TEST_F(ReactorJoinTest, WhenAll_FoundOnEveryShard_TriggersOnceWithAllResponses) {
+  static constexpr auto kOnJoined = "TestWhenAllOnJoined";
+  RpcReactor::Client::WhenAll<ClientReactor> join(kOnJoined);
+  std::atomic<int> events{0};
+  std::vector<std::string> names;
+  RpcReactor::EventConnection on_joined(kOnJoined, [&](EventLoop::Event* event) {
+    auto* joined = static_cast<RpcReactor::Client::WhenAll<ClientReactor>*>(event->getData());
+    EXPECT_EQ(joined, &join);
+    for (size_t i = 0; i < joined->Size(); ++i) {
+      routeguide::Feature feature;
+      EXPECT_TRUE(joined->Reactor(i).Status().ok());
+      EXPECT_TRUE(joined->Reactor(i).GetResponse(feature));
+      names.push_back(feature.name());
+    }
+    ++events;
+  });
+
+  for (int shard = 1; shard <= 4; ++shard) {
+    EXPECT_EQ(join.Add(*stub_, CreateClientContext(), rg_utils::MakePoint(shard, 0)), static_cast<size_t>(shard - 1));
+  }
+  join.Seal();
+  ASSERT_TRUE(WaitFor(events, 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(events.load(), 1);
+  EXPECT_EQ(names, (std::vector<std::string>{"Shard 1", "Shard 2", "Shard 3", "Shard 4"}));
+}
+
+/// @test A failed RPC doesn't hold a WhenAll back: the event comes once all are done, with the status of each.
+TEST_F(ReactorJoinTest, WhenAll_NotFoundOnAShard_ReportsItsStatus) {
+  static constexpr auto kOnJoined = "TestWhenAllOnJoinedWithFailure";
+  RpcReactor::Client::WhenAll<ClientReactor> join(kOnJoined);
+  std::atomic<int> events{0};
+  std::vector<grpc::StatusCode> codes;
+  RpcReactor::EventConnection on_joined(kOnJoined, [&](EventLoop::Event*) {
+    for (size_t i = 0; i < join.Size(); ++i) codes.push_back(join.Reactor(i).Status().error_code());
+    ++events;
+  });
+
+  join.Add(*stub_, CreateClientContext(), rg_utils::MakePoint(1, 0));
+  join.Add(*stub_, CreateClientContext(), rg_utils::MakePoint(-1, 0));
+  join.Seal();
+  ASSERT_TRUE(WaitFor(events, 1));
+  EXPECT_EQ(codes, (std::vector<grpc::StatusCode>{grpc::StatusCode::OK, grpc::StatusCode::NOT_FOUND}));
+}
+
+/// @test The first success completes a WhenAny: the event names the winner, whose response is read, and the
+/// hanging RPCs of the other shards are cancelled.
+TEST_F(ReactorJoinTest, WhenAny_FirstFound_CancelsTheOthers) {
+  static constexpr auto kOnJoined = "TestWhenAnyOnJoined";
+  auto join = std::make_unique<RpcReactor::Client::WhenAny<ClientReactor>>(kOnJoined);
+  std::atomic<int> events{0};
+  std::optional<size_t> winner;
+  routeguide::Feature feature;
+  RpcReactor::EventConnection on_joined(kOnJoined, [&](EventLoop::Event*) {
+    winner = join->Winner();
+    if (winner) join->Reactor(*winner).GetResponse(feature);
+    ++events;
+  });
+
+  join->Add(*stub_, CreateClientContext(), rg_utils::MakePoint(0, 0));
+  join->Add(*stub_, CreateClientContext(), rg_utils::MakePoint(7, 0));
+  join->Add(*stub_, CreateClientContext(), rg_utils::MakePoint(0, 0));
+  join->Seal();
+  ASSERT_TRUE(WaitFor(events, 1));
+  ASSERT_TRUE(winner.has_value());
+  EXPECT_EQ(*winner, 1u);
+  EXPECT_EQ(feature.name(), "Shard 7");
+  EXPECT_TRUE(WaitFor(test_service_.cancelled_, 2));
+  // Waits for the cancelled RPCs to be done.
+  join.reset();
+  EXPECT_EQ(events.load(), 1);
+}
+
+/// @test Without any success, a WhenAny completes once all its RPCs are done, without a winner.
+TEST_F(ReactorJoinTest, WhenAny_NotFoundAnywhere_TriggersWithoutWinner) {
+  static constexpr auto kOnJoined = "TestWhenAnyOnJoinedWithoutWinner";
+  RpcReactor::Client::WhenAny<ClientReactor> join(kOnJoined);
+  std::atomic<int> events{0};
+  bool has_winner = true;
+  RpcReactor::EventConnection on_joined(kOnJoined, [&](EventLoop::Event*) {
+    has_winner = join.Winner().has_value();
+    ++events;
+  });
+
+  join.Add(*stub_, CreateClientContext(), rg_utils::MakePoint(-1, 0));
+  join.Add(*stub_, CreateClientContext(), rg_utils::MakePoint(-2, 0));
+  join.Seal();
+  ASSERT_TRUE(WaitFor(events, 1));
+  EXPECT_FALSE(has_winner);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  // Register global environment to manage EventLoop lifecycle (start once, stop once)
+  ::testing::AddGlobalTestEnvironment(new EventLoopEnvironment());
+  return RUN_ALL_TESTS();
+}
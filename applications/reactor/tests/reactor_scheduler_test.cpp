@@ -0,0 +1,184 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Busy-poll Scheduler Tests
+///
+/// Tests the reactor scheduler of reactor_scheduler.h: once enabled, the events of RpcReactor::TriggerEvent()
+/// skip the EventLoop library and are dispatched to their EventConnection on the thread running
+/// RpcReactor::Scheduler::Run(), which waits for them by spinning, yielding, then parking on a futex.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <Event.h>
+#include <EventLoop.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "applications/reactor/reactor_eventloop.h"
+#include "applications/reactor/reactor_scheduler.h"
+#include "applications/reactor/tests/route_guide_test_fixture.h"
+
+namespace {
+
+using RpcReactor::Scheduler::WakeupPhase;
+
+constexpr auto kEvent = "SchedulerTestEvent";
+
+/// Runs the scheduler on its own thread, the application thread of the tests.
+class ReactorSchedulerTest : public ::testing::Test {
+ protected:
+  void TearDown() override { Stop(); }
+
+  void Start(const RpcReactor::SchedulerOptions& options) {
+    RpcReactor::Scheduler::Enable(options);
+    application_ = std::thread([this] {
+      application_id_ = std::this_thread::get_id();
+      for (size_t phase = 0; phase < wakeups_start_.size(); ++phase) {
+        wakeups_start_[phase] = RpcReactor::Scheduler::Wakeups(static_cast<WakeupPhase>(phase));
+      }
+      started_ = true;
+      RpcReactor::Scheduler::Run();
+      for (size_t phase = 0; phase < wakeups_.size(); ++phase) {
+        wakeups_[phase] = RpcReactor::Scheduler::Wakeups(static_cast<WakeupPhase>(phase)) - wakeups_start_[phase];
+      }
+    });
+    while (!started_) std::this_thread::yield();
+  }
+
+  void Stop() {
+    if (!application_.joinable()) return;
+    RpcReactor::Scheduler::Halt();
+    application_.join();
+  }
+
+  /// @return wakeups in a phase during the run, once stopped
+  uint64_t Wakeups(const WakeupPhase phase) const { return wakeups_[static_cast<size_t>(phase)]; }
+
+  std::thread application_;
+  std::atomic<std::thread::id> application_id_;
+  std::atomic_bool started_{false};
+  std::array<uint64_t, static_cast<size_t>(WakeupPhase::kQty)> wakeups_start_{};
+  std::array<uint64_t, static_cast<size_t>(WakeupPhase::kQty)> wakeups_{};
+};
+
+/// @test Events triggered by several threads are all dispatched on the scheduler thread, each in the order of its
+/// producer, and the queue depth of the scheduling path is back to zero.
+TEST_F(ReactorSchedulerTest, Dispatch_ProducerThreads_OrderedOnSchedulerThread) {
+  constexpr int kProducers = 4;
+  constexpr int kEvents = 2000;
+  std::vector<std::vector<intptr_t>> received(kProducers);
+  std::atomic<int> count{0};
+  std::atomic<int> wrong_thread{0};
+  RpcReactor::EventConnection connection(kEvent, [&](EventLoop::Event* event) {
+    if (std::this_thread::get_id() != application_id_.load()) ++wrong_thread;
+    const auto value = reinterpret_cast<intptr_t>(event->getData());
+    received[value / kEvents].push_back(value % kEvents);
+    ++count;
+  });
+  Start({std::chrono::microseconds(20), std::chrono::microseconds(20)});
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kProducers; ++producer) {
+    producers.emplace_back([producer] {
+      for (int i = 0; i < kEvents; ++i) {
+        RpcReactor::TriggerEvent(kEvent, reinterpret_cast<void*>(intptr_t{producer} * kEvents + i));
+      }
+    });
+  }
+  for (auto& producer : producers) producer.join();
+  ASSERT_TRUE(WaitFor(count, kProducers * kEvents));
+  Stop();
+
+  EXPECT_EQ(wrong_thread.load(), 0);
+  for (const auto& values : received) {
+    ASSERT_EQ(values.size(), static_cast<size_t>(kEvents));
+    for (int i = 0; i < kEvents; ++i) EXPECT_EQ(values[i], i);
+  }
+  EXPECT_EQ(RpcReactor::Overload::QueueDepth(), 0);
+}
+
+/// @test Events triggered by a handler, on the scheduler thread, past the capacity of the queue are kept in its
+/// overflow instead of waiting for the scheduler itself, and dispatched after the queue, in their order.
+TEST_F(ReactorSchedulerTest, Dispatch_FromHandlerPastCapacity_OrderedThroughOverflow) {
+  constexpr auto kChained = "SchedulerTestChained";
+  constexpr int kEvents = static_cast<int>(RpcReactor::Scheduler::internal::EventQueue::kCapacity) + 1000;
+  std::vector<intptr_t> received;
+  std::atomic<int> count{0};
+  RpcReactor::EventConnection chained(kChained, [&](EventLoop::Event* event) {
+    received.push_back(reinterpret_cast<intptr_t>(event->getData()));
+    ++count;
+  });
+  RpcReactor::EventConnection connection(kEvent, [](EventLoop::Event*) {
+    for (intptr_t i = 0; i < kEvents; ++i) RpcReactor::TriggerEvent(kChained, reinterpret_cast<void*>(i));
+  });
+  Start({});
+  RpcReactor::TriggerEvent(kEvent, nullptr);
+  ASSERT_TRUE(WaitFor(count, kEvents));
+  Stop();
+
+  ASSERT_EQ(received.size(), static_cast<size_t>(kEvents));
+  for (int i = 0; i < kEvents; ++i) ASSERT_EQ(received[i], i);
+  EXPECT_EQ(RpcReactor::Overload::QueueDepth(), 0);
+}
+
+/// @test Without spin nor yield, the scheduler parks right away, and an event wakes it up from the futex.
+TEST_F(ReactorSchedulerTest, Wait_NoSpin_WokenUpFromPark) {
+  std::atomic<int> count{0};
+  RpcReactor::EventConnection connection(kEvent, [&count](EventLoop::Event*) { ++count; });
+  Start({});
+  for (int i = 1; i <= 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    RpcReactor::TriggerEvent(kEvent, nullptr);
+    ASSERT_TRUE(WaitFor(count, i));
+  }
+  Stop();
+
+  EXPECT_EQ(Wakeups(WakeupPhase::kSpin), 0u);
+  EXPECT_EQ(Wakeups(WakeupPhase::kYield), 0u);
+  EXPECT_GE(Wakeups(WakeupPhase::kPark), 3u);
+}
+
+/// @test An event triggered within the spin time is picked up by the spinning scheduler, without parking.
+TEST_F(ReactorSchedulerTest, Wait_WithinSpin_WokenUpBySpin) {
+  std::atomic<int> count{0};
+  RpcReactor::EventConnection connection(kEvent, [&count](EventLoop::Event*) { ++count; });
+  Start({std::chrono::seconds(10), std::chrono::nanoseconds(0)});
+  for (int i = 1; i <= 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    RpcReactor::TriggerEvent(kEvent, nullptr);
+    ASSERT_TRUE(WaitFor(count, i));
+  }
+  Stop();
+
+  // Halt() wakes it up once more.
+  EXPECT_GE(Wakeups(WakeupPhase::kSpin), 3u);
+  EXPECT_EQ(Wakeups(WakeupPhase::kPark), 0u);
+}
+
+/// @test Halt() from another thread ends Run() while it is parked, and the scheduler runs again afterwards.
+TEST_F(ReactorSchedulerTest, Halt_WhileParked_RunReturns) {
+  Start({});
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const auto start = std::chrono::steady_clock::now();
+  Stop();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+  std::atomic<int> count{0};
+  RpcReactor::EventConnection connection(kEvent, [&count](EventLoop::Event*) { ++count; });
+  started_ = false;
+  Start({});
+  RpcReactor::TriggerEvent(kEvent, nullptr);
+  EXPECT_TRUE(WaitFor(count, 1));
+  Stop();
+}
+
+}  // namespace
@@ -0,0 +1,432 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Multiplexed Session Tests
+///
+/// Tests the SessionMux of reactor_session.h: logical sessions over one RouteChat stream, their responses dispatched
+/// by session id through the EventLoop, and their close acknowledged while the stream goes on.
+///
+/// The in-process server echoes every note on its session, the empty ones too, which acknowledges the close of a
+/// session, and answers the message "stray" on session 999, which the client never opened. The sessions are also
+/// run against the sync and callback servers of the repository, started as child processes.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <Event.h>
+#include <EventLoop.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rg_service/route_guide_service.h"
+#include "applications/reactor/reactor_client_routeguide.h"
+#include "applications/reactor/reactor_eventloop.h"
+#include "applications/reactor/reactor_overload.h"
+#include "applications/reactor/reactor_session.h"
+#include "applications/reactor/tests/route_guide_test_fixture.h"
+
+namespace {
+
+using Mux = RpcReactor::Client::SessionMux<routeguide::RouteChat::ClientReactor>;
+
+/// Echo service: every note back on its session, one at a time.
+class EchoService final : public routeguide::RouteGuide::CallbackService {
+ public:
+  grpc::ServerBidiReactor<routeguide::RouteNote, routeguide::RouteNote>* RouteChat(
+      grpc::CallbackServerContext*) override {
+    class Echo : public grpc::ServerBidiReactor<routeguide::RouteNote, routeguide::RouteNote> {
+     public:
+      Echo() { StartRead(&note_); }
+
+      void OnReadDone(bool ok) override {
+        if (!ok) {
+          Finish(grpc::Status::OK);
+          return;
+        }
+        if (note_.message() == "stray") note_.set_session_id(999);
+        StartWrite(&note_);
+      }
+
+      void OnWriteDone(bool ok) override {
+        if (!ok) {
+          Finish(grpc::Status(grpc::StatusCode::INTERNAL, "Write failed"));
+          return;
+        }
+        StartRead(&note_);
+      }
+
+      void OnDone() override { delete this; }
+
+     private:
+      routeguide::RouteNote note_;
+    };
+    return new Echo();
+  }
+};
+
+class ReactorSessionTest : public RouteGuideTestFixtureBase<EchoService> {
+ protected:
+  /// Runs a function on the application thread, the thread of the mux, and waits for it.
+  static void RunOnLoop(const std::function<void()>& function) {
+    static constexpr auto kRun = "TestSessionRun";
+    std::promise<void> ran;
+    RpcReactor::EventConnection on_run(kRun, [&](EventLoop::Event*) {
+      function();
+      ran.set_value();
+    });
+    RpcReactor::TriggerEvent(kRun, nullptr);
+    ran.get_future().wait();
+  }
+
+  static routeguide::RouteNote MakeNote(const std::string& message) {
+    routeguide::RouteNote note;
+    note.set_message(message);
+    return note;
+  }
+
+  /// Ends the stream and waits for the mux to be done, so it can be destroyed.
+  void Finish(Mux& mux) {
+    RunOnLoop([&] { mux.CloseStream(); });
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    bool done = false;
+    while (!done && std::chrono::steady_clock::now() < deadline) {
+      RunOnLoop([&] { done = mux.Done(); });
+      if (!done) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(done);
+  }
+
+  /// Callbacks of a session recording its messages and its close.
+  Mux::SessionCallbacks Record(std::map<uint64_t, std::vector<std::string>>& messages,
+                               std::map<uint64_t, grpc::StatusCode>& closed, std::atomic<int>& reads,
+                               std::atomic<int>& closes) {
+    return {.read =
+                [&](uint64_t id, routeguide::RouteNote& note) {
+                  EXPECT_EQ(note.session_id(), id);
+                  messages[id].push_back(note.message());
+                  ++reads;
+                },
+            .closed =
+                [&](uint64_t id, const grpc::Status& status) {
+                  closed[id] = status.error_code();
+                  ++closes;
+                }};
+  }
+};
+
+/// @test The notes of interleaved sessions come back to the callbacks of their own session, in their order.
+TEST_F(ReactorSessionTest, RouteChat_InterleavedSessions_DispatchesBySession) {
+  Mux mux("TestSessionDemux", *stub_, CreateClientContext());
+  std::map<uint64_t, std::vector<std::string>> messages;
+  std::map<uint64_t, grpc::StatusCode> closed;
+  std::atomic<int> reads{0};
+  std::atomic<int> closes{0};
+
+  RunOnLoop([&] {
+    EXPECT_TRUE(mux.Open(1, Record(messages, closed, reads, closes)));
+    EXPECT_TRUE(mux.Open(2, Record(messages, closed, reads, closes)));
+    EXPECT_FALSE(mux.Open(2, {}));
+    EXPECT_FALSE(mux.Open(0, {}));
+    EXPECT_FALSE(mux.Send(3, MakeNote("unknown")));
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(mux.Send(1, MakeNote("a" + std::to_string(i))));
+      EXPECT_TRUE(mux.Send(2, MakeNote("b" + std::to_string(i))));
+    }
+  });
+  ASSERT_TRUE(WaitFor(reads, 6));
+  RunOnLoop([&] {
+    EXPECT_EQ(messages[1], (std::vector<std::string>{"a0", "a1", "a2"}));
+    EXPECT_EQ(messages[2], (std::vector<std::string>{"b0", "b1", "b2"}));
+    EXPECT_EQ(mux.Sessions(), 2u);
+  });
+  Finish(mux);
+}
+
+/// @test A closed session is acknowledged with an OK status, and the other sessions go on over the same stream.
+TEST_F(ReactorSessionTest, RouteChat_CloseOneSession_KeepsTheOthers) {
+  Mux mux("TestSessionClose", *stub_, CreateClientContext());
+  std::map<uint64_t, std::vector<std::string>> messages;
+  std::map<uint64_t, grpc::StatusCode> closed;
+  std::atomic<int> reads{0};
+  std::atomic<int> closes{0};
+
+  RunOnLoop([&] {
+    mux.Open(1, Record(messages, closed, reads, closes));
+    mux.Open(2, Record(messages, closed, reads, closes));
+    mux.Send(1, MakeNote("a0"));
+    EXPECT_TRUE(mux.Close(1));
+    EXPECT_FALSE(mux.Send(1, MakeNote("a1")));
+  });
+  ASSERT_TRUE(WaitFor(closes, 1));
+  RunOnLoop([&] {
+    EXPECT_EQ(closed[1], grpc::StatusCode::OK);
+    EXPECT_EQ(mux.Sessions(), 1u);
+    EXPECT_TRUE(mux.Send(2, MakeNote("b0")));
+  });
+  ASSERT_TRUE(WaitFor(reads, 2));
+  RunOnLoop([&] {
+    EXPECT_EQ(messages[1], (std::vector<std::string>{"a0"}));
+    EXPECT_EQ(messages[2], (std::vector<std::string>{"b0"}));
+  });
+  Finish(mux);
+}
+
+/// @test A response of a session never opened is dropped and counted, without disturbing the open sessions.
+TEST_F(ReactorSessionTest, RouteChat_UnknownSession_DropsResponse) {
+  Mux mux("TestSessionStray", *stub_, CreateClientContext());
+  std::map<uint64_t, std::vector<std::string>> messages;
+  std::map<uint64_t, grpc::StatusCode> closed;
+  std::atomic<int> reads{0};
+  std::atomic<int> closes{0};
+
+  RunOnLoop([&] {
+    mux.Open(1, Record(messages, closed, reads, closes));
+    mux.Send(1, MakeNote("stray"));
+    mux.Send(1, MakeNote("a0"));
+  });
+  ASSERT_TRUE(WaitFor(reads, 1));
+  RunOnLoop([&] {
+    EXPECT_EQ(mux.Dropped(), 1u);
+    EXPECT_EQ(messages[1], (std::vector<std::string>{"a0"}));
+  });
+  Finish(mux);
+}
+
+/// @test The end of the stream closes the sessions still open, with the status of the stream.
+TEST_F(ReactorSessionTest, RouteChat_StreamEnd_ClosesOpenSessions) {
+  Mux mux("TestSessionStreamEnd", *stub_, CreateClientContext());
+  std::map<uint64_t, std::vector<std::string>> messages;
+  std::map<uint64_t, grpc::StatusCode> closed;
+  std::atomic<int> reads{0};
+  std::atomic<int> closes{0};
+
+  RunOnLoop([&] {
+    mux.Open(1, Record(messages, closed, reads, closes));
+    mux.Open(2, Record(messages, closed, reads, closes));
+    mux.TryCancel();
+  });
+  ASSERT_TRUE(WaitFor(closes, 2));
+  RunOnLoop([&] {
+    EXPECT_TRUE(mux.Done());
+    EXPECT_EQ(mux.Status().error_code(), grpc::StatusCode::CANCELLED);
+    EXPECT_EQ(closed[1], grpc::StatusCode::CANCELLED);
+    EXPECT_EQ(closed[2], grpc::StatusCode::CANCELLED);
+    EXPECT_EQ(mux.Sessions(), 0u);
+    EXPECT_FALSE(mux.Open(3, {}));
+  });
+}
+
+/// @test With `pause_reads`, the stream stops reading while overloaded: the next note of a session only comes once
+/// the signal cleared and the mux resumed its reads.
+TEST_F(ReactorSessionTest, RouteChat_OverloadPauseReads_ResumedByMux) {
+  Mux mux("TestSessionPause", *stub_, CreateClientContext());
+  std::map<uint64_t, std::vector<std::string>> messages;
+  std::map<uint64_t, grpc::StatusCode> closed;
+  std::atomic<int> reads{0};
+  std::atomic<int> closes{0};
+
+  RpcReactor::OverloadOptions options;
+  options.max_queue_depth = 1;
+  options.pause_reads = true;
+  RpcReactor::Overload::Configure(options);
+  // Two events triggered and not dispatched keep the queue depth above its threshold.
+  RpcReactor::Overload::OnTrigger();
+  RpcReactor::Overload::OnTrigger();
+  ASSERT_TRUE(RpcReactor::Overload::PauseReads());
+
+  RunOnLoop([&] {
+    EXPECT_FALSE(mux.ResumeReads());
+    mux.Open(1, Record(messages, closed, reads, closes));
+    mux.Send(1, MakeNote("a0"));
+    mux.Send(1, MakeNote("a1"));
+  });
+  ASSERT_TRUE(WaitFor(reads, 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(reads.load(), 1);
+
+  RunOnLoop([&] {
+    // Dispatches the two pending events, which clears the signal.
+    RpcReactor::Overload::OnDispatch(std::chrono::steady_clock::now());
+    RpcReactor::Overload::OnDispatch(std::chrono::steady_clock::now());
+    EXPECT_FALSE(RpcReactor::Overload::PauseReads());
+    EXPECT_TRUE(mux.ResumeReads());
+  });
+  ASSERT_TRUE(WaitFor(reads, 2));
+  RpcReactor::Overload::Configure({});
+  RunOnLoop([&] { EXPECT_EQ(messages[1], (std::vector<std::string>{"a0", "a1"})); });
+  Finish(mux);
+}
+
+/// Runs a server application of the repository in a child process, listening on a Unix socket of its own, to test
+/// its RouteChat sessions through the mux.
+class ReactorSessionServerTest : public ReactorSessionTest {
+ protected:
+  void TearDown() override {
+    if (pid_ > 0) {
+      ::kill(pid_, SIGTERM);
+      ::waitpid(pid_, nullptr, 0);
+    }
+    if (!server_socket_.empty()) std::remove(server_socket_.c_str());
+    ReactorSessionTest::TearDown();
+  }
+
+  /// Starts the server, its output discarded, and connects server_stub_ to it.
+  /// @param binary path of the server
+  /// @param flags of the server, but its address
+  void StartServer(const char* binary, std::vector<std::string> flags) {
+    static int instance = 0;
+    server_socket_ = ::testing::TempDir() + "route_guide_session_" + std::to_string(::getpid()) + "_" +
+                     std::to_string(instance++) + ".sock";
+    flags.insert(flags.begin(), binary);
+    flags.push_back("--address=unix:" + server_socket_);
+    std::vector<char*> argv;
+    for (auto& flag : flags) argv.push_back(flag.data());
+    argv.push_back(nullptr);
+    posix_spawn_file_actions_t actions;
+    ::posix_spawn_file_actions_init(&actions);
+    ::posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    ::posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+    const int spawned = ::posix_spawn(&pid_, binary, &actions, nullptr, argv.data(), environ);
+    ::posix_spawn_file_actions_destroy(&actions);
+    ASSERT_EQ(spawned, 0) << binary;
+    const auto channel = grpc::CreateChannel("unix:" + server_socket_, grpc::InsecureChannelCredentials());
+    ASSERT_TRUE(channel->WaitForConnected(std::chrono::system_clock::now() + std::chrono::seconds(10))) << binary;
+    server_stub_ = routeguide::RouteGuide::NewStub(channel);
+  }
+
+  static routeguide::RouteNote MakeNoteAt(const std::string& message, const int32_t latitude,
+                                          const int32_t longitude) {
+    auto note = MakeNote(message);
+    note.mutable_location()->set_latitude(latitude);
+    note.mutable_location()->set_longitude(longitude);
+    return note;
+  }
+
+  /// Two sessions of one stream: the notes stored at a location come back in the session of the new note there,
+  /// and a closed session is acknowledged while the other one goes on.
+  void ExpectSessionsAnswered() {
+    Mux mux("TestSessionServer", *server_stub_, CreateClientContext());
+    std::map<uint64_t, std::vector<std::string>> messages;
+    std::map<uint64_t, grpc::StatusCode> closed;
+    std::atomic<int> reads{0};
+    std::atomic<int> closes{0};
+
+    RunOnLoop([&] {
+      mux.Open(1, Record(messages, closed, reads, closes));
+      mux.Open(2, Record(messages, closed, reads, closes));
+      mux.Send(1, MakeNoteAt("a", 10, 20));
+      mux.Send(2, MakeNoteAt("b", 10, 20));
+      EXPECT_TRUE(mux.Close(1));
+      mux.Send(2, MakeNoteAt("c", 10, 20));
+    });
+    ASSERT_TRUE(WaitFor(closes, 1));
+    ASSERT_TRUE(WaitFor(reads, 3));
+    RunOnLoop([&] {
+      EXPECT_EQ(closed[1], grpc::StatusCode::OK);
+      EXPECT_TRUE(messages[1].empty());
+      EXPECT_EQ(messages[2], (std::vector<std::string>{"a", "a", "b"}));
+      EXPECT_EQ(mux.Sessions(), 1u);
+    });
+    Finish(mux);
+  }
+
+  pid_t pid_ = 0;
+  std::string server_socket_;
+  std::unique_ptr<routeguide::RouteGuide::Stub> server_stub_;
+};
+
+/// @test The sync server answers a note in its session, and acknowledges the close of a session alone.
+TEST_F(ReactorSessionServerTest, SyncServer_TwoSessions_AnsweredAndClosedApart) {
+  ASSERT_NO_FATAL_FAILURE(StartServer(RG_SYNC_SERVER, {}));
+  ExpectSessionsAnswered();
+}
+
+/// @test The callback server, in its echo mode, answers a note in its session, and acknowledges the close of a
+/// session alone.
+TEST_F(ReactorSessionServerTest, CallbackServer_TwoSessions_AnsweredAndClosedApart) {
+  ASSERT_NO_FATAL_FAILURE(StartServer(RG_CALLBACK_SERVER, {}));
+  ExpectSessionsAnswered();
+}
+
+/// @test With --chat_push, a note is pushed to the other sessions near it, on its stream and the others, each in
+/// its own session, a session gets the stored notes of a location on its first note there, and a closed session
+/// gets nothing more.
+TEST_F(ReactorSessionServerTest, CallbackServerPush_SessionsOfTwoStreams_PushedPerSession) {
+  ASSERT_NO_FATAL_FAILURE(StartServer(RG_CALLBACK_SERVER, {"--chat_push"}));
+  Mux first("TestSessionPushFirst", *server_stub_, CreateClientContext());
+  Mux second("TestSessionPushSecond", *server_stub_, CreateClientContext());
+  std::map<uint64_t, std::vector<std::string>> first_messages;
+  std::map<uint64_t, std::vector<std::string>> second_messages;
+  std::map<uint64_t, grpc::StatusCode> closed;
+  std::atomic<int> first_reads{0};
+  std::atomic<int> second_reads{0};
+  std::atomic<int> closes{0};
+
+  // Whichever note the server gets first, each session gets the other one, stored or pushed.
+  RunOnLoop([&] {
+    first.Open(1, Record(first_messages, closed, first_reads, closes));
+    second.Open(1, Record(second_messages, closed, second_reads, closes));
+    first.Send(1, MakeNoteAt("first 1", 10, 20));
+    second.Send(1, MakeNoteAt("second 1", 10, 20));
+  });
+  ASSERT_TRUE(WaitFor(first_reads, 1));
+  ASSERT_TRUE(WaitFor(second_reads, 1));
+
+  RunOnLoop([&] {
+    first.Open(2, Record(first_messages, closed, first_reads, closes));
+    first.Send(2, MakeNoteAt("first 2", 10, 20));
+  });
+  ASSERT_TRUE(WaitFor(first_reads, 4));
+  ASSERT_TRUE(WaitFor(second_reads, 2));
+  RunOnLoop([&] {
+    EXPECT_EQ(first_messages[1], (std::vector<std::string>{"second 1", "first 2"}));
+    EXPECT_EQ(second_messages[1], (std::vector<std::string>{"first 1", "first 2"}));
+    ASSERT_EQ(first_messages[2].size(), 2u);
+    EXPECT_EQ(std::set<std::string>(first_messages[2].begin(), first_messages[2].end()),
+              (std::set<std::string>{"first 1", "second 1"}));
+    EXPECT_TRUE(first.Close(1));
+  });
+  ASSERT_TRUE(WaitFor(closes, 1));
+
+  RunOnLoop([&] { second.Send(1, MakeNoteAt("second 2", 10, 20)); });
+  ASSERT_TRUE(WaitFor(first_reads, 5));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  RunOnLoop([&] {
+    EXPECT_EQ(closed[1], grpc::StatusCode::OK);
+    EXPECT_EQ(first_messages[1].size(), 2u);
+    EXPECT_EQ(first_messages[2].back(), "second 2");
+    EXPECT_EQ(second_messages[1].size(), 2u);
+  });
+  Finish(first);
+  Finish(second);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  // Register global environment to manage EventLoop lifecycle (start once, stop once)
+  ::testing::AddGlobalTestEnvironment(new EventLoopEnvironment());
+  return RUN_ALL_TESTS();
+}
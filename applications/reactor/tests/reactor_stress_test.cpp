@@ -0,0 +1,581 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Reactor Stress Test
+///
+/// Drives thousands of concurrent reactors of the four kinds against an in-process server, through the
+/// production dispatch path (RpcReactor::TriggerEvent() to the EventLoop application thread). Every RPC
+/// draws a plan from a seeded random engine, carried to the server inside its first request:
+/// - the server finishes it with an error, late (slow unary), early (server-initiated finish of a client
+///   stream) or in the middle of its stream
+/// - the client cancels it after a random number of messages, and its servant is sometimes slow
+///
+/// Invariants checked throughout:
+/// - every reactor gets exactly one OnDone, and its status and message counts match its plan
+/// - the run keeps making progress (no lost OnDone), the resident memory stays bounded
+/// - once drained, the reactor gauges (in flight, holds) and the EventLoop queue are back to zero
+///
+/// The default run takes a few seconds under ctest. The soak mode runs for a given time instead:
+///
+///   reactor_stress_test --soak_seconds=3600 --stress_reactors=5000
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <gflags/gflags.h>
+#include <grpcpp/alarm.h>
+#include <unistd.h>
+
+#include <Event.h>
+#include <EventLoop.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+#include "rg_service/rg_random.h"
+#include "rg_service/route_guide_service.h"
+#include "applications/reactor/reactor_client_routeguide.h"
+#include "applications/reactor/reactor_metrics_routeguide.h"
+#include "applications/reactor/reactor_eventloop.h"
+#include "applications/reactor/tests/route_guide_test_fixture.h"
+
+DEFINE_uint32(stress_reactors, 1000, "Reactors in flight at any time");
+DEFINE_uint32(stress_rpcs, 10000, "RPCs of the default run, ignored by the soak mode");
+DEFINE_uint32(soak_seconds, 0, "When non-zero, keep the reactors in flight for that time instead of stress_rpcs RPCs");
+DEFINE_uint64(stress_seed, 1, "Seed of the RPC plans, the same seed gives the same plans");
+DEFINE_uint32(max_rss_growth_mb, 128, "Resident memory growth allowed after the first quarter of the run");
+
+namespace {
+
+constexpr auto kSpawn = "StressSpawn";
+constexpr auto kReadOk = "StressReadOk";
+constexpr auto kWriteDone = "StressWriteDone";
+constexpr auto kDone = "StressDone";
+
+const grpc::Status kUnaryError(grpc::StatusCode::INVALID_ARGUMENT, "planned unary error");
+const grpc::Status kMidStreamFailure(grpc::StatusCode::DATA_LOSS, "planned mid-stream failure");
+
+/// Server following the plan carried by the first request of every RPC:
+/// - GetFeature: Point{latitude: 1 for kUnaryError, longitude: microseconds before the finish}
+/// - ListFeatures: Rectangle{lo: {latitude: features, longitude: kMidStreamFailure after that many, or -1}}
+/// - RecordRoute: first Point{latitude: finish OK after that many points, or -1 to read them all}
+/// - RouteChat: echoes the notes, first RouteNote{location.latitude: kMidStreamFailure at that note, or -1}
+class StressRouteGuideService final : public routeguide::RouteGuide::CallbackService {
+ public:
+  grpc::ServerUnaryReactor* GetFeature(grpc::CallbackServerContext*, const routeguide::Point* point,
+                                       routeguide::Feature* feature) override {
+    class Reactor : public grpc::ServerUnaryReactor {
+     public:
+      Reactor(const grpc::Status& status, const std::chrono::microseconds delay) {
+        if (delay.count() == 0) {
+          Finish(status);
+          return;
+        }
+        alarm_.Set(std::chrono::system_clock::now() + delay, [this, status](bool) { Finish(status); });
+      }
+      void OnDone() override { delete this; }
+
+     private:
+      grpc::Alarm alarm_;
+    };
+    feature->set_name("stress");
+    return new Reactor(point->latitude() == 1 ? kUnaryError : grpc::Status::OK,
+                       std::chrono::microseconds(point->longitude()));
+  }
+
+  grpc::ServerWriteReactor<routeguide::Feature>* ListFeatures(grpc::CallbackServerContext*,
+                                                              const routeguide::Rectangle* rectangle) override {
+    class Reactor : public grpc::ServerWriteReactor<routeguide::Feature> {
+     public:
+      Reactor(const int count, const int fail_after) : count_(count), fail_after_(fail_after) { Next(); }
+      void OnWriteDone(const bool ok) override {
+        if (!ok) {
+          Finish(grpc::Status(grpc::StatusCode::UNKNOWN, "write failed"));
+          return;
+        }
+        Next();
+      }
+      void OnDone() override { delete this; }
+
+     private:
+      void Next() {
+        if (sent_ == fail_after_) {
+          Finish(kMidStreamFailure);
+        } else if (sent_ == count_) {
+          Finish(grpc::Status::OK);
+        } else {
+          feature_.set_name(std::to_string(sent_++));
+          StartWrite(&feature_);
+        }
+      }
+      const int count_;
+      const int fail_after_;
+      int sent_ = 0;
+      routeguide::Feature feature_;
+    };
+    return new Reactor(rectangle->lo().latitude(), rectangle->lo().longitude());
+  }
+
+  grpc::ServerReadReactor<routeguide::Point>* RecordRoute(grpc::CallbackServerContext*,
+                                                          routeguide::RouteSummary* summary) override {
+    class Reactor : public grpc::ServerReadReactor<routeguide::Point> {
+     public:
+      explicit Reactor(routeguide::RouteSummary* summary) : summary_(summary) { StartRead(&point_); }
+      void OnReadDone(const bool ok) override {
+        if (ok && count_ == 0) finish_after_ = point_.latitude();
+        if (ok) ++count_;
+        if (!ok || count_ == finish_after_) {
+          summary_->set_point_count(count_);
+          Finish(grpc::Status::OK);
+          return;
+        }
+        StartRead(&point_);
+      }
+      void OnDone() override { delete this; }
+
+     private:
+      routeguide::RouteSummary* summary_;
+      routeguide::Point point_;
+      int count_ = 0;
+      int finish_after_ = -1;
+    };
+    return new Reactor(summary);
+  }
+
+  grpc::ServerBidiReactor<routeguide::RouteNote, routeguide::RouteNote>* RouteChat(
+      grpc::CallbackServerContext*) override {
+    class Reactor : public grpc::ServerBidiReactor<routeguide::RouteNote, routeguide::RouteNote> {
+     public:
+      Reactor() { StartRead(&note_); }
+      void OnReadDone(const bool ok) override {
+        if (!ok) {
+          Finish(grpc::Status::OK);
+          return;
+        }
+        if (count_ == 0) fail_at_ = note_.location().latitude();
+        if (++count_ == fail_at_) {
+          Finish(kMidStreamFailure);
+          return;
+        }
+        StartWrite(&note_);
+      }
+      void OnWriteDone(const bool ok) override {
+        if (!ok) {
+          Finish(grpc::Status(grpc::StatusCode::UNKNOWN, "write failed"));
+          return;
+        }
+        StartRead(&note_);
+      }
+      void OnDone() override { delete this; }
+
+     private:
+      routeguide::RouteNote note_;
+      int count_ = 0;
+      int fail_at_ = -1;
+    };
+    return new Reactor();
+  }
+};
+
+enum class Kind { kUnary, kRead, kWrite, kBidi, kQty };
+
+/// Plan of one RPC, drawn when it is spawned.
+struct Plan {
+  Kind kind = Kind::kUnary;
+  int messages = 0;  ///< features streamed by the server, or requests streamed by the client
+  int server_stop = -1;  ///< message at which the server finishes early or fails, -1 for none
+  bool unary_error = false;
+  std::chrono::microseconds unary_delay{0};
+  int cancel_at = -1;  ///< messages handled before the client cancels, -1 for none
+  bool send_last = false;  ///< close the client stream with SendLastRequest() instead of CloseRequestStream()
+};
+
+/// One RPC in flight, owned by the application thread from its spawn to its OnDone.
+struct Call {
+  Plan plan;
+  std::unique_ptr<routeguide::GetFeature::ClientReactor> unary;
+  std::unique_ptr<routeguide::ListFeatures::ClientReactor> read;
+  std::unique_ptr<routeguide::RecordRoute::ClientReactor> write;
+  std::unique_ptr<routeguide::RouteChat::ClientReactor> bidi;
+  std::atomic_bool write_ok{true};  ///< set by OnWriteDone(), one write in flight at a time
+  int sent = 0;
+  int received = 0;
+  bool cancelled = false;
+
+  void TryCancel() {
+    cancelled = true;
+    if (unary) unary->TryCancel();
+    if (read) read->TryCancel();
+    if (write) write->TryCancel();
+    if (bidi) bidi->TryCancel();
+  }
+};
+
+/// Client side of the stress test. Every handler runs on the EventLoop application thread, so the calls are only
+/// touched by one thread, as in the application.
+class StressDriver {
+ public:
+  explicit StressDriver(routeguide::RouteGuide::Stub& stub)
+      : stub_(stub),
+        engine_(FLAGS_stress_seed),
+        spawn_(kSpawn, [this](EventLoop::Event*) { Spawn(); }),
+        read_ok_(kReadOk, [this](EventLoop::Event* event) { OnReadOk(static_cast<Call*>(event->getData())); }),
+        write_done_(kWriteDone,
+                    [this](EventLoop::Event* event) { OnWriteDone(static_cast<Call*>(event->getData())); }),
+        done_(kDone, [this](EventLoop::Event* event) { OnDone(static_cast<Call*>(event->getData())); }) {}
+
+  /// Asks the application thread to spawn one more RPC. Any thread.
+  void RequestSpawn() {
+    spawned_.fetch_add(1, std::memory_order_relaxed);
+    RpcReactor::TriggerEvent(kSpawn, nullptr);
+  }
+
+  uint64_t spawned() const { return spawned_.load(std::memory_order_relaxed); }
+  uint64_t done() const { return done_count_.load(std::memory_order_relaxed); }
+  uint64_t failures() const { return failures_.load(std::memory_order_relaxed); }
+  uint64_t cancelled() const { return cancelled_count_.load(std::memory_order_relaxed); }
+
+ private:
+  Plan Draw() {
+    auto below = [this](const uint32_t bound) { return static_cast<int>(rg_random::UniformBelow(engine_, bound)); };
+    Plan plan;
+    plan.kind = static_cast<Kind>(below(static_cast<uint32_t>(Kind::kQty)));
+    plan.messages = 1 + below(8);
+    // A quarter of the streams stop early on the server side, a tenth of the RPCs are cancelled.
+    if (below(4) == 0) plan.server_stop = 1 + below(static_cast<uint32_t>(plan.messages));
+    plan.unary_error = below(4) == 0;
+    if (below(8) == 0) plan.unary_delay = std::chrono::microseconds(below(2000));
+    if (below(10) == 0) plan.cancel_at = below(static_cast<uint32_t>(plan.messages) + 1);
+    plan.send_last = below(2) == 0;
+    return plan;
+  }
+
+  // A few servants are slow, which also lets the EventLoop queue grow.
+  void MaybeSlowServant() {
+    if (rg_random::UniformBelow(engine_, 50) == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+
+  void Spawn() {
+    auto* call = new Call;
+    call->plan = Draw();
+    live_.insert(call);
+    const auto& plan = call->plan;
+    switch (plan.kind) {
+      case Kind::kUnary: {
+        routeguide::GetFeature::Callbacks cbs;
+        cbs.done = [call](grpc::ClientUnaryReactor*, const grpc::Status&, const routeguide::Feature&) {
+          RpcReactor::TriggerEvent(kDone, call);
+        };
+        routeguide::Point point;
+        point.set_latitude(plan.unary_error ? 1 : 0);
+        point.set_longitude(static_cast<int32_t>(plan.unary_delay.count()));
+        call->unary = std::make_unique<routeguide::GetFeature::ClientReactor>(
+            stub_, std::make_unique<grpc::ClientContext>(), point, std::move(cbs));
+        break;
+      }
+      case Kind::kRead: {
+        routeguide::ListFeatures::Callbacks cbs;
+        cbs.ok = [call](grpc::ClientReadReactor<routeguide::Feature>*, const routeguide::Feature&) {
+          RpcReactor::TriggerEvent(kReadOk, call);
+          return true;
+        };
+        cbs.done = [call](grpc::ClientReadReactor<routeguide::Feature>*, const grpc::Status&) {
+          RpcReactor::TriggerEvent(kDone, call);
+        };
+        routeguide::Rectangle rectangle;
+        rectangle.mutable_lo()->set_latitude(plan.messages);
+        rectangle.mutable_lo()->set_longitude(plan.server_stop);
+        call->read = std::make_unique<routeguide::ListFeatures::ClientReactor>(
+            stub_, std::make_unique<grpc::ClientContext>(), rectangle, std::move(cbs));
+        break;
+      }
+      case Kind::kWrite: {
+        routeguide::RecordRoute::Callbacks cbs;
+        cbs.write_done = [call](grpc::ClientWriteReactor<routeguide::Point>*, const bool ok) {
+          call->write_ok = ok;
+          RpcReactor::TriggerEvent(kWriteDone, call);
+        };
+        cbs.done = [call](grpc::ClientWriteReactor<routeguide::Point>*, const grpc::Status&,
+                          const routeguide::RouteSummary&) { RpcReactor::TriggerEvent(kDone, call); };
+        call->write = std::make_unique<routeguide::RecordRoute::ClientReactor>(
+            stub_, std::make_unique<grpc::ClientContext>(), std::move(cbs));
+        SendNext(*call);
+        break;
+      }
+      case Kind::kBidi: {
+        routeguide::RouteChat::Callbacks cbs;
+        cbs.read_ok = [call](grpc::ClientBidiReactor<routeguide::RouteNote, routeguide::RouteNote>*,
+                             const routeguide::RouteNote&) {
+          RpcReactor::TriggerEvent(kReadOk, call);
+          return true;
+        };
+        cbs.write_done = [call](grpc::ClientBidiReactor<routeguide::RouteNote, routeguide::RouteNote>*,
+                                const bool ok) {
+          call->write_ok = ok;
+          RpcReactor::TriggerEvent(kWriteDone, call);
+        };
+        cbs.done = [call](grpc::ClientBidiReactor<routeguide::RouteNote, routeguide::RouteNote>*,
+                          const grpc::Status&) { RpcReactor::TriggerEvent(kDone, call); };
+        call->bidi = std::make_unique<routeguide::RouteChat::ClientReactor>(
+            stub_, std::make_unique<grpc::ClientContext>(), std::move(cbs));
+        SendNext(*call);
+        break;
+      }
+      case Kind::kQty:
+        break;
+    }
+    if (plan.cancel_at == 0) call->TryCancel();
+  }
+
+  // Streams the next request of a client stream, then closes it after the last one.
+  void SendNext(Call& call) {
+    const auto& plan = call.plan;
+    if (call.sent == plan.messages) {
+      if (call.write) call.write->CloseRequestStream();
+      if (call.bidi) call.bidi->CloseRequestStream();
+      return;
+    }
+    const bool last = plan.send_last && call.sent + 1 == plan.messages;
+    // The first request carries the plan of the server.
+    const int stop = call.sent == 0 ? plan.server_stop : 0;
+    bool sent = false;
+    if (call.write) {
+      routeguide::Point point;
+      point.set_latitude(stop);
+      sent = last ? call.write->SendLastRequest(std::move(point)) : call.write->SendRequest(std::move(point));
+    } else if (call.bidi) {
+      routeguide::RouteNote note;
+      note.mutable_location()->set_latitude(stop);
+      note.set_message(std::to_string(call.sent));
+      sent = last ? call.bidi->SendLastRequest(std::move(note)) : call.bidi->SendRequest(std::move(note));
+    }
+    if (sent) ++call.sent;
+  }
+
+  void OnReadOk(Call* call) {
+    if (!Alive(call, kReadOk)) return;
+    MaybeSlowServant();
+    bool valid = false;
+    if (call->read) {
+      routeguide::Feature feature;
+      valid = call->read->GetResponse(feature);
+    } else if (call->bidi) {
+      routeguide::RouteNote note;
+      valid = call->bidi->GetResponse(note);
+    }
+    if (!valid) Fail(*call, "GetResponse() without a response");
+    ++call->received;
+    if (call->plan.kind == Kind::kRead && call->received == call->plan.cancel_at) call->TryCancel();
+  }
+
+  void OnWriteDone(Call* call) {
+    if (!Alive(call, kWriteDone)) return;
+    MaybeSlowServant();
+    if (call->sent == call->plan.cancel_at && !call->cancelled) call->TryCancel();
+    // A failed write means the RPC is over, OnDone follows.
+    if (call->write_ok && !call->cancelled) SendNext(*call);
+  }
+
+  void OnDone(Call* call) {
+    if (!Alive(call, kDone)) return;
+    live_.erase(call);
+    Check(*call);
+    if (call->cancelled) cancelled_count_.fetch_add(1, std::memory_order_relaxed);
+    delete call;
+    done_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  bool Alive(Call* call, const char* event) {
+    if (live_.contains(call)) return true;
+    ADD_FAILURE() << event << " for a call already done";
+    failures_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  void Fail(const Call& call, const std::string& what) {
+    // Capped, a systematic failure would otherwise print thousands of lines.
+    if (failures_.fetch_add(1, std::memory_order_relaxed) < 20) {
+      ADD_FAILURE() << what << " (kind " << static_cast<int>(call.plan.kind) << ", messages " << call.plan.messages
+                    << ", server stop " << call.plan.server_stop << ", cancel at " << call.plan.cancel_at
+                    << ", sent " << call.sent << ", received " << call.received << ")";
+    }
+  }
+
+  // Checks the outcome of a call against its plan. A cancelled call may also have completed before the cancel.
+  void Check(const Call& call) {
+    const auto& plan = call.plan;
+    grpc::Status status;
+    grpc::Status expected = grpc::Status::OK;
+    int expected_received = 0;
+    switch (plan.kind) {
+      case Kind::kUnary:
+        status = call.unary->Status();
+        if (plan.unary_error) expected = kUnaryError;
+        break;
+      case Kind::kRead:
+        status = call.read->Status();
+        expected_received = plan.server_stop >= 0 ? plan.server_stop : plan.messages;
+        if (plan.server_stop >= 0) expected = kMidStreamFailure;
+        break;
+      case Kind::kWrite: {
+        status = call.write->Status();
+        routeguide::RouteSummary summary;
+        if (status.ok() && call.write->GetResponse(summary)) {
+          const int expected_points = plan.server_stop >= 0 ? plan.server_stop : plan.messages;
+          if (summary.point_count() != expected_points) Fail(call, "RecordRoute point count mismatch");
+        }
+        break;
+      }
+      case Kind::kBidi:
+        status = call.bidi->Status();
+        expected_received = plan.server_stop >= 0 ? plan.server_stop - 1 : plan.messages;
+        if (plan.server_stop >= 0) expected = kMidStreamFailure;
+        break;
+      case Kind::kQty:
+        break;
+    }
+    const bool as_planned = status.error_code() == expected.error_code();
+    if (call.cancelled) {
+      if (!as_planned && status.error_code() != grpc::StatusCode::CANCELLED) {
+        Fail(call, "cancelled RPC ended with " + std::to_string(status.error_code()) + " " + status.error_message());
+      }
+      if (call.received > expected_received && plan.kind != Kind::kUnary && plan.kind != Kind::kWrite) {
+        Fail(call, "more responses than planned");
+      }
+      return;
+    }
+    if (!as_planned) {
+      Fail(call, "RPC ended with " + std::to_string(status.error_code()) + " " + status.error_message() +
+                     ", expected " + std::to_string(expected.error_code()));
+    } else if ((plan.kind == Kind::kRead || plan.kind == Kind::kBidi) && call.received != expected_received) {
+      Fail(call, "responses received " + std::to_string(call.received) + ", expected " +
+                     std::to_string(expected_received));
+    }
+  }
+
+  routeguide::RouteGuide::Stub& stub_;
+  rg_random::Xoshiro256pp engine_;  // Application thread only, like the calls.
+  std::unordered_set<Call*> live_;
+  std::atomic<uint64_t> spawned_{0};
+  std::atomic<uint64_t> done_count_{0};
+  std::atomic<uint64_t> failures_{0};
+  std::atomic<uint64_t> cancelled_count_{0};
+  RpcReactor::EventConnection spawn_;
+  RpcReactor::EventConnection read_ok_;
+  RpcReactor::EventConnection write_done_;
+  RpcReactor::EventConnection done_;
+};
+
+/// @return resident memory of the process, in bytes
+uint64_t ResidentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  statm >> size >> resident;
+  return resident * static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+}
+
+class ReactorStressTest : public RouteGuideTestFixtureBase<StressRouteGuideService> {};
+
+/// @test Keeps `--stress_reactors` reactors of the four kinds in flight, with randomized server failures,
+/// early finishes, slow servants and client cancellations, for `--stress_rpcs` RPCs or `--soak_seconds`.
+///
+/// Every second, the run must have made progress and its resident memory must stay within
+/// `--max_rss_growth_mb` of the one measured after its first quarter. Once every RPC is done, the
+/// reactor gauges and the EventLoop queue must be back to where they were.
+TEST_F(ReactorStressTest, AllKinds_RandomizedFaults_NoLeaks) {
+  const auto& metrics = routeguide::reactor_metrics::Get();
+  std::array<int64_t, static_cast<size_t>(RpcReactor::Metrics::ReactorType::kQty)> in_flight{};
+  for (size_t type = 0; type < in_flight.size(); ++type) {
+    in_flight[type] = metrics.InFlight(static_cast<RpcReactor::Metrics::ReactorType>(type)).Value();
+  }
+  const auto holds = metrics.holds->Value();
+
+  StressDriver driver(*stub_);
+  const bool soak = FLAGS_soak_seconds > 0;
+  const auto start = std::chrono::steady_clock::now();
+  const auto soak_end = start + std::chrono::seconds(FLAGS_soak_seconds);
+  auto keep_spawning = [&] {
+    return soak ? std::chrono::steady_clock::now() < soak_end : driver.spawned() < FLAGS_stress_rpcs;
+  };
+  auto warm = [&] {
+    return soak ? std::chrono::steady_clock::now() - start >= std::chrono::seconds(FLAGS_soak_seconds) / 4
+                : driver.done() >= FLAGS_stress_rpcs / 4;
+  };
+
+  uint64_t rss_warm = 0;
+  uint64_t last_done = 0;
+  auto last_progress = std::chrono::steady_clock::now();
+  auto next_report = last_progress + std::chrono::seconds(1);
+  // Stops spawning at the end of the run, then waits for every RPC to be done.
+  while (keep_spawning() || driver.done() < driver.spawned()) {
+    while (keep_spawning() && driver.spawned() - driver.done() < FLAGS_stress_reactors) {
+      driver.RequestSpawn();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (rss_warm == 0 && warm()) rss_warm = ResidentBytes();
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_report) continue;
+    next_report = now + std::chrono::seconds(1);
+    const auto done = driver.done();
+    if (done != last_done) {
+      last_done = done;
+      last_progress = now;
+    }
+    ASSERT_LT(now - last_progress, std::chrono::seconds(10))
+        << "No RPC done for 10s: " << driver.spawned() - done << " OnDone lost";
+    const auto rss = ResidentBytes();
+    if (rss_warm != 0) {
+      ASSERT_LT(rss, rss_warm + uint64_t{FLAGS_max_rss_growth_mb} * 1024 * 1024)
+          << "Resident memory grew from " << rss_warm / 1024 << " KiB";
+    }
+    if (soak) {
+      std::printf("[soak] %llus: %llu RPCs done, %llu in flight, %llu cancelled, queue %lld, rss %llu KiB\n",
+                  static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::seconds>(now - start)
+                                                      .count()),
+                  static_cast<unsigned long long>(done),
+                  static_cast<unsigned long long>(driver.spawned() - done),
+                  static_cast<unsigned long long>(driver.cancelled()),
+                  static_cast<long long>(RpcReactor::Overload::QueueDepth()),
+                  static_cast<unsigned long long>(rss / 1024));
+      std::fflush(stdout);
+    }
+  }
+
+  EXPECT_EQ(driver.failures(), 0u);
+  EXPECT_EQ(driver.done(), driver.spawned());
+  for (size_t type = 0; type < in_flight.size(); ++type) {
+    EXPECT_EQ(metrics.InFlight(static_cast<RpcReactor::Metrics::ReactorType>(type)).Value(), in_flight[type])
+        << "Reactors leaked, type " << type;
+  }
+  EXPECT_EQ(metrics.holds->Value(), holds);
+  // The last OnDone event is being dispatched when its handler counts it.
+  const auto drained = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (RpcReactor::Overload::QueueDepth() != 0 && std::chrono::steady_clock::now() < drained) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(RpcReactor::Overload::QueueDepth(), 0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  routeguide::reactor_metrics::Install(true);  // before the first reactor
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  // Register global environment to manage EventLoop lifecycle (start once, stop once)
+  ::testing::AddGlobalTestEnvironment(new EventLoopEnvironment());
+  return RUN_ALL_TESTS();
+}
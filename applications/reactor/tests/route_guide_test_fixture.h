@@ -14,29 +14,95 @@
 #include <grpcpp/server.h>
 #include <grpcpp/server_builder.h>
 
+#include <unistd.h>
+
+#include <EventLoop.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "rg_service/rg_interceptors.h"
 #include "rg_service/route_guide_service.h"
 
+/// Global test environment managing the EventLoop lifecycle of a test binary.
+/// EventLoop doesn't support restart after Halt(), so it is started once for all the tests:
+///
+///   ::testing::AddGlobalTestEnvironment(new EventLoopEnvironment());
+class EventLoopEnvironment : public ::testing::Environment {
+ public:
+  void SetUp() override {
+    EventLoop::SetMode(EventLoop::Mode::NON_BLOCK);
+    EventLoop::Run();
+  }
+
+  void TearDown() override { EventLoop::Halt(); }
+};
+
+/// Waits for a count updated by another thread, e.g. the application thread, to reach its expected value.
+/// @return true if the count is the expected one, false after 5 seconds
+inline bool WaitFor(const std::atomic<int>& count, const int expected) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (count.load() < expected && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return count.load() == expected;
+}
+
+/// Transport the in-process server of RouteGuideTestFixtureBase listens on.
+enum class FixtureTransport {
+  kTcp,   ///< TCP loopback on a dynamic port
+  kUnix,  ///< Unix domain socket in the test temporary directory, no port allocation
+};
+
 /// Base test fixture bringing up an in-process RouteGuide server on a dynamic port and a client
 /// stub connected to it. ServiceT is the fake routeguide::RouteGuide::CallbackService
 /// implementation the test registers; each RPC's test suite supplies its own, since each exercises
-/// a different RPC method.
-template <class ServiceT>
+/// a different RPC method. kTransport selects TCP loopback (default) or a Unix domain socket.
+/// A derived fixture sets server_faults_ and client_faults_ in its constructor to inject latency, errors and
+/// stalls (rg_interceptors::FaultPlan) into the server and the stub.
+template <class ServiceT, FixtureTransport kTransport = FixtureTransport::kTcp>
 class RouteGuideTestFixtureBase : public ::testing::Test {
  protected:
   void SetUp() override {
     grpc::ServerBuilder builder;
     builder.RegisterService(&test_service_);
-    int selected_port = 0;
-    builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(), &selected_port);
-    server_ = builder.BuildAndStart();
-    ASSERT_NE(server_, nullptr) << "Failed to start in-process server";
-    ASSERT_GT(selected_port, 0) << "Failed to get dynamic port";
-
-    std::string server_address = "localhost:" + std::to_string(selected_port);
-    channel_ = grpc::CreateChannel(server_address, grpc::InsecureChannelCredentials());
+    if (!server_faults_.Empty()) {
+      std::vector<std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>> interceptors;
+      interceptors.push_back(std::make_unique<rg_interceptors::FaultInterceptorFactory>(server_faults_));
+      builder.experimental().SetInterceptorCreators(std::move(interceptors));
+    }
+    if constexpr (kTransport == FixtureTransport::kUnix) {
+      // One socket file per fixture instance, so concurrent test processes never collide.
+      static std::atomic_uint instance_counter{0};
+      socket_path_ = ::testing::TempDir() + "route_guide_test_" + std::to_string(::getpid()) + "_" +
+                     std::to_string(instance_counter++) + ".sock";
+      server_address_ = "unix:" + socket_path_;
+      builder.AddListeningPort(server_address_, grpc::InsecureServerCredentials());
+      server_ = builder.BuildAndStart();
+      ASSERT_NE(server_, nullptr) << "Failed to start in-process server on " << server_address_;
+    } else {
+      int selected_port = 0;
+      builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(), &selected_port);
+      server_ = builder.BuildAndStart();
+      ASSERT_NE(server_, nullptr) << "Failed to start in-process server";
+      ASSERT_GT(selected_port, 0) << "Failed to get dynamic port";
+      server_address_ = "localhost:" + std::to_string(selected_port);
+    }
+
+    if (client_faults_.Empty()) {
+      channel_ = grpc::CreateChannel(server_address_, grpc::InsecureChannelCredentials());
+    } else {
+      std::vector<std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>> interceptors;
+      interceptors.push_back(std::make_unique<rg_interceptors::ClientFaultInterceptorFactory>(client_faults_));
+      channel_ = grpc::experimental::CreateCustomChannelWithInterceptors(
+          server_address_, grpc::InsecureChannelCredentials(), grpc::ChannelArguments(), std::move(interceptors));
+    }
     stub_ = routeguide::RouteGuide::NewStub(channel_);
   }
 
@@ -44,6 +110,9 @@ class RouteGuideTestFixtureBase : public ::testing::Test {
     if (server_) {
       server_->Shutdown();
     }
+    if (!socket_path_.empty()) {
+      std::remove(socket_path_.c_str());
+    }
   }
 
   std::unique_ptr<grpc::ClientContext> CreateClientContext() {
@@ -51,6 +120,10 @@ class RouteGuideTestFixtureBase : public ::testing::Test {
   }
 
   ServiceT test_service_;
+  rg_interceptors::FaultPlan server_faults_;  ///< Faults injected by the server, none by default
+  rg_interceptors::FaultPlan client_faults_;  ///< Faults injected by the stub, none by default
+  std::string server_address_;  ///< Address the client channel is created with
+  std::string socket_path_;     ///< Filesystem path of the Unix domain socket, empty with TCP
   std::unique_ptr<grpc::Server> server_;
   std::shared_ptr<grpc::Channel> channel_;
   std::unique_ptr<routeguide::RouteGuide::Stub> stub_;
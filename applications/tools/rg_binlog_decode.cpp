@@ -0,0 +1,39 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+/// Renders the binary log rings (rg_service/rg_binlog.h) as text, merged in time order:
+///
+///   rg_binlog_decode /tmp/binlog/route_guide_active_reactor_client.1234.*.binlog
+///
+
+#include <fmt/chrono.h>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "rg_service/rg_binlog.h"
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "Usage: {} <ring file>...\n", argv[0]);
+    return 2;
+  }
+  std::vector<rg_binlog::Record> records;
+  bool ok = true;
+  for (int i = 1; i < argc; ++i) {
+    ok &= rg_binlog::ReadRing(argv[i], records);
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.time_ns < rhs.time_ns; });
+  for (const auto& record : records) {
+    const auto seconds = static_cast<std::time_t>(record.time_ns / 1'000'000'000);
+    fmt::print("[{:%H:%M:%S}.{:06}][{}] {}\n", fmt::localtime(seconds), record.time_ns % 1'000'000'000 / 1000,
+               record.thread_id, record.text);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_affinity.h"
+
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace rg_affinity {
+
+namespace {
+bool ParseCpu(const std::string_view text, int& cpu) {
+  const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+  return ec == std::errc{} && end == text.data() + text.size() && cpu >= 0 && cpu < CPU_SETSIZE;
+}
+
+cpu_set_t ToCpuSet(const CpuSet& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const int cpu : cpus) CPU_SET(cpu, &set);
+  return set;
+}
+}  // anonymous namespace
+
+bool ParseCpuList(std::string_view text, CpuSet& cpus) {
+  cpus.clear();
+  const auto original = text;
+  // Every range is followed by a comma but the last one: "1," is an error, "" an empty set.
+  for (bool more = !text.empty(); more;) {
+    const auto comma = text.find(',');
+    const auto range = text.substr(0, comma);
+    more = comma != std::string_view::npos;
+    text = more ? text.substr(comma + 1) : std::string_view{};
+    const auto dash = range.find('-');
+    int first = 0;
+    int last = 0;
+    if (!ParseCpu(range.substr(0, dash), first) ||
+        !ParseCpu(dash == std::string_view::npos ? range : range.substr(dash + 1), last) || last < first) {
+      spdlog::error("Invalid CPU list: {}", original);
+      cpus.clear();
+      return false;
+    }
+    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+  }
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return true;
+}
+
+std::string ToString(const CpuSet& cpus) {
+  std::string text;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t last = i;
+    while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1) ++last;
+    if (!text.empty()) text += ',';
+    text += last == i ? fmt::format("{}", cpus[i]) : fmt::format("{}-{}", cpus[i], cpus[last]);
+    i = last + 1;
+  }
+  return text;
+}
+
+CpuSet AllowedCpus() {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CpuSet cpus;
+  if (::sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+pid_t ThreadId() {
+  return static_cast<pid_t>(::syscall(SYS_gettid));
+}
+
+bool PinThread(const pid_t tid, const CpuSet& cpus) {
+  const auto set = ToCpuSet(cpus);
+  return ::sched_setaffinity(tid, sizeof(set), &set) == 0;
+}
+
+bool ParsePreset(const std::string_view name, Preset& preset) {
+  if (name == "none") {
+    preset = Preset::kNone;
+  } else if (name == "isolated") {
+    preset = Preset::kIsolated;
+  } else if (name == "compact") {
+    preset = Preset::kCompact;
+  } else {
+    spdlog::error("Unknown placement preset: {}, expected none, isolated or compact", name);
+    return false;
+  }
+  return true;
+}
+
+PlacementOptions ApplyPreset(const Preset preset, const CpuSet& allowed, PlacementOptions options) {
+  if (preset == Preset::kNone || allowed.empty()) return options;
+  if (allowed.size() == 1) {
+    if (options.application.empty()) options.application = allowed;
+    if (options.others.empty()) options.others = allowed;
+    return options;
+  }
+  if (preset == Preset::kIsolated) {
+    if (options.application.empty()) options.application = {allowed.back()};
+    if (options.others.empty()) options.others.assign(allowed.begin(), allowed.end() - 1);
+  } else {
+    if (options.application.empty()) options.application = {allowed[0]};
+    if (options.others.empty()) options.others = {allowed[1]};
+  }
+  return options;
+}
+
+bool Placement::Start(const PlacementOptions& options) {
+  Stop();
+  // The kernel rejects a set without any CPU of the cpuset of the process.
+  const auto allowed = AllowedCpus();
+  for (const auto* cpus : {&options.application, &options.others}) {
+    if (!cpus->empty() && std::none_of(cpus->begin(), cpus->end(), [&allowed](const int cpu) {
+          return std::binary_search(allowed.begin(), allowed.end(), cpu);
+        })) {
+      spdlog::error("Placement: CPUs {} outside of the CPUs of the process {}", ToString(*cpus), ToString(allowed));
+      return false;
+    }
+  }
+  options_ = options;
+  application_tid_ = ThreadId();
+  // The CPUs the threads get by default: the ones of the process, inherited from the thread creating them.
+  initial_cpus_ = AllowedCpus();
+  if (!options_.application.empty() && !PinThread(application_tid_, options_.application)) {
+    spdlog::error("Placement: can't pin the application thread on CPUs {}: {}", ToString(options_.application),
+                  std::strerror(errno));
+    return false;
+  }
+  if (options_.others.empty()) return true;
+  Sweep();
+  spdlog::info("Placement: application thread on CPUs {}, other threads on CPUs {} ({} moved)",
+               options_.application.empty() ? "unchanged" : ToString(options_.application), ToString(options_.others),
+               pinned_.load());
+  if (options_.sweep_period.count() > 0) {
+    stopping_ = false;
+    thread_ = std::thread(&Placement::Run, this);
+  }
+  return true;
+}
+
+void Placement::Stop() {
+  {
+    std::lock_guard lock(mu_);
+    stopping_ = true;
+  }
+  stop_cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+size_t Placement::Sweep() {
+  if (options_.others.empty()) return 0;
+  const auto others = ToCpuSet(options_.others);
+  const auto initial = ToCpuSet(initial_cpus_);
+  const std::unique_ptr<DIR, int (*)(DIR*)> tasks(::opendir("/proc/self/task"), &::closedir);
+  if (!tasks) return 0;
+  size_t pinned = 0;
+  while (const auto* entry = ::readdir(tasks.get())) {
+    if (entry->d_name[0] == '.') continue;
+    const auto tid = static_cast<pid_t>(std::atoi(entry->d_name));
+    // The application thread stays where it is, placed or not.
+    if (tid == application_tid_) continue;
+    cpu_set_t current;
+    // A thread may exit in between. Only the threads on the default CPUs are moved: the pinned ones, by this
+    // placement or by their owner, and the ones inheriting the CPUs of the application thread are left alone.
+    if (::sched_getaffinity(tid, sizeof(current), &current) != 0 || !CPU_EQUAL(&current, &initial) ||
+        CPU_EQUAL(&current, &others)) {
+      continue;
+    }
+    if (::sched_setaffinity(tid, sizeof(others), &others) == 0) ++pinned;
+  }
+  pinned_.fetch_add(pinned, std::memory_order_relaxed);
+  return pinned;
+}
+
+void Placement::Run() {
+  PinThread(0, options_.others);
+  std::unique_lock lock(mu_);
+  while (!stop_cv_.wait_for(lock, options_.sweep_period, [this] { return stopping_; })) {
+    lock.unlock();
+    if (const auto pinned = Sweep(); pinned > 0) spdlog::debug("Placement: {} new threads pinned", pinned);
+    lock.lock();
+  }
+}
+
+}  // namespace rg_affinity
@@ -0,0 +1,112 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/************************
+ * Thread placement: CPU affinity of the application thread and of the other threads of the process
+ *
+ * The application thread, which runs the EventLoop scheduler in the reactor client, is pinned to its own CPUs. The
+ * other threads (gRPC's callback, executor and timer threads, the EventEngine, the metrics exporter) are pinned to
+ * theirs. gRPC has no API to place its threads, and it creates them on demand, so the placement sweeps the threads
+ * of the process (/proc/self/task) when it starts, then periodically.
+ ************************/
+namespace rg_affinity {
+
+/// CPU numbers, ascending, without duplicates.
+using CpuSet = std::vector<int>;
+
+/// Parses a CPU list in the syntax of the kernel (cpuset, taskset -c), e.g. "0-3,8,10-11".
+/// @param text CPU list, empty for an empty set
+/// @param[out] cpus parsed set
+/// @return false on a syntax error, with an error logged
+bool ParseCpuList(std::string_view text, CpuSet& cpus);
+
+/// @return CPU list in the syntax of ParseCpuList(), ranges merged
+std::string ToString(const CpuSet& cpus);
+
+/// @return CPUs the calling thread is allowed to run on
+CpuSet AllowedCpus();
+
+/// @return kernel id of the calling thread
+pid_t ThreadId();
+
+/// Pins a thread of the process.
+/// @param tid kernel thread id, see ThreadId()
+/// @param cpus not empty
+/// @return false if the kernel rejects the set, e.g. CPUs outside of the cpuset of the process
+bool PinThread(pid_t tid, const CpuSet& cpus);
+
+/// Placement of the threads. An empty set leaves its threads where they are.
+struct PlacementOptions {
+  CpuSet application;  ///< CPUs of the thread calling Placement::Start()
+  CpuSet others;  ///< CPUs of every other thread
+  std::chrono::milliseconds sweep_period{1000};  ///< period of the sweep of the new threads, 0 for none
+};
+
+/// Isolation presets, filling the sets not given explicitly from the allowed CPUs.
+enum class Preset {
+  kNone,  ///< no placement
+  kIsolated,  ///< the application thread alone on the last CPU, the other threads on the remaining ones
+  kCompact,  ///< the application thread on the first CPU, the other threads on the second one: shared caches
+};
+
+/// @param name "none", "isolated" or "compact"
+/// @param[out] preset parsed preset
+/// @return false on an unknown name, with an error logged
+bool ParsePreset(std::string_view name, Preset& preset);
+
+/// Fills the empty sets of the options from the preset. With a single allowed CPU, every thread shares it.
+/// @param preset to apply
+/// @param allowed CPUs of the process, see AllowedCpus()
+/// @param options sets given explicitly, kept
+/// @return completed options
+PlacementOptions ApplyPreset(Preset preset, const CpuSet& allowed, PlacementOptions options);
+
+/// Keeps the threads of the process on their CPUs, from Start() to its destruction.
+class Placement {
+ public:
+  Placement() = default;
+  ~Placement() { Stop(); }
+
+  Placement(const Placement&) = delete;
+  Placement& operator=(const Placement&) = delete;
+
+  /// Pins the calling thread as the application thread, sweeps the other threads, then starts the sweeping thread.
+  /// @return false if a set is rejected by the kernel, logged, nothing is left running
+  bool Start(const PlacementOptions& options);
+  /// Stops the sweeping thread, the threads stay where they are. Idempotent.
+  void Stop();
+
+  /// Pins the other threads still on the default CPUs, the ones of the process at Start(). The application thread
+  /// and the threads given other CPUs, e.g. by their owner, are left alone. Any thread.
+  /// @return threads pinned
+  size_t Sweep();
+
+ private:
+  void Run();
+
+  PlacementOptions options_;
+  pid_t application_tid_ = 0;
+  CpuSet initial_cpus_;  ///< CPUs of the process at Start()
+  std::mutex mu_;
+  std::condition_variable stop_cv_;
+  bool stopping_ = false;  // guarded by mu_
+  std::atomic<size_t> pinned_{0};
+  std::thread thread_;
+};
+
+}  // namespace rg_affinity
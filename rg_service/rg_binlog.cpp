@@ -0,0 +1,331 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_binlog.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fmt/args.h>
+#include <google/protobuf/descriptor.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "protobuf_utils/protobuf_utils.h"
+
+namespace rg_binlog {
+
+namespace {
+struct State {
+  std::mutex mu;
+  std::vector<std::pair<std::string, std::string>> formats;  // argument types and format, at index id - 1
+  std::string prefix;  // "<directory>/<name>.<pid>"
+  size_t ring_bytes = 0;
+  FILE* formats_file = nullptr;
+  std::atomic_bool open{false};
+  std::atomic<uint64_t> generation{0};  // incremented by Open() and Close(), so that the threads create new rings
+};
+
+State& GetState() {
+  static State state;
+  return state;
+}
+
+// The formats are written one per line, tab-separated.
+void WriteFormat(FILE* file, const uint32_t id, const std::string& types, const std::string& format) {
+  std::string escaped;
+  for (const char c : format) {
+    if (c == '\\') {
+      escaped += "\\\\";
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else if (c == '\t') {
+      escaped += "\\t";
+    } else {
+      escaped += c;
+    }
+  }
+  fmt::print(file, "{}\t{}\t{}\n", id, types, escaped);
+  std::fflush(file);
+}
+
+std::string Unescape(const std::string_view text) {
+  std::string unescaped;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] != '\\' || i + 1 == text.size()) {
+      unescaped += text[i];
+      continue;
+    }
+    const char c = text[++i];
+    unescaped += c == 'n' ? '\n' : c == 't' ? '\t' : c;
+  }
+  return unescaped;
+}
+
+std::unique_ptr<internal::Ring> CreateRing(const std::string& prefix, const size_t ring_bytes) {
+  const auto thread_id = static_cast<uint64_t>(::syscall(SYS_gettid));
+  const auto path = fmt::format("{}.{}.binlog", prefix, thread_id);
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    spdlog::error("Binary log: can't create {}: {}", path, std::strerror(errno));
+    return nullptr;
+  }
+  const auto file_size = kHeaderSize + ring_bytes;
+  void* mapping = MAP_FAILED;
+  if (::ftruncate(fd, static_cast<off_t>(file_size)) == 0) {
+    mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  const int error = errno;
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    spdlog::error("Binary log: can't map {}: {}", path, std::strerror(error));
+    return nullptr;
+  }
+  // The file is zero-filled by ftruncate(): head, tail and dropped start at 0.
+  auto* header = new (mapping) RingHeader;
+  std::memcpy(header->magic, RingHeader::kMagic, sizeof(header->magic));
+  header->capacity = ring_bytes;
+  header->thread_id = thread_id;
+  return std::make_unique<internal::Ring>(header, static_cast<uint8_t*>(mapping) + kHeaderSize);
+}
+
+// Appends the text of one argument to the arguments of the format.
+// @return position after the argument, or nullptr if it overruns the record
+const uint8_t* DecodeArg(const std::string_view type, const uint8_t* in, const uint8_t* end,
+                         fmt::dynamic_format_arg_store<fmt::format_context>& args) {
+  const auto available = static_cast<size_t>(end - in);
+  if (type == "b") {
+    if (available < 1) return nullptr;
+    args.push_back(*in != 0);
+    return in + 1;
+  }
+  if (type == "i" || type == "u" || type == "d") {
+    if (available < 8) return nullptr;
+    if (type == "i") {
+      int64_t value;
+      std::memcpy(&value, in, 8);
+      args.push_back(value);
+    } else if (type == "u") {
+      uint64_t value;
+      std::memcpy(&value, in, 8);
+      args.push_back(value);
+    } else {
+      double value;
+      std::memcpy(&value, in, 8);
+      args.push_back(value);
+    }
+    return in + 8;
+  }
+  uint32_t length;
+  if (available < 4) return nullptr;
+  std::memcpy(&length, in, 4);
+  if (available - 4 < length) return nullptr;
+  in += 4;
+  if (type == "s") {
+    args.push_back(std::string(reinterpret_cast<const char*>(in), length));
+    return in + length;
+  }
+  const auto name = type.substr(type.find(':') + 1);
+  const auto* descriptor = google::protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(std::string(name));
+  if (descriptor == nullptr) {
+    args.push_back(fmt::format("<{}: {} bytes>", name, length));
+    return in + length;
+  }
+  std::unique_ptr<google::protobuf::Message> message(
+      google::protobuf::MessageFactory::generated_factory()->GetPrototype(descriptor)->New());
+  if (!message->ParseFromArray(in, static_cast<int>(length))) {
+    args.push_back(fmt::format("<{}: unparsable {} bytes>", name, length));
+  } else {
+    args.push_back(protobuf_utils::ToString(*message));
+  }
+  return in + length;
+}
+}  // anonymous namespace
+
+bool Open(const std::string_view directory, const std::string_view name, const size_t ring_bytes) {
+  auto& state = GetState();
+  std::lock_guard lock(state.mu);
+  if (state.formats_file != nullptr) std::fclose(state.formats_file);
+  state.prefix = fmt::format("{}/{}.{}", directory, name, ::getpid());
+  const auto path = state.prefix + ".formats";
+  state.formats_file = std::fopen(path.c_str(), "we");
+  if (state.formats_file == nullptr) {
+    spdlog::error("Binary log: can't create {}: {}", path, std::strerror(errno));
+    state.open = false;
+    return false;
+  }
+  for (size_t i = 0; i < state.formats.size(); ++i) {
+    WriteFormat(state.formats_file, static_cast<uint32_t>(i + 1), state.formats[i].first, state.formats[i].second);
+  }
+  state.ring_bytes = std::max<size_t>((ring_bytes + 7) & ~size_t{7}, 4096);
+  state.generation.fetch_add(1, std::memory_order_release);
+  state.open = true;
+  spdlog::info("Binary log written to {}.*", state.prefix);
+  return true;
+}
+
+void Close() {
+  auto& state = GetState();
+  std::lock_guard lock(state.mu);
+  state.open = false;
+  state.generation.fetch_add(1, std::memory_order_release);
+  if (state.formats_file != nullptr) {
+    std::fclose(state.formats_file);
+    state.formats_file = nullptr;
+  }
+}
+
+bool Enabled() {
+  return GetState().open.load(std::memory_order_relaxed);
+}
+
+namespace internal {
+
+Ring::~Ring() {
+  ::munmap(header_, kHeaderSize + header_->capacity);
+}
+
+Ring* ThreadRing() {
+  struct Slot {
+    std::unique_ptr<Ring> ring;
+    uint64_t generation = 0;
+  };
+  thread_local Slot slot;
+  auto& state = GetState();
+  const auto generation = state.generation.load(std::memory_order_acquire);
+  if (slot.generation != generation) {
+    // First call of the thread since Open(): a failed creation is not retried until the next Open().
+    slot.generation = generation;
+    slot.ring.reset();
+    std::lock_guard lock(state.mu);
+    if (state.open) slot.ring = CreateRing(state.prefix, state.ring_bytes);
+  }
+  return slot.ring.get();
+}
+
+uint32_t Register(const std::string_view format, const std::vector<std::string>& types) {
+  std::string joined;
+  for (const auto& type : types) {
+    if (!joined.empty()) joined += ',';
+    joined += type;
+  }
+  auto& state = GetState();
+  std::lock_guard lock(state.mu);
+  state.formats.emplace_back(std::move(joined), std::string(format));
+  const auto id = static_cast<uint32_t>(state.formats.size());
+  if (state.formats_file != nullptr) {
+    WriteFormat(state.formats_file, id, state.formats.back().first, state.formats.back().second);
+  }
+  return id;
+}
+}  // namespace internal
+
+bool ReadRing(const std::string& path, std::vector<Record>& records) {
+  // "<prefix>.<tid>.binlog" is described by "<prefix>.formats".
+  const auto binlog = path.rfind(".binlog");
+  const auto thread = binlog == std::string::npos ? std::string::npos : path.rfind('.', binlog - 1);
+  if (thread == std::string::npos) {
+    spdlog::error("{}: not a ring file name, <prefix>.<tid>.binlog expected", path);
+    return false;
+  }
+  const auto formats_path = path.substr(0, thread) + ".formats";
+  std::ifstream formats_file(formats_path);
+  if (!formats_file) {
+    spdlog::error("{}: can't read {}", path, formats_path);
+    return false;
+  }
+  struct Format {
+    std::vector<std::string> types;
+    std::string text;
+  };
+  std::map<uint32_t, Format> formats;
+  for (std::string line; std::getline(formats_file, line);) {
+    const auto first = line.find('\t');
+    const auto second = first == std::string::npos ? std::string::npos : line.find('\t', first + 1);
+    if (second == std::string::npos) continue;
+    auto& format = formats[static_cast<uint32_t>(std::stoul(line.substr(0, first)))];
+    for (size_t start = first + 1; start < second;) {
+      const auto comma = std::min(line.find(',', start), second);
+      format.types.push_back(line.substr(start, comma - start));
+      start = comma + 1;
+    }
+    format.text = Unescape(std::string_view(line).substr(second + 1));
+  }
+
+  std::ifstream ring_file(path, std::ios::binary);
+  const std::string content((std::istreambuf_iterator<char>(ring_file)), std::istreambuf_iterator<char>());
+  const auto* data = reinterpret_cast<const uint8_t*>(content.data());
+  RingHeader header;
+  if (content.size() < kHeaderSize || std::memcmp(data, RingHeader::kMagic, sizeof(header.magic)) != 0) {
+    spdlog::error("{}: not a ring file", path);
+    return false;
+  }
+  std::memcpy(&header.capacity, data + offsetof(RingHeader, capacity), sizeof(header.capacity));
+  std::memcpy(&header.thread_id, data + offsetof(RingHeader, thread_id), sizeof(header.thread_id));
+  uint64_t head;
+  uint64_t tail;
+  uint64_t dropped;
+  std::memcpy(&head, data + offsetof(RingHeader, head), sizeof(head));
+  std::memcpy(&tail, data + offsetof(RingHeader, tail), sizeof(tail));
+  std::memcpy(&dropped, data + offsetof(RingHeader, dropped), sizeof(dropped));
+  const auto capacity = header.capacity;
+  if (content.size() != kHeaderSize + capacity || tail > head || head - tail > capacity) {
+    spdlog::error("{}: corrupted ring header", path);
+    return false;
+  }
+  if (dropped > 0) spdlog::warn("{}: {} records dropped, too large for the ring", path, dropped);
+
+  const auto* ring = data + kHeaderSize;
+  for (auto position = tail; position < head;) {
+    const auto* record = ring + position % capacity;
+    uint32_t words[2];
+    std::memcpy(words, record, sizeof(words));
+    const auto size = words[0];
+    if (size < 8 || size % 8 != 0 || position % capacity + size > capacity) {
+      spdlog::error("{}: corrupted record at {}", path, position);
+      return false;
+    }
+    position += size;
+    if (words[1] == 0) continue;  // padding
+    const auto format = formats.find(words[1]);
+    if (size < kRecordHeaderSize || format == formats.end()) {
+      spdlog::error("{}: unknown format {} at {}", path, words[1], position - size);
+      return false;
+    }
+    Record decoded;
+    decoded.thread_id = header.thread_id;
+    std::memcpy(&decoded.time_ns, record + 8, sizeof(decoded.time_ns));
+    fmt::dynamic_format_arg_store<fmt::format_context> args;
+    const auto* in = record + kRecordHeaderSize;
+    for (const auto& type : format->second.types) {
+      if (in == nullptr) break;
+      in = DecodeArg(type, in, record + size, args);
+    }
+    if (in == nullptr) {
+      spdlog::error("{}: truncated record at {}", path, position - size);
+      return false;
+    }
+    try {
+      decoded.text = fmt::vformat(format->second.text, args);
+    } catch (const fmt::format_error& error) {
+      decoded.text = fmt::format("<{}: {}>", format->second.text, error.what());
+    }
+    records.push_back(std::move(decoded));
+  }
+  return true;
+}
+
+}  // namespace rg_binlog
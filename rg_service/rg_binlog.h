@@ -0,0 +1,244 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <google/protobuf/message.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/************************
+ * Binary structured logging to memory-mapped ring files
+ *
+ * A log call does not format any text: it writes a compact record, the id of its format string, a timestamp and
+ * the raw bytes of its arguments (protobuf messages serialized), into the ring file of the calling thread. The
+ * ring is a memory-mapped file, so the records survive a crash of the process, and the oldest records are
+ * overwritten once it is full. The format strings are written once, in the formats file of the process, and the
+ * rg_binlog_decode tool renders the records as text offline.
+ *
+ * Files of a sink opened on `<directory>` with the name `<name>`:
+ * - `<directory>/<name>.<pid>.formats`: one format per line, `<id>\t<argument types>\t<format string>`
+ * - `<directory>/<name>.<pid>.<tid>.binlog`: ring of the thread `<tid>`, a RingHeader followed by the records
+ ************************/
+namespace rg_binlog {
+
+/// Opens the sink: the threads create their ring file on their next log call.
+/// @param directory of the files, created beforehand
+/// @param name prefix of the file names
+/// @param ring_bytes capacity of each thread ring, rounded up to 8 bytes
+/// @return false if the formats file can't be written, the sink stays closed
+bool Open(std::string_view directory, std::string_view name, size_t ring_bytes = size_t{1} << 20);
+
+/// Closes the sink: the next log calls are dropped. The ring files stay mapped until their thread exits.
+void Close();
+
+/// @return true while the sink is open
+bool Enabled();
+
+/// Header of a ring file. The records follow it, from `kHeaderSize` for `capacity` bytes.
+struct RingHeader {
+  static constexpr char kMagic[8] = {'R', 'G', 'B', 'L', 'O', 'G', '1', '\0'};
+  char magic[8];
+  uint64_t capacity;  ///< bytes of records
+  uint64_t thread_id;
+  std::atomic<uint64_t> head;  ///< bytes written since the creation, the next record starts at head % capacity
+  std::atomic<uint64_t> tail;  ///< start of the oldest record still in the ring, same unit as head
+  std::atomic<uint64_t> dropped;  ///< records too large for the ring
+};
+
+/// Record layout, aligned on 8 bytes: `uint32 size`, `uint32 format id`, `int64 nanoseconds since the epoch`,
+/// then the arguments. Format id 0 pads the end of the ring: a record never wraps around.
+inline constexpr size_t kHeaderSize = 64;
+inline constexpr size_t kRecordHeaderSize = 16;
+static_assert(sizeof(RingHeader) <= kHeaderSize);
+
+namespace internal {
+
+class Ring {
+ public:
+  Ring(RingHeader* header, uint8_t* records) : header_(header), records_(records) {}
+  ~Ring();
+
+  Ring(const Ring&) = delete;
+  Ring& operator=(const Ring&) = delete;
+
+  /// @return room for a record of `size` bytes, a multiple of 8, or nullptr if it can't fit in the ring
+  uint8_t* Reserve(const size_t size) {
+    const auto capacity = header_->capacity;
+    if (size > capacity / 2) {
+      header_->dropped.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    auto head = header_->head.load(std::memory_order_relaxed);
+    auto offset = head % capacity;
+    if (offset + size > capacity) {
+      // Pads the end of the ring, the record starts over at its beginning.
+      const auto padding = capacity - offset;
+      MakeRoom(head, padding);
+      const uint32_t words[2] = {static_cast<uint32_t>(padding), 0};
+      std::memcpy(records_ + offset, words, sizeof(words));
+      head += padding;
+      header_->head.store(head, std::memory_order_release);
+      offset = 0;
+    }
+    MakeRoom(head, size);
+    return records_ + offset;
+  }
+
+  /// Publishes the record written in the room given by Reserve().
+  void Commit(const size_t size) {
+    header_->head.store(header_->head.load(std::memory_order_relaxed) + size, std::memory_order_release);
+  }
+
+ private:
+  // Moves the tail past the oldest records until `size` bytes are free after head.
+  void MakeRoom(const uint64_t head, const size_t size) {
+    auto tail = header_->tail.load(std::memory_order_relaxed);
+    while (head + size - tail > header_->capacity) {
+      uint32_t record_size;
+      std::memcpy(&record_size, records_ + tail % header_->capacity, sizeof(record_size));
+      tail += record_size;
+    }
+    header_->tail.store(tail, std::memory_order_release);
+  }
+
+  RingHeader* header_;
+  uint8_t* records_;
+};
+
+/// @return ring of the calling thread, created on its first call, or nullptr if the sink is closed
+Ring* ThreadRing();
+/// Registers a format string with the types of its arguments.
+/// @return id of the format, from 1
+uint32_t Register(std::string_view format, const std::vector<std::string>& types);
+
+template <class T>
+inline constexpr bool kIsMessage = std::is_base_of_v<google::protobuf::Message, T>;
+template <class T>
+inline constexpr bool kIsString = std::is_convertible_v<const T&, std::string_view> && !kIsMessage<T>;
+
+/// Argument types, as written in the formats file: `b` bool, `i` signed integer or enum, `u` unsigned integer,
+/// `d` floating point, `s` string, `m:<full name>` protobuf message.
+template <class T>
+std::string TypeName() {
+  if constexpr (std::is_same_v<T, bool>) {
+    return "b";
+  } else if constexpr (std::is_enum_v<T> || (std::is_integral_v<T> && std::is_signed_v<T>)) {
+    return "i";
+  } else if constexpr (std::is_integral_v<T>) {
+    return "u";
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return "d";
+  } else if constexpr (kIsString<T>) {
+    return "s";
+  } else {
+    static_assert(kIsMessage<T>, "rg_binlog: unsupported argument type");
+    return "m:" + std::string(T::descriptor()->full_name());
+  }
+}
+
+/// @return bytes of an argument in a record. Strings and messages are prefixed by their uint32 length.
+template <class T>
+size_t ArgSize(const T& value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return 1;
+  } else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+    return 8;
+  } else if constexpr (kIsString<T>) {
+    return 4 + std::string_view(value).size();
+  } else {
+    // Computes the size cached by the message for the serialization.
+    return 4 + value.ByteSizeLong();
+  }
+}
+
+template <class T>
+uint8_t* WriteArg(uint8_t* out, const T& value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    *out = value ? 1 : 0;
+    return out + 1;
+  } else if constexpr (std::is_enum_v<T> || (std::is_integral_v<T> && std::is_signed_v<T>)) {
+    const auto raw = static_cast<int64_t>(value);
+    std::memcpy(out, &raw, 8);
+    return out + 8;
+  } else if constexpr (std::is_integral_v<T>) {
+    const auto raw = static_cast<uint64_t>(value);
+    std::memcpy(out, &raw, 8);
+    return out + 8;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    const auto raw = static_cast<double>(value);
+    std::memcpy(out, &raw, 8);
+    return out + 8;
+  } else if constexpr (kIsString<T>) {
+    const std::string_view text(value);
+    const auto length = static_cast<uint32_t>(text.size());
+    std::memcpy(out, &length, 4);
+    std::memcpy(out + 4, text.data(), text.size());
+    return out + 4 + text.size();
+  } else {
+    const auto length = static_cast<uint32_t>(value.GetCachedSize());
+    std::memcpy(out, &length, 4);
+    return value.SerializeWithCachedSizesToArray(out + 4);
+  }
+}
+}  // namespace internal
+
+/// Format string of a log call site, with the types of its arguments, in the fmt syntax without format specs.
+/// Meant as a function-local static, registered once:
+///
+///   static const rg_binlog::Format<std::string_view, routeguide::Feature> kResponse("[{}] RESPONSE | {}");
+///   kResponse.Log(logger.name(), feature);
+template <class... Args>
+class Format {
+ public:
+  explicit Format(const std::string_view format)
+      : id_(internal::Register(format, {internal::TypeName<std::remove_cvref_t<Args>>()...})) {}
+
+  /// Writes a record in the ring of the calling thread, or nothing if the sink is closed.
+  void Log(const Args&... args) const {
+    if (!Enabled()) return;
+    auto* ring = internal::ThreadRing();
+    if (ring == nullptr) return;
+    const auto size = (kRecordHeaderSize + ... + internal::ArgSize(args));
+    const auto aligned = (size + 7) & ~size_t{7};
+    auto* record = ring->Reserve(aligned);
+    if (record == nullptr) return;
+    const uint32_t words[2] = {static_cast<uint32_t>(aligned), id_};
+    const int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+    std::memcpy(record, words, sizeof(words));
+    std::memcpy(record + 8, &time, sizeof(time));
+    auto* out = record + kRecordHeaderSize;
+    ((out = internal::WriteArg(out, args)), ...);
+    ring->Commit(aligned);
+  }
+
+ private:
+  const uint32_t id_;
+};
+
+/// Record decoded by ReadRing().
+struct Record {
+  uint64_t thread_id = 0;
+  int64_t time_ns = 0;  ///< since the epoch
+  std::string text;  ///< rendered format
+};
+
+/// Reads the records of a ring file, oldest first, and renders them with the formats file of its process.
+/// @param path of the ring file
+/// @param[out] records appended
+/// @return false if the files can't be read or are corrupted, with an error logged
+bool ReadRing(const std::string& path, std::vector<Record>& records);
+
+}  // namespace rg_binlog
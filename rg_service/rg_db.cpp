@@ -9,6 +9,7 @@
 
 #include <array>
 #include <cstdint>
+#include <iterator>
 #include <string_view>
 
 #include "rg_service/rg_utils.h"
@@ -24,3 +25,102 @@ FeatureList rg_db::GetInitialFeatures() {
   spdlog::info("Initial features loaded, {} features.", feature_list.size());
   return feature_list;
 }
+
+namespace rg_db {
+
+void FeatureStore::Reserve(const size_t count, const size_t name_bytes) {
+  if (mode_ == Mode::kEager) {
+    features_.reserve(count);
+  } else {
+    records_.reserve(count);
+    names_.reserve(name_bytes);
+  }
+}
+
+void FeatureStore::Add(const std::string_view name, const int32_t latitude, const int32_t longitude) {
+  if (mode_ == Mode::kEager) {
+    auto& feature = features_.emplace_back();
+    feature.set_name(name.data(), name.size());
+    feature.mutable_location()->set_latitude(latitude);
+    feature.mutable_location()->set_longitude(longitude);
+  } else {
+    records_.push_back({latitude, longitude, names_.size()});
+    names_.append(name);
+    names_.push_back('\0');
+  }
+}
+
+void FeatureStore::Append(std::vector<FeatureStore>& others) {
+  size_t count = size();
+  size_t name_bytes = names_.size();
+  for (const auto& other : others) {
+    count += other.size();
+    name_bytes += other.names_.size();
+  }
+  Reserve(count, name_bytes);
+  for (auto& other : others) {
+    if (mode_ == Mode::kEager) {
+      features_.insert(features_.end(), std::make_move_iterator(other.features_.begin()),
+                       std::make_move_iterator(other.features_.end()));
+    } else {
+      const auto base = names_.size();
+      for (const auto& record : other.records_) {
+        records_.push_back({record.latitude, record.longitude, record.name_offset + base});
+      }
+      names_.append(other.names_);
+    }
+    other = FeatureStore(other.mode_);
+  }
+}
+
+routeguide::Point FeatureStore::location(const size_t i) const {
+  if (mode_ == Mode::kEager) return features_[i].location();
+  return rg_utils::MakePoint(records_[i].latitude, records_[i].longitude);
+}
+
+std::string_view FeatureStore::name(const size_t i) const {
+  if (mode_ == Mode::kEager) return features_[i].name();
+  const auto end = i + 1 < records_.size() ? records_[i + 1].name_offset : names_.size();
+  return std::string_view(names_).substr(records_[i].name_offset, end - records_[i].name_offset - 1);
+}
+
+const routeguide::Feature& FeatureStore::Get(const size_t i, routeguide::Feature& scratch) const {
+  if (mode_ == Mode::kEager) return features_[i];
+  const auto feature_name = name(i);
+  scratch.set_name(feature_name.data(), feature_name.size());
+  scratch.mutable_location()->set_latitude(records_[i].latitude);
+  scratch.mutable_location()->set_longitude(records_[i].longitude);
+  return scratch;
+}
+
+routeguide::Feature* FeatureStore::Materialize(const size_t i, google::protobuf::Arena* arena) const {
+  auto* feature = google::protobuf::Arena::Create<routeguide::Feature>(arena);
+  if (mode_ == Mode::kEager) {
+    *feature = features_[i];
+  } else {
+    Get(i, *feature);
+  }
+  return feature;
+}
+
+size_t FeatureStore::MemoryBytes() const {
+  if (mode_ == Mode::kLazy) return records_.capacity() * sizeof(Record) + names_.capacity();
+  size_t bytes = features_.capacity() * sizeof(routeguide::Feature);
+  for (const auto& feature : features_) {
+    bytes += feature.SpaceUsedLong() - sizeof(routeguide::Feature);
+  }
+  return bytes;
+}
+
+FeatureStore GetInitialFeatureStore(const FeatureStore::Mode mode) {
+  if (mode == FeatureStore::Mode::kEager) return FeatureStore(GetInitialFeatures());
+  FeatureStore store(mode);
+  store.Reserve(kInitialFeatures.size(), 0);
+  for (const auto& [name, latitude, longitude] : kInitialFeatures) {
+    store.Add(name, latitude, longitude);
+  }
+  spdlog::info("Initial features loaded, {} compact features.", store.size());
+  return store;
+}
+
+}  // namespace rg_db
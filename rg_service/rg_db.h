@@ -5,12 +5,84 @@
 
 #pragma once
 
+#include <google/protobuf/arena.h>
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "rg_service/rg_hugepages.h"
 #include "rg_service/route_guide_service.h"
 
 using FeatureList = std::vector<routeguide::Feature>;
 
 namespace rg_db {
 FeatureList GetInitialFeatures();
+
+/// Read-only features served by a server, in one of two modes:
+/// - kEager: one protobuf Feature per record, built up front.
+/// - kLazy: compact records, a location and the offset of the name in one shared buffer: 16 bytes plus the
+///   name per feature. A Feature message is built by Get() only when a response needs it, so startup time
+///   and memory no longer grow with the number of protobuf objects.
+/// The arrays of a large store are mapped on huge pages in a huge-page mode, see rg_hugepages.h.
+class FeatureStore {
+ public:
+  enum class Mode {
+    kEager,
+    kLazy,
+  };
+
+  explicit FeatureStore(Mode mode = Mode::kEager) : mode_(mode) {}
+  /// Eager store of the features.
+  explicit FeatureStore(FeatureList features)
+      : mode_(Mode::kEager),
+        features_(std::make_move_iterator(features.begin()), std::make_move_iterator(features.end())) {}
+
+  void Reserve(size_t count, size_t name_bytes);
+  void Add(std::string_view name, int32_t latitude, int32_t longitude);
+  /// Moves the features of other stores of the same mode to the end of this one, in order.
+  void Append(std::vector<FeatureStore>& others);
+
+  Mode mode() const { return mode_; }
+  size_t size() const { return mode_ == Mode::kEager ? features_.size() : records_.size(); }
+  int32_t latitude(const size_t i) const {
+    return mode_ == Mode::kEager ? features_[i].location().latitude() : records_[i].latitude;
+  }
+  int32_t longitude(const size_t i) const {
+    return mode_ == Mode::kEager ? features_[i].location().longitude() : records_[i].longitude;
+  }
+  routeguide::Point location(size_t i) const;
+  /// @return name of the feature, NUL-terminated in both modes
+  std::string_view name(size_t i) const;
+
+  /// Feature i, for a response: the stored message in eager mode, `scratch` filled in lazy mode.
+  /// @param scratch reused across calls, it can live on the arena of the RPC
+  const routeguide::Feature& Get(size_t i, routeguide::Feature& scratch) const;
+  /// New Feature message of feature i, on the arena if any, else owned by the caller.
+  routeguide::Feature* Materialize(size_t i, google::protobuf::Arena* arena) const;
+
+  /// Approximate heap memory held by the features, in bytes.
+  size_t MemoryBytes() const;
+
+ private:
+  struct Record {
+    int32_t latitude;
+    int32_t longitude;
+    uint64_t name_offset;  ///< in names_, the name ends with a NUL
+  };
+
+  template <class T>
+  using Array = std::vector<T, rg_hugepages::Allocator<T>>;
+
+  Mode mode_;
+  Array<routeguide::Feature> features_;  ///< kEager
+  Array<Record> records_;  ///< kLazy
+  std::basic_string<char, std::char_traits<char>, rg_hugepages::Allocator<char>> names_;  ///< kLazy
+};
+
+/// Built-in features in a store of the mode, without any protobuf message in lazy mode.
+FeatureStore GetInitialFeatureStore(FeatureStore::Mode mode);
 }  // namespace rg_db
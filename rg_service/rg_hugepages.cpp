@@ -0,0 +1,278 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_hugepages.h"
+
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace rg_hugepages {
+
+namespace {
+/// Blocks of the RPC arenas: a handful of messages each.
+constexpr size_t kArenaBlockSize = 4096;
+
+std::atomic<Mode> mode{Mode::kOff};
+
+size_t RoundUp(const size_t bytes) {
+  return (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+}
+
+void* MapAnonymous(const size_t length, const int flags) {
+  void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+  return address == MAP_FAILED ? nullptr : address;
+}
+
+// The kernel backs a transparent huge page only with an aligned 2 MiB range, so the mapping is aligned by trimming
+// a larger one.
+void* MapTransparent(const size_t length) {
+  auto* reserved = static_cast<char*>(MapAnonymous(length + kHugePageSize, 0));
+  if (reserved == nullptr) return nullptr;
+  const auto start = (reinterpret_cast<uintptr_t>(reserved) + kHugePageSize - 1) & ~uintptr_t{kHugePageSize - 1};
+  auto* aligned = reinterpret_cast<char*>(start);
+  if (aligned != reserved) ::munmap(reserved, static_cast<size_t>(aligned - reserved));
+  const auto tail = static_cast<size_t>(reserved + length + kHugePageSize - (aligned + length));
+  if (tail > 0) ::munmap(aligned + length, tail);
+  if (::madvise(aligned, length, MADV_HUGEPAGE) != 0) {
+    static std::once_flag logged;
+    std::call_once(logged, [] {
+      spdlog::warn("Huge pages: madvise(MADV_HUGEPAGE) failed, 4 KiB pages used: {}", std::strerror(errno));
+    });
+  }
+  return aligned;
+}
+
+struct BlockPool {
+  std::mutex mu;
+  std::vector<void*> free;  // guarded by mu
+};
+
+BlockPool& GetBlockPool() {
+  static BlockPool pool;
+  return pool;
+}
+
+void* AllocateBlock(const size_t bytes) {
+  // A message larger than a block gets a block of its own size, from the heap.
+  if (bytes != kArenaBlockSize) return ::operator new(bytes);
+  auto& pool = GetBlockPool();
+  std::lock_guard lock(pool.mu);
+  if (pool.free.empty()) {
+    auto* chunk = static_cast<char*>(Map(kHugePageSize));
+    if (chunk == nullptr) return ::operator new(bytes);
+    for (size_t offset = kHugePageSize; offset > 0; offset -= kArenaBlockSize) {
+      pool.free.push_back(chunk + offset - kArenaBlockSize);
+    }
+  }
+  auto* block = pool.free.back();
+  pool.free.pop_back();
+  return block;
+}
+
+void DeallocateBlock(void* block, const size_t bytes) {
+  if (bytes != kArenaBlockSize) {
+    ::operator delete(block);
+    return;
+  }
+  auto& pool = GetBlockPool();
+  std::lock_guard lock(pool.mu);
+  pool.free.push_back(block);
+}
+
+int OpenDtlbCounter(const int tid) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HW_CACHE;
+  attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(::syscall(SYS_perf_event_open, &attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+uint64_t ReadCounter(const int fd) {
+  uint64_t value = 0;
+  return ::read(fd, &value, sizeof(value)) == sizeof(value) ? value : 0;
+}
+
+const char* ModeName(const Mode value) {
+  switch (value) {
+    case Mode::kTransparent:
+      return "transparent";
+    case Mode::kExplicit:
+      return "explicit";
+    default:
+      return "off";
+  }
+}
+}  // anonymous namespace
+
+bool ParseMode(const std::string_view name, Mode& parsed) {
+  if (name == "off") {
+    parsed = Mode::kOff;
+  } else if (name == "transparent") {
+    parsed = Mode::kTransparent;
+  } else if (name == "explicit") {
+    parsed = Mode::kExplicit;
+  } else {
+    spdlog::error("Unknown huge pages mode: {}, expected off, transparent or explicit", name);
+    return false;
+  }
+  return true;
+}
+
+void SetMode(const Mode value) {
+  mode.store(value, std::memory_order_relaxed);
+}
+
+Mode GetMode() {
+  return mode.load(std::memory_order_relaxed);
+}
+
+void* Map(const size_t bytes) {
+  const auto length = RoundUp(bytes);
+  switch (GetMode()) {
+    case Mode::kExplicit:
+      if (auto* address = MapAnonymous(length, MAP_HUGETLB)) return address;
+      {
+        static std::once_flag logged;
+        std::call_once(logged, [] {
+          spdlog::warn("Huge pages: no reserved huge page left (/proc/sys/vm/nr_hugepages), falling back to "
+                       "transparent huge pages");
+        });
+      }
+      return MapTransparent(length);
+    case Mode::kTransparent:
+      return MapTransparent(length);
+    default:
+      return MapAnonymous(length, 0);
+  }
+}
+
+void Unmap(void* address, const size_t bytes) {
+  ::munmap(address, RoundUp(bytes));
+}
+
+google::protobuf::ArenaOptions ArenaOptions() {
+  google::protobuf::ArenaOptions options;
+  if (GetMode() == Mode::kOff) return options;
+  options.start_block_size = kArenaBlockSize;
+  options.max_block_size = kArenaBlockSize;
+  options.block_alloc = &AllocateBlock;
+  options.block_dealloc = &DeallocateBlock;
+  return options;
+}
+
+DtlbCounter::~DtlbCounter() {
+  for (const auto& [tid, fd] : counters_) ::close(fd);
+}
+
+bool DtlbCounter::Open() {
+  const auto tid = static_cast<int>(::syscall(SYS_gettid));
+  const int fd = OpenDtlbCounter(tid);
+  if (fd < 0) {
+    spdlog::warn("dTLB misses unavailable, perf_event_open failed: {}", std::strerror(errno));
+    return false;
+  }
+  counters_[tid] = fd;
+  return true;
+}
+
+uint64_t DtlbCounter::Read() {
+  std::set<int> alive;
+  if (auto* tasks = ::opendir("/proc/self/task")) {
+    while (const auto* entry = ::readdir(tasks)) {
+      if (entry->d_name[0] != '.') alive.insert(std::atoi(entry->d_name));
+    }
+    ::closedir(tasks);
+  }
+  uint64_t misses = exited_;
+  for (auto it = counters_.begin(); it != counters_.end();) {
+    const auto value = ReadCounter(it->second);
+    if (alive.count(it->first) == 0) {
+      // The counter of an exited thread keeps its last value.
+      exited_ += value;
+      ::close(it->second);
+      it = counters_.erase(it);
+    } else {
+      ++it;
+    }
+    misses += value;
+  }
+  for (const int tid : alive) {
+    if (counters_.count(tid) != 0) continue;
+    if (const int fd = OpenDtlbCounter(tid); fd >= 0) counters_[tid] = fd;
+  }
+  return misses;
+}
+
+uint64_t HugePagesBytes() {
+  std::ifstream rollup("/proc/self/smaps_rollup");
+  uint64_t kib = 0;
+  for (std::string line; std::getline(rollup, line);) {
+    for (const std::string_view key : {"AnonHugePages:", "Private_Hugetlb:", "Shared_Hugetlb:"}) {
+      if (line.compare(0, key.size(), key) == 0) kib += std::strtoull(line.c_str() + key.size(), nullptr, 10);
+    }
+  }
+  return kib * 1024;
+}
+
+void MemoryReporter::Start(const std::chrono::seconds period) {
+  Stop();
+  if (period.count() <= 0) return;
+  stopping_ = false;
+  thread_ = std::thread(&MemoryReporter::Run, this, period);
+}
+
+void MemoryReporter::Stop() {
+  {
+    std::lock_guard lock(mu_);
+    stopping_ = true;
+  }
+  stop_cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+void MemoryReporter::Run(const std::chrono::seconds period) {
+  DtlbCounter dtlb;
+  const bool counting = dtlb.Open();
+  uint64_t last_misses = counting ? dtlb.Read() : 0;
+  auto last_time = std::chrono::steady_clock::now();
+  std::unique_lock lock(mu_);
+  while (!stop_cv_.wait_for(lock, period, [this] { return stopping_; })) {
+    lock.unlock();
+    const auto now = std::chrono::steady_clock::now();
+    const auto huge_pages_kib = HugePagesBytes() / 1024;
+    if (counting) {
+      const auto misses = dtlb.Read();
+      const auto seconds = std::chrono::duration<double>(now - last_time).count();
+      const auto rate = static_cast<double>(misses - last_misses) / seconds;
+      spdlog::info("Memory: huge pages {}, {} KiB held, dTLB load misses {:.0f}/s", ModeName(GetMode()),
+                   huge_pages_kib, rate);
+      last_misses = misses;
+    } else {
+      spdlog::info("Memory: huge pages {}, {} KiB held", ModeName(GetMode()), huge_pages_kib);
+    }
+    last_time = now;
+    lock.lock();
+  }
+}
+
+}  // namespace rg_hugepages
@@ -0,0 +1,140 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <google/protobuf/arena.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+
+/************************
+ * Huge pages: large allocations and arena blocks backed by 2 MiB pages
+ *
+ * A feature store of millions of records, or the arenas of thousands of RPCs, spread over as many 4 KiB pages, and
+ * every page costs a TLB entry. In a huge-page mode, the allocations of at least kHugePageSize and the blocks of the
+ * RPC arenas are mapped on 2 MiB pages instead:
+ * - transparent: anonymous mappings aligned on 2 MiB, advised with madvise(MADV_HUGEPAGE), which works with the
+ *   `madvise` setting of /sys/kernel/mm/transparent_hugepage/enabled; the kernel may still back them with 4 KiB pages
+ * - explicit: MAP_HUGETLB mappings, from the pages reserved in /proc/sys/vm/nr_hugepages, with a fallback to the
+ *   transparent mode when the reservation runs out
+ *
+ * The mode is set once, before the allocations (SetMode()). The memory report gives the dTLB misses of the process,
+ * from the PMU through perf_event_open(), and the huge pages it holds.
+ ************************/
+namespace rg_hugepages {
+
+enum class Mode { kOff, kTransparent, kExplicit };
+
+inline constexpr size_t kHugePageSize = size_t{2} << 20;
+
+/// @param name "off", "transparent" or "explicit"
+/// @param[out] mode parsed mode
+/// @return false on an unknown name, with an error logged
+bool ParseMode(std::string_view name, Mode& mode);
+
+/// Sets the mode of the process. Call it before the allocations it applies to.
+void SetMode(Mode mode);
+Mode GetMode();
+
+/// Maps anonymous memory in the mode of the process, in a multiple of kHugePageSize.
+/// @return mapping, or nullptr if the kernel refuses it
+void* Map(size_t bytes);
+/// Unmaps a mapping of Map(), with the same size.
+void Unmap(void* address, size_t bytes);
+
+/// Standard allocator mapping the allocations of at least kHugePageSize with Map(), whatever the mode, so that a
+/// container keeps working across SetMode(). The smaller ones stay on the heap.
+template <class T>
+class Allocator {
+ public:
+  using value_type = T;
+
+  Allocator() = default;
+  template <class U>
+  Allocator(const Allocator<U>& /*other*/) {}  // Implicit: the containers rebind their allocator.
+
+  T* allocate(const size_t count) {
+    const auto bytes = count * sizeof(T);
+    if (bytes < kHugePageSize) return static_cast<T*>(::operator new(bytes));
+    auto* address = Map(bytes);
+    if (address == nullptr) throw std::bad_alloc();
+    return static_cast<T*>(address);
+  }
+
+  void deallocate(T* address, const size_t count) {
+    const auto bytes = count * sizeof(T);
+    if (bytes < kHugePageSize) {
+      ::operator delete(address);
+    } else {
+      Unmap(address, bytes);
+    }
+  }
+
+  template <class U>
+  bool operator==(const Allocator<U>& /*other*/) const {
+    return true;
+  }
+};
+
+/// Options of a protobuf arena: in a huge-page mode, its blocks are taken from a pool of fixed-size blocks carved
+/// out of huge pages, shared by the arenas of the process and never given back to the kernel. Off, the default
+/// options.
+google::protobuf::ArenaOptions ArenaOptions();
+
+/// Samples the dTLB load misses of the threads of the process, from a perf counter per thread, opened for the new
+/// threads at every sample. Needs a PMU and perf_event_paranoid <= 2.
+class DtlbCounter {
+ public:
+  DtlbCounter() = default;
+  ~DtlbCounter();
+
+  DtlbCounter(const DtlbCounter&) = delete;
+  DtlbCounter& operator=(const DtlbCounter&) = delete;
+
+  /// @return false if the counter can't be opened for the calling thread, e.g. without a PMU, logged
+  bool Open();
+  /// @return misses counted since Open() by the threads seen so far, including the exited ones
+  uint64_t Read();
+
+ private:
+  std::map<int, int> counters_;  // perf file descriptor by thread id
+  uint64_t exited_ = 0;  // misses of the threads gone since
+};
+
+/// @return bytes of huge pages, transparent and explicit, held by the process
+uint64_t HugePagesBytes();
+
+/// Logs the huge pages of the process and its dTLB misses per second, periodically, from a thread of its own.
+class MemoryReporter {
+ public:
+  MemoryReporter() = default;
+  ~MemoryReporter() { Stop(); }
+
+  MemoryReporter(const MemoryReporter&) = delete;
+  MemoryReporter& operator=(const MemoryReporter&) = delete;
+
+  /// Starts the reports, without the dTLB misses if the counter can't be opened.
+  void Start(std::chrono::seconds period);
+  /// Idempotent.
+  void Stop();
+
+ private:
+  void Run(std::chrono::seconds period);
+
+  std::mutex mu_;
+  std::condition_variable stop_cv_;
+  bool stopping_ = false;  // guarded by mu_
+  std::thread thread_;
+};
+
+}  // namespace rg_hugepages
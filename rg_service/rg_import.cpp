@@ -0,0 +1,543 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_import.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr int32_t kLatitudeMaxE7 = 900000000;
+constexpr int32_t kLongitudeMaxE7 = 1800000000;
+// Smallest chunk handed to a thread, and chunks per thread so that uneven chunks still balance.
+constexpr size_t kMinChunkBytes = size_t{1} << 20;
+constexpr size_t kChunksPerThread = 4;
+
+/// Runs task(i) for every i in [0, count), spread over up to `threads` threads.
+template <class Task>
+void ParallelFor(const size_t count, const unsigned threads, const Task& task) {
+  std::atomic<size_t> next{0};
+  const auto worker = [&] {
+    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+      task(i);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < std::min<size_t>(threads, count); ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : pool) {
+    thread.join();
+  }
+}
+
+std::optional<std::string> ReadFile(const std::string& path) {
+  std::error_code error;
+  const auto size = std::filesystem::file_size(path, error);
+  std::ifstream file(path, std::ios::binary);
+  if (error || !file) return std::nullopt;
+  std::string text(size, '\0');
+  if (!file.read(text.data(), static_cast<std::streamsize>(size))) return std::nullopt;
+  return text;
+}
+
+bool IsDigit(const char c) { return c >= '0' && c <= '9'; }
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+  return text;
+}
+
+std::optional<int32_t> ParseE7(const std::string_view text) {
+  int32_t value = 0;
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc() || end != text.data() + text.size()) return std::nullopt;
+  return value;
+}
+
+bool IsValidLocation(const int32_t latitude, const int32_t longitude) {
+  return latitude >= -kLatitudeMaxE7 && latitude <= kLatitudeMaxE7 && longitude >= -kLongitudeMaxE7 &&
+         longitude <= kLongitudeMaxE7;
+}
+
+/// Cuts text[begin, end) into about `chunk_count` ranges, each ending after a line break.
+std::vector<std::pair<size_t, size_t>> SplitLines(const std::string_view text, const size_t begin, const size_t end,
+                                                  const size_t chunk_count) {
+  std::vector<std::pair<size_t, size_t>> chunks;
+  const auto chunk_bytes = std::max(kMinChunkBytes, (end - begin) / chunk_count + 1);
+  for (auto from = begin; from < end;) {
+    auto to = from + chunk_bytes;
+    if (to >= end) {
+      to = end;
+    } else if (const auto line_end = text.find('\n', to); line_end == std::string_view::npos || line_end >= end) {
+      to = end;
+    } else {
+      to = line_end + 1;
+    }
+    chunks.emplace_back(from, to);
+    from = to;
+  }
+  return chunks;
+}
+
+/// Moves the per-chunk stores into one, in chunk order: element moves or, in lazy mode, plain copies.
+rg_db::FeatureStore Concatenate(std::vector<rg_db::FeatureStore>& parts, const rg_db::FeatureStore::Mode mode) {
+  rg_db::FeatureStore store(mode);
+  store.Append(parts);
+  return store;
+}
+
+/************************
+ * CSV
+ ************************/
+struct CsvColumns {
+  size_t name = 0;
+  size_t latitude = 1;
+  size_t longitude = 2;
+  bool e7 = false;  ///< coordinates in integer E7 units instead of degrees
+};
+
+/// Splits a CSV line into its fields, quotes included.
+/// @return false if a quoted field is not closed or is followed by something else than a comma
+bool SplitCsvLine(std::string_view line, std::vector<std::string_view>& fields) {
+  fields.clear();
+  size_t pos = 0;
+  while (true) {
+    auto end = pos;
+    if (end < line.size() && line[end] == '"') {
+      for (++end;; end += 2) {
+        end = line.find('"', end);
+        if (end == std::string_view::npos) return false;
+        if (end + 1 >= line.size() || line[end + 1] != '"') break;
+      }
+      ++end;
+      if (end < line.size() && line[end] != ',') return false;
+    } else {
+      end = std::min(line.find(',', pos), line.size());
+    }
+    fields.push_back(line.substr(pos, end - pos));
+    if (end >= line.size()) return true;
+    pos = end + 1;
+  }
+}
+
+/// Text of a CSV field: a quoted field loses its quotes and has its "" unescaped.
+/// @param storage holds the unescaped text, the result points into the field itself when there is none
+std::string_view CsvText(std::string_view field, std::string& storage) {
+  field = Trim(field);
+  if (field.size() < 2 || field.front() != '"') return field;
+  field = field.substr(1, field.size() - 2);
+  auto quote = field.find('"');
+  if (quote == std::string_view::npos) return field;
+  storage.clear();
+  size_t from = 0;
+  for (; quote != std::string_view::npos; quote = field.find('"', from)) {
+    storage.append(field.substr(from, quote + 1 - from));  // keeps the first quote of each ""
+    from = quote + 2;
+  }
+  storage.append(field.substr(std::min(from, field.size())));
+  return storage;
+}
+
+/// Reads the column layout from a header row.
+/// @return nullopt if the row is not a header, or misses a column
+std::optional<CsvColumns> ParseCsvHeader(const std::vector<std::string_view>& fields) {
+  CsvColumns columns;
+  int found = 0;
+  bool e7 = false;
+  for (size_t i = 0; i < fields.size(); ++i) {
+    std::string storage;
+    std::string name(CsvText(fields[i], storage));
+    std::ranges::transform(name, name.begin(), [](const unsigned char c) { return std::tolower(c); });
+    if (name.ends_with("_e7")) {
+      e7 = true;
+      name.resize(name.size() - 3);
+    }
+    if (name == "name") {
+      columns.name = i;
+      found |= 1;
+    } else if (name == "latitude" || name == "lat") {
+      columns.latitude = i;
+      found |= 2;
+    } else if (name == "longitude" || name == "lon" || name == "lng") {
+      columns.longitude = i;
+      found |= 4;
+    }
+  }
+  if (found != 7) return std::nullopt;
+  columns.e7 = e7;
+  return columns;
+}
+
+/// Adds the feature of a record to the store, built in place rather than through rg_utils::MakeFeature().
+/// @param storage scratch buffer of the name
+/// @return false if the record does not parse
+bool ParseCsvRecord(const std::vector<std::string_view>& fields, const CsvColumns& columns, std::string& storage,
+                    rg_db::FeatureStore& store) {
+  if (std::max({columns.name, columns.latitude, columns.longitude}) >= fields.size()) return false;
+  const auto parse = columns.e7 ? ParseE7 : rg_import::ParseDegreesE7;
+  const auto latitude = parse(Trim(fields[columns.latitude]));
+  const auto longitude = parse(Trim(fields[columns.longitude]));
+  if (!latitude || !longitude || !IsValidLocation(*latitude, *longitude)) return false;
+  store.Add(CsvText(fields[columns.name], storage), *latitude, *longitude);
+  return true;
+}
+
+rg_db::FeatureStore ImportCsv(const std::string_view text, const unsigned threads, const rg_db::FeatureStore::Mode mode,
+                              size_t& skipped) {
+  // The first line is either a header or a record of the default layout.
+  const auto first_end = std::min(text.find('\n'), text.size());
+  std::vector<std::string_view> fields;
+  std::string storage;
+  rg_db::FeatureStore first(mode);
+  CsvColumns columns;
+  size_t begin = 0;
+  if (SplitCsvLine(Trim(text.substr(0, first_end)), fields) && !ParseCsvRecord(fields, columns, storage, first)) {
+    if (const auto header = ParseCsvHeader(fields)) {
+      columns = *header;
+      begin = std::min(first_end + 1, text.size());
+    }
+  }
+
+  const auto chunks = SplitLines(text, begin, text.size(), size_t{threads} * kChunksPerThread);
+  std::vector<rg_db::FeatureStore> parts(chunks.size(), rg_db::FeatureStore(mode));
+  std::vector<size_t> part_skipped(chunks.size(), 0);
+  ParallelFor(chunks.size(), threads, [&](const size_t i) {
+    const auto chunk = text.substr(chunks[i].first, chunks[i].second - chunks[i].first);
+    auto& features = parts[i];
+    features.Reserve(chunk.size() / 48, chunk.size());
+    std::vector<std::string_view> record;
+    std::string name;
+    for (size_t pos = 0; pos < chunk.size();) {
+      const auto end = std::min(chunk.find('\n', pos), chunk.size());
+      const auto line = Trim(chunk.substr(pos, end - pos));
+      pos = end + 1;
+      if (line.empty()) continue;
+      if (!SplitCsvLine(line, record) || !ParseCsvRecord(record, columns, name, features)) {
+        ++part_skipped[i];
+      }
+    }
+  });
+  for (const auto count : part_skipped) skipped += count;
+  return Concatenate(parts, mode);
+}
+
+/************************
+ * GeoJSON
+ ************************/
+/// Spans of the objects held by the arrays of the top-level object: the features of a FeatureCollection.
+std::vector<std::string_view> FindGeoJsonFeatures(const std::string_view text) {
+  std::vector<std::string_view> features;
+  std::vector<char> open;  // enclosing '{' and '['
+  size_t start = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    switch (text[i]) {
+      case '"':
+        for (++i; i < text.size() && text[i] != '"'; ++i) {
+          if (text[i] == '\\') ++i;
+        }
+        break;
+      case '{':
+        if (open.size() == 2 && open[0] == '{' && open[1] == '[') start = i;
+        open.push_back('{');
+        break;
+      case '[':
+        open.push_back('[');
+        break;
+      case '}':
+      case ']':
+        if (open.empty()) return features;
+        open.pop_back();
+        if (text[i] == '}' && open.size() == 2 && open[0] == '{' && open[1] == '[') {
+          features.push_back(text.substr(start, i + 1 - start));
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return features;
+}
+
+size_t SkipSpaces(const std::string_view text, size_t pos) {
+  while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+    ++pos;
+  }
+  return pos;
+}
+
+/// End of the JSON string starting at the opening quote: the position after its closing quote, or npos.
+size_t SkipJsonString(const std::string_view text, size_t pos) {
+  for (++pos; pos < text.size(); ++pos) {
+    if (text[pos] == '\\') {
+      ++pos;
+    } else if (text[pos] == '"') {
+      return pos + 1;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/// End of the JSON value starting at `pos`: the position after it, or npos if it is cut.
+size_t SkipJsonValue(const std::string_view text, size_t pos) {
+  if (pos >= text.size()) return std::string_view::npos;
+  if (text[pos] == '"') return SkipJsonString(text, pos);
+  if (text[pos] != '{' && text[pos] != '[') return std::min(text.find_first_of(",]} \t\r\n", pos), text.size());
+  size_t depth = 0;
+  for (; pos < text.size(); ++pos) {
+    switch (text[pos]) {
+      case '"':
+        pos = SkipJsonString(text, pos);
+        if (pos == std::string_view::npos) return pos;
+        --pos;
+        break;
+      case '{':
+      case '[':
+        ++depth;
+        break;
+      case '}':
+      case ']':
+        if (--depth == 0) return pos + 1;
+        break;
+      default:
+        break;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/// Value of a member of a JSON object, not of the objects nested in it.
+/// @param object JSON object, from its '{' to its '}'
+/// @param key name of the member, unquoted
+/// @return the value, from its first character to its last, or empty if the object has no such member
+std::string_view FindMember(const std::string_view object, const std::string_view key) {
+  if (object.empty() || object[0] != '{') return {};
+  for (auto pos = SkipSpaces(object, 1); pos < object.size() && object[pos] == '"';) {
+    const auto key_end = SkipJsonString(object, pos);
+    if (key_end == std::string_view::npos) return {};
+    const auto name = object.substr(pos + 1, key_end - pos - 2);
+    pos = SkipSpaces(object, key_end);
+    if (pos >= object.size() || object[pos] != ':') return {};
+    pos = SkipSpaces(object, pos + 1);
+    const auto value_end = SkipJsonValue(object, pos);
+    if (value_end == std::string_view::npos) return {};
+    if (name == key) return object.substr(pos, value_end - pos);
+    pos = SkipSpaces(object, value_end);
+    if (pos >= object.size() || object[pos] != ',') return {};
+    pos = SkipSpaces(object, pos + 1);
+  }
+  return {};
+}
+
+void AppendUtf8(std::string& text, const uint32_t code_point) {
+  if (code_point < 0x80) {
+    text.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    text.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    text.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    text.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    text.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+/// Decodes the JSON string starting at the opening quote.
+std::optional<std::string> ParseJsonString(const std::string_view text, size_t pos) {
+  std::string value;
+  const auto hex4 = [&text](const size_t at) -> std::optional<uint32_t> {
+    uint32_t code = 0;
+    if (at + 4 > text.size()) return std::nullopt;
+    const auto [end, error] = std::from_chars(text.data() + at, text.data() + at + 4, code, 16);
+    if (error != std::errc() || end != text.data() + at + 4) return std::nullopt;
+    return code;
+  };
+  for (++pos; pos < text.size(); ++pos) {
+    const char c = text[pos];
+    if (c == '"') return value;
+    if (c != '\\') {
+      value.push_back(c);
+      continue;
+    }
+    if (++pos >= text.size()) return std::nullopt;
+    switch (text[pos]) {
+      case 'b': value.push_back('\b'); break;
+      case 'f': value.push_back('\f'); break;
+      case 'n': value.push_back('\n'); break;
+      case 'r': value.push_back('\r'); break;
+      case 't': value.push_back('\t'); break;
+      case 'u': {
+        auto code = hex4(pos + 1);
+        if (!code) return std::nullopt;
+        pos += 4;
+        if (*code >= 0xD800 && *code < 0xDC00 && text.substr(pos + 1, 2) == "\\u") {
+          if (const auto low = hex4(pos + 3); low && *low >= 0xDC00 && *low < 0xE000) {
+            code = 0x10000 + ((*code - 0xD800) << 10) + (*low - 0xDC00);
+            pos += 6;
+          }
+        }
+        AppendUtf8(value, *code);
+        break;
+      }
+      default: value.push_back(text[pos]); break;  // '"', '\\' and '/'
+    }
+  }
+  return std::nullopt;
+}
+
+/// Adds the feature of a GeoJSON Feature object to the store. The members are looked up in the feature and its
+/// geometry and properties objects only, not in the objects nested in them.
+/// @return false if the object is not a Point feature
+bool ParseGeoJsonFeature(const std::string_view object, rg_db::FeatureStore& store) {
+  const auto geometry = FindMember(object, "geometry");
+  if (FindMember(geometry, "type") != "\"Point\"") return false;
+  // Point coordinates: [longitude, latitude], extra positions (altitude) ignored.
+  const auto position = FindMember(geometry, "coordinates");
+  if (position.empty() || position[0] != '[') return false;
+  size_t pos = 0;
+  std::optional<int32_t> coordinates[2];
+  for (auto& coordinate : coordinates) {
+    pos = SkipSpaces(position, pos + 1);
+    const auto end = position.find_first_of(",] \t\r\n", pos);
+    if (end == std::string_view::npos) return false;
+    coordinate = rg_import::ParseDegreesE7(position.substr(pos, end - pos));
+    pos = SkipSpaces(position, end);
+    if (!coordinate || pos >= position.size()) return false;
+  }
+  const auto& [longitude, latitude] = coordinates;
+  if (!IsValidLocation(*latitude, *longitude)) return false;
+
+  std::string name;
+  if (const auto value = FindMember(FindMember(object, "properties"), "name"); !value.empty() && value[0] == '"') {
+    auto parsed = ParseJsonString(value, 0);
+    if (!parsed) return false;
+    name = std::move(*parsed);
+  }
+  store.Add(name, *latitude, *longitude);
+  return true;
+}
+
+rg_db::FeatureStore ImportGeoJson(const std::string_view text, const unsigned threads,
+                                  const rg_db::FeatureStore::Mode mode, size_t& skipped) {
+  const auto objects = FindGeoJsonFeatures(text);
+  const auto chunk_count = std::min(objects.size(), size_t{threads} * kChunksPerThread);
+  std::vector<rg_db::FeatureStore> parts(chunk_count, rg_db::FeatureStore(mode));
+  std::vector<size_t> part_skipped(parts.size(), 0);
+  ParallelFor(chunk_count, threads, [&](const size_t i) {
+    const auto from = objects.size() * i / chunk_count;
+    const auto to = objects.size() * (i + 1) / chunk_count;
+    parts[i].Reserve(to - from, 0);
+    for (auto object = from; object < to; ++object) {
+      if (!ParseGeoJsonFeature(objects[object], parts[i])) {
+        ++part_skipped[i];
+      }
+    }
+  });
+  for (const auto count : part_skipped) skipped += count;
+  return Concatenate(parts, mode);
+}
+}  // anonymous namespace
+
+std::optional<int32_t> rg_import::ParseDegreesE7(const std::string_view text) {
+  // Decimal mantissa, and its power of ten once in E7 units. Digits past 18 only move the exponent.
+  constexpr uint64_t kMantissaMax = 100000000000000000ULL;
+  size_t i = 0;
+  const bool negative = !text.empty() && text[0] == '-';
+  if (!text.empty() && (text[0] == '-' || text[0] == '+')) ++i;
+  uint64_t mantissa = 0;
+  int exponent = 7;
+  bool digits = false;
+  for (; i < text.size() && IsDigit(text[i]); ++i, digits = true) {
+    if (mantissa < kMantissaMax) {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+    } else {
+      ++exponent;
+    }
+  }
+  if (i < text.size() && text[i] == '.') {
+    for (++i; i < text.size() && IsDigit(text[i]); ++i, digits = true) {
+      if (mantissa < kMantissaMax) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+        --exponent;
+      }
+    }
+  }
+  if (!digits) return std::nullopt;
+  if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+    ++i;
+    const bool negative_exponent = i < text.size() && text[i] == '-';
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) ++i;
+    if (i >= text.size() || !IsDigit(text[i])) return std::nullopt;
+    int value = 0;
+    for (; i < text.size() && IsDigit(text[i]); ++i) {
+      value = std::min(value * 10 + (text[i] - '0'), 1000);
+    }
+    exponent += negative_exponent ? -value : value;
+  }
+  if (i != text.size()) return std::nullopt;
+
+  constexpr uint64_t kMax = std::numeric_limits<int32_t>::max();
+  uint64_t value = mantissa;
+  if (mantissa != 0 && exponent > 0) {
+    for (; exponent > 0; --exponent) {
+      if (value > kMax) return std::nullopt;
+      value *= 10;
+    }
+  } else if (exponent < 0) {
+    if (exponent < -19) {
+      value = 0;
+    } else {
+      uint64_t divisor = 1;
+      for (; exponent < 0; ++exponent) divisor *= 10;
+      const auto remainder = value % divisor;
+      value = value / divisor + (remainder >= divisor - remainder ? 1 : 0);
+    }
+  }
+  if (value > kMax) return std::nullopt;
+  return negative ? -static_cast<int32_t>(value) : static_cast<int32_t>(value);
+}
+
+std::optional<rg_db::FeatureStore> rg_import::ImportFeatures(const std::string& path, unsigned threads,
+                                                             const rg_db::FeatureStore::Mode mode) {
+  const auto start = std::chrono::steady_clock::now();
+  if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+  auto extension = std::filesystem::path(path).extension().string();
+  std::ranges::transform(extension, extension.begin(), [](const unsigned char c) { return std::tolower(c); });
+  const bool csv = extension == ".csv";
+  if (!csv && extension != ".geojson" && extension != ".json") {
+    spdlog::error("Unknown feature file format: {}, expecting .csv, .geojson or .json", path);
+    return std::nullopt;
+  }
+  const auto text = ReadFile(path);
+  if (!text) {
+    spdlog::error("Can't read the feature file {}", path);
+    return std::nullopt;
+  }
+  size_t skipped = 0;
+  auto store = csv ? ImportCsv(*text, threads, mode, skipped) : ImportGeoJson(*text, threads, mode, skipped);
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  spdlog::info("Imported {} {} features from {} in {} ms, {} threads, {} records skipped.", store.size(),
+               mode == rg_db::FeatureStore::Mode::kLazy ? "compact" : "protobuf", path, elapsed.count(), threads,
+               skipped);
+  return store;
+}
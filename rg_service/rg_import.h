@@ -0,0 +1,45 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "rg_service/rg_db.h"
+
+/************************
+ * Bulk import of feature datasets
+ *
+ * The file is read at once, cut into chunks at record boundaries, and the chunks are parsed by parallel
+ * threads into per-chunk feature stores, which are then moved in file order into the result. Records that do
+ * not parse are skipped and counted in the log.
+ *
+ * Formats, chosen by the file extension:
+ * - .csv: one feature per line: name, latitude, longitude. The name may be double-quoted, with "" for a quote,
+ *   but can't hold a line break. An optional header row names the columns, in any order: `name`, `latitude`
+ *   (or `lat`) and `longitude` (or `lon`, `lng`), in degrees; with an `_e7` suffix, the coordinates are
+ *   integer E7 units instead.
+ * - .geojson, .json: a FeatureCollection of Point features, the name read from the `name` property.
+ *   Feature boundaries are found by a sequential structural scan before the parallel parse.
+ ************************/
+namespace rg_import {
+
+/// Parses decimal degrees into E7 units, rounded half away from zero, without a floating-point step:
+/// [+-]digits[.digits][(e|E)[+-]digits].
+/// @return nullopt if the text is not entirely a number, or out of the int32 range once in E7 units
+std::optional<int32_t> ParseDegreesE7(std::string_view text);
+
+/// Loads the features of a CSV or GeoJSON file.
+/// @param path of the dataset
+/// @param threads parsing threads, 0 for one per hardware thread
+/// @param mode of the store: in lazy mode, no protobuf message is built
+/// @return nullopt if the file can't be read or its format is unknown
+std::optional<rg_db::FeatureStore> ImportFeatures(const std::string& path, unsigned threads = 0,
+                                                  rg_db::FeatureStore::Mode mode = rg_db::FeatureStore::Mode::kEager);
+
+}  // namespace rg_import
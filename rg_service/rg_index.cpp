@@ -0,0 +1,244 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <thread>
+
+#include "rg_service/rg_keys.h"
+#include "rg_service/rg_utils.h"
+
+namespace rg_index {
+
+namespace {
+constexpr int64_t kLatitudeMaxE7 = 900000000;
+constexpr int64_t kLongitudeMaxE7 = 1800000000;
+constexpr int64_t kLongitudeSpanE7 = 2 * kLongitudeMaxE7;
+// Length of one E7 unit of latitude, on the sphere of rg_utils::GetDistance().
+constexpr double kMetersPerE7 = 2 * std::numbers::pi * 6371000 / 360 / 10000000.0;
+// Beyond that latitude, the longitude span of a lookup is every longitude.
+constexpr double kPolarLatitudeE7 = 890000000;
+
+int64_t NormalizeLongitude(const int64_t longitude) {
+  return ((longitude + kLongitudeMaxE7) % kLongitudeSpanE7 + kLongitudeSpanE7) % kLongitudeSpanE7 - kLongitudeMaxE7;
+}
+
+int64_t CellSizeOf(const double radius_meters) {
+  if (radius_meters <= 0) return 1;
+  return std::clamp(static_cast<int64_t>(std::ceil(radius_meters / kMetersPerE7)), int64_t{1}, kLatitudeMaxE7);
+}
+}  // anonymous namespace
+
+FeatureIndex::FeatureIndex(const rg_db::FeatureStore& store, unsigned threads) : store_(&store) {
+  if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+  entries_.resize(store.size());
+  const auto slice_qty = std::min<size_t>(threads, std::max<size_t>(store.size(), 1));
+  const auto slice_begin = [this, slice_qty](const size_t slice) { return entries_.size() * slice / slice_qty; };
+  // Runs step(i) for every i in [0, count), one thread each.
+  const auto in_parallel = [](const size_t count, const auto& step) {
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < count; ++i) {
+      pool.emplace_back(step, i);
+    }
+    step(0);
+    for (auto& thread : pool) {
+      thread.join();
+    }
+  };
+  in_parallel(slice_qty, [&](const size_t slice) {
+    for (auto i = slice_begin(slice); i < slice_begin(slice + 1); ++i) {
+      entries_[i] = {rg_keys::MortonEncode(store.latitude(i), store.longitude(i)), static_cast<uint32_t>(i)};
+    }
+    std::sort(entries_.begin() + slice_begin(slice), entries_.begin() + slice_begin(slice + 1));
+  });
+  for (size_t width = 1; width < slice_qty; width *= 2) {
+    in_parallel((slice_qty + 2 * width - 1) / (2 * width), [&](const size_t pair) {
+      const auto first = pair * 2 * width;
+      if (first + width >= slice_qty) return;
+      std::inplace_merge(entries_.begin() + slice_begin(first), entries_.begin() + slice_begin(first + width),
+                         entries_.begin() + slice_begin(std::min(first + 2 * width, slice_qty)));
+    });
+  }
+}
+
+std::optional<size_t> FeatureIndex::Find(const routeguide::Point& location) const {
+  const auto key = rg_keys::MortonEncode(location);
+  const auto found = std::lower_bound(entries_.begin(), entries_.end(), std::pair<uint64_t, uint32_t>{key, 0});
+  if (found == entries_.end() || found->first != key) return std::nullopt;
+  return found->second;
+}
+
+Grid::Grid(const double radius_meters)
+    : radius_meters_(std::max(radius_meters, 0.0)), cell_size_(CellSizeOf(radius_meters)) {}
+
+Grid::Cell Grid::CellOf(const routeguide::Point& location) const {
+  const auto latitude = std::clamp<int64_t>(location.latitude(), -kLatitudeMaxE7, kLatitudeMaxE7);
+  const auto longitude = NormalizeLongitude(location.longitude());
+  return {(longitude + kLongitudeMaxE7) / cell_size_, (latitude + kLatitudeMaxE7) / cell_size_};
+}
+
+uint64_t Grid::KeyOf(const Cell cell) {
+  return rg_keys::Interleave({static_cast<uint32_t>(cell.x), static_cast<uint32_t>(cell.y)});
+}
+
+uint64_t Grid::KeyOf(const routeguide::Point& location) const {
+  return KeyOf(CellOf(location));
+}
+
+bool Grid::Near(const routeguide::Point& a, const routeguide::Point& b) const {
+  return radius_meters_ == 0 ? a == b : rg_utils::GetApproxDistance(a, b) <= radius_meters_;
+}
+
+bool Grid::CellsNear(const routeguide::Point& location, const int64_t max_cells, std::vector<uint64_t>& keys) const {
+  keys.clear();
+  if (radius_meters_ == 0) {
+    keys.push_back(KeyOf(location));
+    return true;
+  }
+  // Latitude: one cell is at least the radius, so the neighbour rows are enough.
+  const auto latitude = std::clamp<int64_t>(location.latitude(), -kLatitudeMaxE7, kLatitudeMaxE7);
+  const auto lat_lo = std::max(latitude - cell_size_, -kLatitudeMaxE7);
+  const auto lat_hi = std::min(latitude + cell_size_, kLatitudeMaxE7);
+  // Longitude: the radius spans 1/cos(latitude) more E7 units, widest at the row edge nearest to a pole.
+  const auto widest = static_cast<double>(std::max(-lat_lo, lat_hi));
+  const auto radius_e7 = radius_meters_ / kMetersPerE7;
+  auto lon_half_span = kLongitudeMaxE7;
+  if (widest < kPolarLatitudeE7) {
+    const auto cos_latitude = std::cos(widest / 10000000.0 * std::numbers::pi / 180);
+    lon_half_span = std::min(static_cast<int64_t>(std::ceil(radius_e7 / cos_latitude)) + 1, kLongitudeMaxE7);
+  }
+  const auto longitude = NormalizeLongitude(location.longitude());
+  const auto lon_cell_qty = (kLongitudeSpanE7 - 1) / cell_size_ + 1;
+  // The longitude span may cross the antimeridian: walk it in cells, wrapping the cell column around.
+  auto x_lo = (longitude - lon_half_span + kLongitudeMaxE7) / cell_size_;
+  auto x_hi = (longitude + lon_half_span + kLongitudeMaxE7) / cell_size_;
+  if (longitude - lon_half_span + kLongitudeMaxE7 < 0) --x_lo;  // floor of a negative offset
+  if (x_hi - x_lo + 1 >= lon_cell_qty) {
+    x_lo = 0;
+    x_hi = lon_cell_qty - 1;
+  }
+  const auto y_lo = (lat_lo + kLatitudeMaxE7) / cell_size_;
+  const auto y_hi = (lat_hi + kLatitudeMaxE7) / cell_size_;
+  if ((y_hi - y_lo + 1) * (x_hi - x_lo + 1) > max_cells) return false;
+  for (auto y = y_lo; y <= y_hi; ++y) {
+    for (auto x = x_lo; x <= x_hi; ++x) keys.push_back(KeyOf({(x % lon_cell_qty + lon_cell_qty) % lon_cell_qty, y}));
+  }
+  return true;
+}
+
+NoteIndex::NoteIndex(const double radius_meters) : grid_(radius_meters) {}
+
+void NoteIndex::Insert(const routeguide::RouteNote& note) {
+  cells_[grid_.KeyOf(note.location())].push_back(static_cast<uint32_t>(notes_.size()));
+  notes_.push_back(note);
+}
+
+std::vector<const routeguide::RouteNote*> NoteIndex::FindNear(const routeguide::Point& location) const {
+  std::vector<uint32_t> matches;
+  std::vector<uint64_t> keys;
+  if (grid_.CellsNear(location, static_cast<int64_t>(notes_.size()), keys)) {
+    for (const auto key : keys) {
+      const auto found = cells_.find(key);
+      if (found == cells_.end()) continue;
+      for (const auto index : found->second) {
+        if (grid_.Near(notes_[index].location(), location)) matches.push_back(index);
+      }
+    }
+    if (keys.size() > 1) std::sort(matches.begin(), matches.end());
+  } else {
+    // More cells to look up than notes (near the poles, or few notes): filtering every note is cheaper. The
+    // number of cells holding notes would not do: clustered notes fill few cells, and every lookup would
+    // filter all the notes.
+    for (uint32_t index = 0; index < notes_.size(); ++index) {
+      if (grid_.Near(notes_[index].location(), location)) matches.push_back(index);
+    }
+  }
+  std::vector<const routeguide::RouteNote*> notes;
+  notes.reserve(matches.size());
+  for (const auto index : matches) {
+    notes.push_back(&notes_[index]);
+  }
+  return notes;
+}
+
+InterestIndex::InterestIndex(const double radius_meters) : grid_(radius_meters) {}
+
+bool InterestIndex::Add(const Subscriber& subscriber, const routeguide::Point& location) {
+  auto& slots = streams_[subscriber.stream][subscriber.session];
+  const auto near = [&](const uint32_t slot) { return grid_.Near(interests_[slot].location, location); };
+  if (std::ranges::any_of(slots, near)) return false;
+  uint32_t slot = 0;
+  if (free_.empty()) {
+    slot = static_cast<uint32_t>(interests_.size());
+    interests_.push_back({subscriber, location});
+  } else {
+    slot = free_.back();
+    free_.pop_back();
+    interests_[slot] = {subscriber, location};
+  }
+  cells_[grid_.KeyOf(location)].push_back(slot);
+  slots.push_back(slot);
+  ++size_;
+  return true;
+}
+
+void InterestIndex::Release(const std::vector<uint32_t>& slots) {
+  for (const auto slot : slots) {
+    const auto cell = cells_.find(grid_.KeyOf(interests_[slot].location));
+    std::erase(cell->second, slot);
+    if (cell->second.empty()) cells_.erase(cell);
+    free_.push_back(slot);
+  }
+  size_ -= slots.size();
+}
+
+void InterestIndex::Remove(const Subscriber& subscriber) {
+  const auto stream = streams_.find(subscriber.stream);
+  if (stream == streams_.end()) return;
+  if (const auto session = stream->second.find(subscriber.session); session != stream->second.end()) {
+    Release(session->second);
+    stream->second.erase(session);
+  }
+  if (stream->second.empty()) streams_.erase(stream);
+}
+
+void InterestIndex::RemoveStream(void* stream) {
+  const auto found = streams_.find(stream);
+  if (found == streams_.end()) return;
+  for (const auto& [session, slots] : found->second) Release(slots);
+  streams_.erase(found);
+}
+
+std::vector<InterestIndex::Subscriber> InterestIndex::FindNear(const routeguide::Point& location) const {
+  std::vector<Subscriber> found;
+  std::vector<uint64_t> keys;
+  if (grid_.CellsNear(location, static_cast<int64_t>(size_), keys)) {
+    for (const auto key : keys) {
+      const auto cell = cells_.find(key);
+      if (cell == cells_.end()) continue;
+      for (const auto slot : cell->second) {
+        if (grid_.Near(interests_[slot].location, location)) found.push_back(interests_[slot].subscriber);
+      }
+    }
+  } else {
+    // Same trade-off as NoteIndex::FindNear(): fewer interests than cells, filter them all.
+    for (const auto& [stream, sessions] : streams_) {
+      for (const auto& [session, slots] : sessions) {
+        for (const auto slot : slots) {
+          if (grid_.Near(interests_[slot].location, location)) found.push_back(interests_[slot].subscriber);
+        }
+      }
+    }
+  }
+  // A subscriber with several interests near the location is found once.
+  std::ranges::sort(found);
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+  return found;
+}
+
+}  // namespace rg_index
@@ -0,0 +1,146 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rg_service/rg_db.h"
+#include "rg_service/route_guide_service.h"
+
+namespace rg_index {
+
+/// Location index of a feature store, for the point lookups of GetFeature and RecordRoute: a binary search
+/// over the Morton keys (rg_keys.h) of the features, instead of a scan of the store.
+/// The keys are sorted by slices on parallel threads, then the slices are merged pairwise, in parallel too.
+class FeatureIndex {
+ public:
+  FeatureIndex() = default;
+  /// @param store to index, must outlive the index and stay unchanged
+  /// @param threads sorting threads, 0 for one per hardware thread
+  explicit FeatureIndex(const rg_db::FeatureStore& store, unsigned threads = 0);
+
+  /// @return position in the store of its first feature at the location
+  std::optional<size_t> Find(const routeguide::Point& location) const;
+  const rg_db::FeatureStore& store() const { return *store_; }
+
+ private:
+  const rg_db::FeatureStore* store_ = nullptr;
+  std::vector<std::pair<uint64_t, uint32_t>> entries_;  ///< Morton key and store position, sorted
+};
+
+/// Square cells of a match radius over the world (in E7 latitude units), each keyed by the Morton code of its grid
+/// position (rg_keys.h), shared by the location indexes below. A lookup costs the cells around a location plus the
+/// locations in them, instead of a scan of every location. With a radius of 0, a location matches only the exact
+/// same one.
+class Grid {
+ public:
+  /// @param radius_meters match distance, 0 for exact location matches only
+  explicit Grid(double radius_meters);
+
+  /// @return key of the cell of the location
+  uint64_t KeyOf(const routeguide::Point& location) const;
+  /// @return true if the locations are within the radius of each other
+  bool Near(const routeguide::Point& a, const routeguide::Point& b) const;
+  /// Lists the cells that may hold a location within the radius of this one. Longitude cells get narrower towards
+  /// the poles, so the longitude span widens by 1/cos(latitude).
+  /// @param max_cells above it, nothing is listed: the caller filters every location instead
+  /// @param[out] keys of the cells
+  /// @return false if the cells are more than max_cells
+  bool CellsNear(const routeguide::Point& location, int64_t max_cells, std::vector<uint64_t>& keys) const;
+
+  double radius_meters() const { return radius_meters_; }
+
+ private:
+  struct Cell {
+    int64_t x;
+    int64_t y;
+  };
+  Cell CellOf(const routeguide::Point& location) const;
+  static uint64_t KeyOf(Cell cell);
+
+  const double radius_meters_;
+  const int64_t cell_size_;  ///< side of a cell, in E7 units
+};
+
+/// Grid index of the RouteChat notes received by a server, to find the notes near a location.
+///
+/// When the cells to look up are more than the notes held (near the poles, or with few notes), the lookup filters
+/// every note instead. With a radius of 0, a note matches only at the exact same location, which is the historical
+/// RouteChat behavior. Not thread-safe: the servers hold their mutex around every call.
+class NoteIndex {
+ public:
+  /// @param radius_meters match distance, 0 for exact location matches only
+  explicit NoteIndex(double radius_meters);
+
+  /// Stores a copy of the note.
+  void Insert(const routeguide::RouteNote& note);
+
+  /// @return stored notes within the radius of the location, in insertion order. The pointers stay valid
+  ///         for the lifetime of the index.
+  std::vector<const routeguide::RouteNote*> FindNear(const routeguide::Point& location) const;
+
+  size_t size() const { return notes_.size(); }
+  double radius_meters() const { return grid_.radius_meters(); }
+
+ private:
+  const Grid grid_;
+  std::deque<routeguide::RouteNote> notes_;  ///< deque: insertion keeps the addresses of the stored notes
+  std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;  ///< cell key to note indexes, ascending
+};
+
+/// Grid index of the locations the RouteChat sessions are interested in, to find the sessions to push a note to
+/// (--chat_push of the callback server) without a scan of every stream, session and location.
+///
+/// A subscriber is a session of a stream. Its interests are the locations it sent notes at, one per area of the
+/// radius, until the session closes or its stream ends. Not thread-safe, like NoteIndex.
+class InterestIndex {
+ public:
+  struct Subscriber {
+    void* stream;  ///< stream of the server holding the session, opaque
+    uint64_t session;
+
+    auto operator<=>(const Subscriber&) const = default;
+  };
+
+  /// @param radius_meters match distance, 0 for exact location matches only
+  explicit InterestIndex(double radius_meters);
+
+  /// Adds the location to the interests of the subscriber, unless one of them is already near it.
+  /// @return true if added: the first interest of the subscriber there
+  bool Add(const Subscriber& subscriber, const routeguide::Point& location);
+  /// Removes the interests of a session, once closed.
+  void Remove(const Subscriber& subscriber);
+  /// Removes the interests of every session of a stream, once it ends.
+  void RemoveStream(void* stream);
+
+  /// @return subscribers with an interest within the radius of the location, each once, ordered
+  std::vector<Subscriber> FindNear(const routeguide::Point& location) const;
+
+  /// @return interests held
+  size_t size() const { return size_; }
+
+ private:
+  struct Interest {
+    Subscriber subscriber;
+    routeguide::Point location;
+  };
+  void Release(const std::vector<uint32_t>& slots);
+
+  const Grid grid_;
+  std::vector<Interest> interests_;  ///< slots, the free ones listed in free_
+  std::vector<uint32_t> free_;
+  size_t size_ = 0;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;  ///< cell key to interest slots
+  /// Interest slots of every session of every stream
+  std::unordered_map<void*, std::unordered_map<uint64_t, std::vector<uint32_t>>> streams_;
+};
+
+}  // namespace rg_index
@@ -0,0 +1,461 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_interceptors.h"
+
+#include <google/protobuf/message.h>
+#include <grpcpp/alarm.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rg_interceptors {
+
+namespace {
+using grpc::experimental::InterceptionHookPoints;
+
+// Index of the method of "/package.Service/Method" in the RouteGuide methods, kRpcMethodsQty for the others.
+size_t MethodIndex(const std::string_view full_name) {
+  const auto name = full_name.substr(full_name.rfind('/') + 1);
+  size_t method = 0;
+  while (method < routeguide::kRpcMethodsQty &&
+         routeguide::ToString(static_cast<routeguide::RpcMethods>(method)) != name) {
+    ++method;
+  }
+  return method;
+}
+
+class MetricsInterceptor : public grpc::experimental::Interceptor {
+ public:
+  explicit MetricsInterceptor(const MetricsInterceptorFactory::MethodMetrics& metrics)
+      : metrics_(metrics), start_(std::chrono::steady_clock::now()) {
+    metrics_.in_flight->Increment();
+  }
+
+  ~MetricsInterceptor() override {
+    // An RPC cancelled before the service sent a status has no PRE_SEND_STATUS.
+    if (!done_) Done(grpc::StatusCode::CANCELLED);
+    metrics_.in_flight->Decrement();
+  }
+
+  void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+    if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::POST_RECV_MESSAGE)) {
+      // Null once the client closed its stream.
+      if (const auto* message = static_cast<const google::protobuf::Message*>(methods->GetRecvMessage())) {
+        metrics_.bytes_received->Add(message->ByteSizeLong());
+      }
+    }
+    if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_MESSAGE)) {
+      if (const auto* message = static_cast<const google::protobuf::Message*>(methods->GetSendMessage())) {
+        metrics_.bytes_sent->Add(message->ByteSizeLong());
+      } else if (const auto* buffer = methods->GetSerializedSendMessage()) {
+        metrics_.bytes_sent->Add(buffer->Length());
+      }
+    }
+    if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_STATUS)) {
+      Done(methods->GetSendStatus().error_code());
+    }
+    methods->Proceed();
+  }
+
+ private:
+  void Done(const grpc::StatusCode code) {
+    done_ = true;
+    const auto index = static_cast<size_t>(code);
+    metrics_.rpcs[index < metrics_.rpcs.size() ? index : static_cast<size_t>(grpc::StatusCode::UNKNOWN)]->Add();
+    metrics_.duration->Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count()));
+  }
+
+  const MetricsInterceptorFactory::MethodMetrics& metrics_;
+  const std::chrono::steady_clock::time_point start_;
+  bool done_ = false;
+};
+
+uint64_t NanosecondsSince(const std::chrono::steady_clock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+class SerializationMetricsInterceptor : public grpc::experimental::Interceptor {
+ public:
+  SerializationMetricsInterceptor(SerializationMetricsInterceptorFactory& factory,
+                                  const SerializationMetricsInterceptorFactory::MethodMetrics& metrics)
+      : factory_(factory), metrics_(metrics) {}
+
+  ~SerializationMetricsInterceptor() override {
+    metrics_.sent_messages->Record(sent_);
+    metrics_.received_messages->Record(received_);
+  }
+
+  // The sent and received counts are each touched by one direction only, concurrent batches don't share them.
+  void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+    if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_MESSAGE)) {
+      const auto start = std::chrono::steady_clock::now();
+      // Serializes the message now, gRPC sends that buffer.
+      if (const auto* buffer = methods->GetSerializedSendMessage()) {
+        metrics_.serialize_duration->Record(NanosecondsSince(start));
+        metrics_.sent_bytes->Record(buffer->Length());
+        ++sent_;
+      }
+    }
+    if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::POST_RECV_MESSAGE)) {
+      // Null at the end of the stream.
+      if (const auto* message = static_cast<const google::protobuf::Message*>(methods->GetRecvMessage())) {
+        metrics_.received_bytes->Record(message->ByteSizeLong());
+        ++received_;
+        if (factory_.SampleParse()) RecordParse(*message);
+      }
+    }
+    methods->Proceed();
+  }
+
+ private:
+  void RecordParse(const google::protobuf::Message& message) {
+    const auto wire = message.SerializeAsString();
+    const std::unique_ptr<google::protobuf::Message> copy(message.New());
+    const auto start = std::chrono::steady_clock::now();
+    if (copy->ParseFromString(wire)) metrics_.parse_duration->Record(NanosecondsSince(start));
+  }
+
+  SerializationMetricsInterceptorFactory& factory_;
+  const SerializationMetricsInterceptorFactory::MethodMetrics& metrics_;
+  uint64_t sent_ = 0;
+  uint64_t received_ = 0;
+};
+
+constexpr auto kInjectedMessage = "injected fault";
+
+// Uniform double in [0, 1).
+double Uniform(rg_random::Xoshiro256pp& engine) {
+  return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+}
+
+// Faults of one RPC, on the server or on the client side. The batches of a streaming RPC can be intercepted
+// concurrently, by a read and a write, so the generator is guarded.
+class FaultInterceptor : public grpc::experimental::Interceptor {
+ public:
+  FaultInterceptor(const MethodFaults& faults, const uint64_t seed, const bool server)
+      : faults_(faults), server_(server), engine_(seed) {
+    error_ = Uniform(engine_) < faults_.error_rate;
+  }
+
+  void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+    auto hooked = [methods](const InterceptionHookPoints point) { return methods->QueryInterceptionHookPoint(point); };
+    std::unique_lock lock(mu_);
+    std::chrono::nanoseconds delay{0};
+    const bool sends_metadata = hooked(InterceptionHookPoints::PRE_SEND_INITIAL_METADATA);
+    const bool sends_message = hooked(InterceptionHookPoints::PRE_SEND_MESSAGE);
+    if (server_) {
+      // The initial metadata goes with the first message or the status, unless the service sends it alone.
+      if (!started_ && (sends_metadata || sends_message || hooked(InterceptionHookPoints::PRE_SEND_STATUS))) {
+        started_ = true;
+        delay += faults_.delay.Draw(engine_);
+      }
+      if (sends_message) delay += Stall();
+      if (error_ && hooked(InterceptionHookPoints::PRE_SEND_STATUS)) {
+        methods->ModifySendStatus(grpc::Status(faults_.error_code, kInjectedMessage));
+      }
+    } else {
+      if (!started_ && sends_metadata) {
+        started_ = true;
+        delay += faults_.delay.Draw(engine_);
+      }
+      // No message is received at the end of the stream.
+      if (sends_message ||
+          (hooked(InterceptionHookPoints::POST_RECV_MESSAGE) && methods->GetRecvMessage() != nullptr)) {
+        delay += Stall();
+      }
+      if (error_ && hooked(InterceptionHookPoints::POST_RECV_STATUS)) {
+        *methods->GetRecvStatus() = grpc::Status(faults_.error_code, kInjectedMessage);
+      }
+    }
+    if (delay.count() <= 0) {
+      lock.unlock();
+      methods->Proceed();
+      return;
+    }
+    // The batch waits for Proceed(), so the RPC, and this interceptor, outlive the alarm. A fired alarm leaves the
+    // list before its batch proceeds, so a long stream only keeps its pending alarms. The lock, held through Set(),
+    // keeps the callback out until the alarm is set.
+    const auto alarm = alarms_.emplace(alarms_.end());
+    alarm->Set(std::chrono::system_clock::now() + delay, [this, methods, alarm](bool) {
+      std::list<grpc::Alarm> fired;
+      {
+        std::lock_guard fired_lock(mu_);
+        fired.splice(fired.end(), alarms_, alarm);
+      }
+      // The RPC can end from here on: only the alarm, destroyed on return, is touched.
+      methods->Proceed();
+    });
+  }
+
+ private:
+  std::chrono::nanoseconds Stall() {
+    if (faults_.stall_rate <= 0 || Uniform(engine_) >= faults_.stall_rate) return std::chrono::nanoseconds{0};
+    return faults_.stall.Draw(engine_);
+  }
+
+  const MethodFaults& faults_;
+  const bool server_;
+  std::mutex mu_;
+  rg_random::Xoshiro256pp engine_;
+  bool error_ = false;
+  bool started_ = false;
+  std::list<grpc::Alarm> alarms_;
+};
+
+// Seed of the generator of the RPC of the given rank.
+uint64_t RpcSeed(const uint64_t seed, const uint64_t rank) {
+  return seed ^ ((rank + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+std::vector<std::string_view> Split(std::string_view text, const char separator) {
+  std::vector<std::string_view> parts;
+  for (;;) {
+    const auto end = text.find(separator);
+    parts.push_back(text.substr(0, end));
+    if (end == std::string_view::npos) return parts;
+    text.remove_prefix(end + 1);
+  }
+}
+
+bool ParseNumber(const std::string_view text, double& value) {
+  const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return ec == std::errc{} && end == text.data() + text.size();
+}
+
+bool ParseRate(const std::string_view text, double& rate) {
+  return ParseNumber(text, rate) && rate >= 0 && rate <= 1;
+}
+
+// "<number><unit>", unit one of ns, us, ms, s.
+bool ParseDuration(const std::string_view text, std::chrono::nanoseconds& duration) {
+  const auto unit_start = text.find_first_not_of("0123456789.");
+  if (unit_start == 0 || unit_start == std::string_view::npos) return false;
+  double value = 0;
+  if (!ParseNumber(text.substr(0, unit_start), value)) return false;
+  const auto unit = text.substr(unit_start);
+  double scale = 0;
+  if (unit == "ns") {
+    scale = 1;
+  } else if (unit == "us") {
+    scale = 1e3;
+  } else if (unit == "ms") {
+    scale = 1e6;
+  } else if (unit == "s") {
+    scale = 1e9;
+  } else {
+    return false;
+  }
+  duration = std::chrono::nanoseconds(static_cast<int64_t>(value * scale));
+  return true;
+}
+
+bool ParseLatency(const std::string_view text, Latency& latency) {
+  const auto parts = Split(text, ':');
+  if (parts.size() == 1) {
+    latency.kind = Latency::Kind::kConstant;
+    return ParseDuration(parts[0], latency.a);
+  }
+  if (parts[0] == "uniform" && parts.size() == 3) {
+    latency.kind = Latency::Kind::kUniform;
+    return ParseDuration(parts[1], latency.a) && ParseDuration(parts[2], latency.b) && latency.a <= latency.b;
+  }
+  if (parts[0] == "exp" && parts.size() == 2) {
+    latency.kind = Latency::Kind::kExponential;
+    return ParseDuration(parts[1], latency.a);
+  }
+  if (parts[0] == "pareto" && parts.size() == 3) {
+    latency.kind = Latency::Kind::kPareto;
+    return ParseDuration(parts[1], latency.a) && ParseNumber(parts[2], latency.shape) && latency.shape > 0;
+  }
+  return false;
+}
+
+bool ParseStatusCode(const std::string_view name, grpc::StatusCode& code) {
+  for (int value = 0; value < static_cast<int>(MetricsInterceptorFactory::MethodMetrics::kCodeQty); ++value) {
+    if (rg_metrics::StatusCodeName(value) == name) {
+      code = static_cast<grpc::StatusCode>(value);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Parses the faults of one method entry into the methods it targets, only the faults it names.
+bool ParseMethodFaults(const std::string_view faults_text, FaultPlan& plan, const size_t first, const size_t last) {
+  for (const auto fault : Split(faults_text, ',')) {
+    const auto equal = fault.find('=');
+    if (equal == std::string_view::npos) return false;
+    const auto name = fault.substr(0, equal);
+    const auto value = fault.substr(equal + 1);
+    MethodFaults parsed;
+    if (name == "delay") {
+      if (!ParseLatency(value, parsed.delay)) return false;
+      for (auto method = first; method <= last; ++method) plan.methods[method].delay = parsed.delay;
+    } else if (name == "error") {
+      const auto colon = value.find(':');
+      if (!ParseRate(value.substr(0, colon), parsed.error_rate)) return false;
+      if (colon != std::string_view::npos && !ParseStatusCode(value.substr(colon + 1), parsed.error_code)) {
+        return false;
+      }
+      for (auto method = first; method <= last; ++method) {
+        plan.methods[method].error_rate = parsed.error_rate;
+        plan.methods[method].error_code = parsed.error_code;
+      }
+    } else if (name == "stall") {
+      const auto colon = value.find(':');
+      if (colon == std::string_view::npos || !ParseRate(value.substr(0, colon), parsed.stall_rate) ||
+          !ParseLatency(value.substr(colon + 1), parsed.stall)) {
+        return false;
+      }
+      for (auto method = first; method <= last; ++method) {
+        plan.methods[method].stall_rate = parsed.stall_rate;
+        plan.methods[method].stall = parsed.stall;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+}  // anonymous namespace
+
+MetricsInterceptorFactory::MetricsInterceptorFactory(rg_metrics::Registry& registry) {
+  for (size_t method = 0; method < methods_.size(); ++method) {
+    const std::string name(method < routeguide::kRpcMethodsQty
+                               ? routeguide::ToString(static_cast<routeguide::RpcMethods>(method))
+                               : "other");
+    auto& metrics = methods_[method];
+    metrics.in_flight = &registry.GetGauge("rg_server_in_flight", "Server RPCs in progress", {{"method", name}});
+    for (size_t code = 0; code < MethodMetrics::kCodeQty; ++code) {
+      metrics.rpcs[code] = &registry.GetCounter(
+          "rg_server_rpcs_total", "Server RPCs done, by method and status code",
+          {{"method", name}, {"code", std::string(rg_metrics::StatusCodeName(static_cast<int>(code)))}});
+    }
+    metrics.duration = &registry.GetHistogram("rg_server_rpc_duration_seconds",
+                                              "Server RPC duration, from its start to its status", 1e-9,
+                                              {{"method", name}});
+    metrics.bytes_received = &registry.GetCounter("rg_server_bytes_received_total",
+                                                  "Serialized bytes of the received requests", {{"method", name}});
+    metrics.bytes_sent = &registry.GetCounter("rg_server_bytes_sent_total", "Serialized bytes of the sent responses",
+                                              {{"method", name}});
+  }
+}
+
+grpc::experimental::Interceptor* MetricsInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* info) {
+  return new MetricsInterceptor(methods_[MethodIndex(info->method())]);
+}
+
+SerializationMetricsInterceptorFactory::SerializationMetricsInterceptorFactory(rg_metrics::Registry& registry,
+                                                                               const uint32_t parse_sample_every)
+    : parse_sample_every_(std::max<uint32_t>(parse_sample_every, 1)) {
+  for (size_t method = 0; method < methods_.size(); ++method) {
+    const std::string name(method < routeguide::kRpcMethodsQty
+                               ? routeguide::ToString(static_cast<routeguide::RpcMethods>(method))
+                               : "other");
+    auto& metrics = methods_[method];
+    metrics.sent_bytes = &registry.GetHistogram("rg_client_message_bytes", "Serialized size of the client messages",
+                                                1.0, {{"method", name}, {"direction", "sent"}});
+    metrics.received_bytes = &registry.GetHistogram(
+        "rg_client_message_bytes", "Serialized size of the client messages", 1.0,
+        {{"method", name}, {"direction", "received"}});
+    metrics.serialize_duration = &registry.GetHistogram(
+        "rg_client_serialize_duration_seconds", "Time spent serializing a sent message", 1e-9, {{"method", name}});
+    metrics.parse_duration = &registry.GetHistogram("rg_client_parse_duration_seconds",
+                                                    "Time spent parsing a received message, sampled", 1e-9,
+                                                    {{"method", name}});
+    metrics.sent_messages = &registry.GetHistogram("rg_client_messages_per_rpc", "Messages of a client RPC", 1.0,
+                                                   {{"method", name}, {"direction", "sent"}});
+    metrics.received_messages = &registry.GetHistogram("rg_client_messages_per_rpc", "Messages of a client RPC", 1.0,
+                                                       {{"method", name}, {"direction", "received"}});
+  }
+}
+
+grpc::experimental::Interceptor* SerializationMetricsInterceptorFactory::CreateClientInterceptor(
+    grpc::experimental::ClientRpcInfo* info) {
+  return new SerializationMetricsInterceptor(*this, methods_[MethodIndex(info->method())]);
+}
+
+std::chrono::nanoseconds Latency::Draw(rg_random::Xoshiro256pp& engine) const {
+  double nanoseconds = 0;
+  switch (kind) {
+    case Kind::kNone:
+      return std::chrono::nanoseconds{0};
+    case Kind::kConstant:
+      return a;
+    case Kind::kUniform:
+      nanoseconds = static_cast<double>(a.count()) + static_cast<double>((b - a).count()) * Uniform(engine);
+      break;
+    case Kind::kExponential:
+      nanoseconds = -static_cast<double>(a.count()) * std::log1p(-Uniform(engine));
+      break;
+    case Kind::kPareto:
+      nanoseconds = static_cast<double>(a.count()) / std::pow(1 - Uniform(engine), 1 / shape);
+      break;
+  }
+  return std::chrono::nanoseconds(static_cast<int64_t>(std::min(nanoseconds, 60e9)));
+}
+
+bool FaultPlan::Empty() const {
+  for (const auto& faults : methods) {
+    if (!faults.Empty()) return false;
+  }
+  return true;
+}
+
+bool ParseFaultPlan(const std::string_view spec, FaultPlan& plan) {
+  for (const auto entry : Split(spec, ';')) {
+    if (entry.empty()) continue;
+    if (entry.starts_with("seed=")) {
+      const auto seed = entry.substr(5);
+      if (const auto [end, ec] = std::from_chars(seed.data(), seed.data() + seed.size(), plan.seed);
+          ec == std::errc{} && end == seed.data() + seed.size()) {
+        continue;
+      }
+      spdlog::error("Invalid fault plan entry: {}", entry);
+      return false;
+    }
+    const auto colon = entry.find(':');
+    const auto name = entry.substr(0, colon);
+    const auto method = name == "*" ? 0 : MethodIndex("/" + std::string(name));
+    if (colon == std::string_view::npos || (name != "*" && method == routeguide::kRpcMethodsQty) ||
+        !ParseMethodFaults(entry.substr(colon + 1), plan, method,
+                           name == "*" ? routeguide::kRpcMethodsQty : method)) {
+      spdlog::error("Invalid fault plan entry: {}", entry);
+      return false;
+    }
+  }
+  return true;
+}
+
+grpc::experimental::Interceptor* FaultInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* info) {
+  const auto& faults = plan_.methods[MethodIndex(info->method())];
+  // No interceptor at all for the methods without faults.
+  if (faults.Empty()) return nullptr;
+  return new FaultInterceptor(faults, RpcSeed(plan_.seed, rpcs_.fetch_add(1, std::memory_order_relaxed)), true);
+}
+
+grpc::experimental::Interceptor* ClientFaultInterceptorFactory::CreateClientInterceptor(
+    grpc::experimental::ClientRpcInfo* info) {
+  const auto& faults = plan_.methods[MethodIndex(info->method())];
+  if (faults.Empty()) return nullptr;
+  return new FaultInterceptor(faults, RpcSeed(plan_.seed, rpcs_.fetch_add(1, std::memory_order_relaxed)), false);
+}
+
+}  // namespace rg_interceptors
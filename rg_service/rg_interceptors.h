@@ -0,0 +1,162 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <grpcpp/support/client_interceptor.h>
+#include <grpcpp/support/server_interceptor.h>
+#include <grpcpp/support/status.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "rg_service/rg_metrics.h"
+#include "rg_service/rg_random.h"
+#include "rg_service/route_guide_service.h"
+
+/************************
+ * gRPC interceptors of the RouteGuide servers and clients
+ *
+ * Server interceptors are installed with ServerBuilder::experimental().SetInterceptorCreators(), before
+ * BuildAndStart(), client interceptors with grpc::experimental::CreateCustomChannelWithInterceptors(). gRPC creates
+ * one interceptor per RPC from each factory, and runs it on every operation of the RPC, whatever the API (sync,
+ * callback), so the service implementations and the stubs stay unchanged.
+ ************************/
+namespace rg_interceptors {
+
+/// Counts the RPCs of the RouteGuide methods in the metrics registry: RPCs in flight, outcomes by status code,
+/// duration, and serialized bytes received and sent. RPCs of other methods are counted under method="other".
+/// The metrics are registered by the constructor, the interceptors only update them.
+class MetricsInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+ public:
+  explicit MetricsInterceptorFactory(rg_metrics::Registry& registry = rg_metrics::DefaultRegistry());
+
+  grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+  /// Metrics of one method.
+  struct MethodMetrics {
+    static constexpr size_t kCodeQty = 17;  ///< gRPC status codes, OK to UNAUTHENTICATED
+    rg_metrics::Gauge* in_flight = nullptr;
+    std::array<rg_metrics::Counter*, kCodeQty> rpcs{};
+    rg_metrics::Histogram* duration = nullptr;  ///< nanoseconds, exported in seconds
+    rg_metrics::Counter* bytes_received = nullptr;
+    rg_metrics::Counter* bytes_sent = nullptr;
+  };
+
+ private:
+  // Indexed by routeguide::RpcMethods, the last one for the other methods.
+  std::array<MethodMetrics, routeguide::kRpcMethodsQty + 1> methods_;
+};
+
+/// Records, per method, the serialized size of the messages sent and received, the time spent serializing the
+/// sent ones, and the messages per RPC, in histograms of the metrics registry. Opt-in, for the cost it adds:
+/// - the serialization gRPC does anyway is forced in the interceptor to time it, no extra copy
+/// - gRPC parses a received message before any client interception point, so the parse time is measured on a
+///   copy of one received message out of `parse_sample_every`, serialized again then parsed
+/// - the size of a received message is computed with ByteSizeLong()
+class SerializationMetricsInterceptorFactory : public grpc::experimental::ClientInterceptorFactoryInterface {
+ public:
+  explicit SerializationMetricsInterceptorFactory(rg_metrics::Registry& registry = rg_metrics::DefaultRegistry(),
+                                                  uint32_t parse_sample_every = 16);
+
+  grpc::experimental::Interceptor* CreateClientInterceptor(grpc::experimental::ClientRpcInfo* info) override;
+
+  /// Metrics of one method.
+  struct MethodMetrics {
+    rg_metrics::Histogram* sent_bytes = nullptr;
+    rg_metrics::Histogram* received_bytes = nullptr;
+    rg_metrics::Histogram* serialize_duration = nullptr;  ///< nanoseconds, exported in seconds
+    rg_metrics::Histogram* parse_duration = nullptr;  ///< nanoseconds, sampled
+    rg_metrics::Histogram* sent_messages = nullptr;  ///< per RPC
+    rg_metrics::Histogram* received_messages = nullptr;  ///< per RPC
+  };
+
+  /// @return true if the received message is to be parsed again for the parse time. Any thread.
+  bool SampleParse() {
+    return received_.fetch_add(1, std::memory_order_relaxed) % parse_sample_every_ == 0;
+  }
+
+ private:
+  // Indexed by routeguide::RpcMethods, the last one for the other methods.
+  std::array<MethodMetrics, routeguide::kRpcMethodsQty + 1> methods_;
+  const uint32_t parse_sample_every_;
+  std::atomic<uint64_t> received_{0};
+};
+
+/// Distribution of the injected delays. Draw() returns 0 for kNone.
+struct Latency {
+  enum class Kind { kNone, kConstant, kUniform, kExponential, kPareto };
+  Kind kind = Kind::kNone;
+  std::chrono::nanoseconds a{0};  ///< constant value, uniform minimum, exponential mean or Pareto minimum
+  std::chrono::nanoseconds b{0};  ///< uniform maximum
+  double shape = 0;  ///< Pareto shape: the lower, the heavier the tail. Draws are capped to one minute.
+
+  std::chrono::nanoseconds Draw(rg_random::Xoshiro256pp& engine) const;
+};
+
+/// Faults injected in the RPCs of one method.
+struct MethodFaults {
+  Latency delay;  ///< server: before the first response or the status, client: before the RPC starts
+  double error_rate = 0;  ///< ratio of the RPCs ending with error_code instead of their status
+  grpc::StatusCode error_code = grpc::StatusCode::UNAVAILABLE;
+  double stall_rate = 0;  ///< ratio of the streamed messages delayed by stall: server sent, client sent or received
+  Latency stall;
+
+  bool Empty() const { return delay.kind == Latency::Kind::kNone && error_rate <= 0 && stall_rate <= 0; }
+};
+
+/// Faults of the RouteGuide methods, the last entry for the other methods. The faults of an RPC are drawn from
+/// its own generator, seeded from the seed and the rank of the RPC, so a run issuing its RPCs in the same order
+/// gets the same faults.
+struct FaultPlan {
+  std::array<MethodFaults, routeguide::kRpcMethodsQty + 1> methods{};
+  uint64_t seed = 1;
+
+  bool Empty() const;
+};
+
+/// Parses a fault plan, entries separated by ';':
+/// - `<Method>:<fault>[,<fault>...]`, Method a RouteGuide method or `*` for all of them
+/// - `seed=<n>`
+///
+/// Faults: `delay=<latency>`, `error=<rate>[:<CODE>]` (UNAVAILABLE by default), `stall=<rate>:<latency>`.
+/// Latencies: `<d>` constant, `uniform:<d>:<d>`, `exp:<mean d>`, `pareto:<minimum d>:<shape>`, durations with a
+/// ns, us, ms or s unit. For example: "GetFeature:delay=exp:2ms,error=0.01;ListFeatures:stall=0.05:50ms".
+/// @param spec plan text
+/// @param[out] plan parsed plan, its methods without faults unchanged
+/// @return false on a syntax error, with an error logged
+bool ParseFaultPlan(std::string_view spec, FaultPlan& plan);
+
+/// Injects the server faults of a plan: the delay holds the first response (or the status) of the RPC, the
+/// error replaces the status sent by the service, and the stalls hold sent messages. The delays are timed by
+/// alarms, no thread is blocked.
+class FaultInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+ public:
+  explicit FaultInterceptorFactory(const FaultPlan& plan) : plan_(plan) {}
+
+  grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+ private:
+  const FaultPlan plan_;
+  std::atomic<uint64_t> rpcs_{0};
+};
+
+/// Injects the client faults of a plan: the delay holds the start of the RPC, the error replaces the status
+/// received from the server, and the stalls hold sent and received messages.
+class ClientFaultInterceptorFactory : public grpc::experimental::ClientInterceptorFactoryInterface {
+ public:
+  explicit ClientFaultInterceptorFactory(const FaultPlan& plan) : plan_(plan) {}
+
+  grpc::experimental::Interceptor* CreateClientInterceptor(grpc::experimental::ClientRpcInfo* info) override;
+
+ private:
+  const FaultPlan plan_;
+  std::atomic<uint64_t> rpcs_{0};
+};
+
+}  // namespace rg_interceptors
@@ -0,0 +1,159 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_keys.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rg_service/rg_utils.h"
+
+namespace rg_keys {
+
+namespace {
+// Aligned block of 2^level x 2^level cells.
+struct Block {
+  uint64_t x0;
+  uint64_t y0;
+  unsigned level;
+};
+
+uint64_t BlockKeyBase(const Block& block, const Curve curve) {
+  const GridCell corner{static_cast<uint32_t>(block.x0), static_cast<uint32_t>(block.y0)};
+  const uint64_t key = curve == Curve::kMorton ? Interleave(corner) : HilbertIndex(corner);
+  // The keys of an aligned block are one aligned run of 4^level values, on both curves.
+  return block.level == 32 ? 0 : key & ~((uint64_t{1} << (2 * block.level)) - 1);
+}
+
+KeyRange BlockRange(const Block& block, const Curve curve) {
+  const auto lo = BlockKeyBase(block, curve);
+  return {lo, block.level == 32 ? ~uint64_t{0} : lo + ((uint64_t{1} << (2 * block.level)) - 1)};
+}
+}  // anonymous namespace
+
+routeguide::Point MortonDecode(const uint64_t key) {
+  const auto cell = Deinterleave(key);
+  return rg_utils::MakePoint(LatitudeOf(cell), LongitudeOf(cell));
+}
+
+// Branch-free Hilbert index: a parallel prefix scan over the bit pairs computes the curve orientation of
+// every level at once (see "Hilbert curves in O(log(n)) time", rawrunprotected.com), widened to 32 bits.
+uint64_t HilbertIndex(const GridCell cell) {
+  const uint32_t x = cell.x;
+  const uint32_t y = cell.y;
+  uint32_t A, B, C, D;
+  {
+    const uint32_t a = x ^ y;
+    const uint32_t b = ~a;
+    const uint32_t c = ~(x | y);
+    const uint32_t d = x & ~y;
+    A = a | (b >> 1);
+    B = (a >> 1) ^ a;
+    C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+  }
+  for (const unsigned shift : {2U, 4U, 8U}) {
+    const uint32_t a = A;
+    const uint32_t b = B;
+    const uint32_t c = C;
+    const uint32_t d = D;
+    A = (a & (a >> shift)) ^ (b & (b >> shift));
+    B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+    C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+    D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+  }
+  {
+    const uint32_t a = A;
+    const uint32_t b = B;
+    const uint32_t c = C;
+    const uint32_t d = D;
+    C ^= (a & (c >> 16)) ^ (b & (d >> 16));
+    D ^= (b & (c >> 16)) ^ ((a ^ b) & (d >> 16));
+  }
+  const uint32_t a = C ^ (C >> 1);
+  const uint32_t b = D ^ (D >> 1);
+  const uint32_t i0 = x ^ y;
+  const uint32_t i1 = b | ~(i0 | a);
+  return (Interleave({i1, 0}) << 1) | Interleave({i0, 0});
+}
+
+// Walks the curve from the finest level up, undoing the quadrant rotation of each level.
+GridCell HilbertCell(const uint64_t index) {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint64_t t = index;
+  for (uint64_t s = 1; s <= (uint64_t{1} << 31); s <<= 1) {
+    const uint32_t rx = 1 & static_cast<uint32_t>(t >> 1);
+    const uint32_t ry = 1 & static_cast<uint32_t>(t ^ rx);
+    if (ry == 0) {
+      if (rx == 1) {
+        x = static_cast<uint32_t>(s - 1 - x);
+        y = static_cast<uint32_t>(s - 1 - y);
+      }
+      std::swap(x, y);
+    }
+    x += static_cast<uint32_t>(s * rx);
+    y += static_cast<uint32_t>(s * ry);
+    t >>= 2;
+  }
+  return {x, y};
+}
+
+routeguide::Point HilbertDecode(const uint64_t key) {
+  const auto cell = HilbertCell(key);
+  return rg_utils::MakePoint(LatitudeOf(cell), LongitudeOf(cell));
+}
+
+// Breadth-first quadtree descent: blocks inside the rectangle become ranges, blocks across its edge are split
+// while the worst case of a split (4 blocks) still fits in max_ranges, and covered whole otherwise.
+std::vector<KeyRange> DecomposeRectangle(const routeguide::Rectangle& rectangle, const Curve curve,
+                                         const size_t max_ranges) {
+  const auto lo = ToGridCell(std::min(rectangle.lo().latitude(), rectangle.hi().latitude()),
+                             std::min(rectangle.lo().longitude(), rectangle.hi().longitude()));
+  const auto hi = ToGridCell(std::max(rectangle.lo().latitude(), rectangle.hi().latitude()),
+                             std::max(rectangle.lo().longitude(), rectangle.hi().longitude()));
+  const auto budget = std::max<size_t>(max_ranges, 1);
+  std::vector<KeyRange> ranges;
+  std::vector<Block> partial{{0, 0, 32}};
+  while (!partial.empty()) {
+    std::vector<Block> next;
+    for (size_t i = 0; i < partial.size(); ++i) {
+      const auto& block = partial[i];
+      // Every block still pending ends up as at most one range, so this bound holds for the final result.
+      const size_t pending = partial.size() - i - 1;
+      if (block.level == 0 || ranges.size() + next.size() + pending + 4 > budget) {
+        ranges.push_back(BlockRange(block, curve));
+        continue;
+      }
+      const unsigned level = block.level - 1;
+      const uint64_t half = uint64_t{1} << level;
+      for (const auto& [dx, dy] : {std::pair{0U, 0U}, {1U, 0U}, {0U, 1U}, {1U, 1U}}) {
+        const Block child{block.x0 + dx * half, block.y0 + dy * half, level};
+        const uint64_t x1 = child.x0 + half - 1;
+        const uint64_t y1 = child.y0 + half - 1;
+        if (x1 < lo.x || child.x0 > hi.x || y1 < lo.y || child.y0 > hi.y) continue;
+        if (child.x0 >= lo.x && x1 <= hi.x && child.y0 >= lo.y && y1 <= hi.y) {
+          ranges.push_back(BlockRange(child, curve));
+        } else {
+          next.push_back(child);
+        }
+      }
+    }
+    partial = std::move(next);
+  }
+
+  std::sort(ranges.begin(), ranges.end(), [](const KeyRange& a, const KeyRange& b) { return a.lo < b.lo; });
+  std::vector<KeyRange> merged;
+  for (const auto& range : ranges) {
+    if (!merged.empty() && merged.back().hi != ~uint64_t{0} && merged.back().hi + 1 >= range.lo) {
+      merged.back().hi = std::max(merged.back().hi, range.hi);
+    } else {
+      merged.push_back(range);
+    }
+  }
+  return merged;
+}
+
+}  // namespace rg_keys
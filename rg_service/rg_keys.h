@@ -0,0 +1,135 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rg_service/route_guide_service.h"
+
+/************************
+ * Spatial keys of E7 coordinates
+ *
+ * A point is mapped to a 32x32-bit grid cell without loss: each int32 coordinate is biased by 2^31, which keeps
+ * its order (x from the longitude, y from the latitude). The cell is then packed into one 64-bit key along a
+ * space-filling curve:
+ * - Morton (Z-order): bit interleave, the cheapest; BMI2 pdep/pext when compiled with it (RG_SERVICE_BMI2).
+ * - Hilbert: no jumps between far apart cells, so rectangles split into fewer key ranges; costs a few more
+ *   instructions (branch-free O(log n) prefix scan).
+ * Both keys are lossless: the key of a point is unique, decodes back to the point, and compares, hashes
+ * and sorts as one integer. Nearby points share key prefixes, which is what spatial indexes build upon.
+ ************************/
+namespace rg_keys {
+
+/// Cell of the 2^32 x 2^32 grid holding a point.
+struct GridCell {
+  uint32_t x;  ///< biased longitude
+  uint32_t y;  ///< biased latitude
+};
+
+constexpr GridCell ToGridCell(const int32_t latitude, const int32_t longitude) {
+  return {static_cast<uint32_t>(longitude) ^ 0x80000000U, static_cast<uint32_t>(latitude) ^ 0x80000000U};
+}
+constexpr int32_t LatitudeOf(const GridCell cell) { return static_cast<int32_t>(cell.y ^ 0x80000000U); }
+constexpr int32_t LongitudeOf(const GridCell cell) { return static_cast<int32_t>(cell.x ^ 0x80000000U); }
+
+inline constexpr uint64_t kEvenBits = 0x5555555555555555ULL;
+
+/// Interleaves the bits of x (even positions) and y (odd positions).
+inline uint64_t Interleave(const GridCell cell) {
+#if defined(__BMI2__)
+  return _pdep_u64(cell.x, kEvenBits) | _pdep_u64(cell.y, kEvenBits << 1);
+#else
+  const auto spread = [](uint64_t v) {
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    return (v | (v << 1)) & kEvenBits;
+  };
+  return spread(cell.x) | (spread(cell.y) << 1);
+#endif
+}
+
+/// Inverse of Interleave().
+inline GridCell Deinterleave(const uint64_t code) {
+#if defined(__BMI2__)
+  return {static_cast<uint32_t>(_pext_u64(code, kEvenBits)), static_cast<uint32_t>(_pext_u64(code, kEvenBits << 1))};
+#else
+  const auto compact = [](uint64_t v) {
+    v &= kEvenBits;
+    v = (v | (v >> 1)) & 0x3333333333333333ULL;
+    v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v >> 4)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v >> 8)) & 0x0000FFFF0000FFFFULL;
+    return static_cast<uint32_t>(v | (v >> 16));
+  };
+  return {compact(code), compact(code >> 1)};
+#endif
+}
+
+/// Morton key of a point.
+inline uint64_t MortonEncode(const int32_t latitude, const int32_t longitude) {
+  return Interleave(ToGridCell(latitude, longitude));
+}
+inline uint64_t MortonEncode(const routeguide::Point& point) {
+  return MortonEncode(point.latitude(), point.longitude());
+}
+/// Point of a Morton key.
+routeguide::Point MortonDecode(uint64_t key);
+
+/// Hilbert curve index of a grid cell.
+uint64_t HilbertIndex(GridCell cell);
+/// Inverse of HilbertIndex().
+GridCell HilbertCell(uint64_t index);
+
+/// Hilbert key of a point.
+inline uint64_t HilbertEncode(const int32_t latitude, const int32_t longitude) {
+  return HilbertIndex(ToGridCell(latitude, longitude));
+}
+inline uint64_t HilbertEncode(const routeguide::Point& point) {
+  return HilbertEncode(point.latitude(), point.longitude());
+}
+/// Point of a Hilbert key.
+routeguide::Point HilbertDecode(uint64_t key);
+
+/// Space-filling curve a key is computed along.
+enum class Curve {
+  kMorton,
+  kHilbert,
+};
+
+/// Inclusive range of keys.
+struct KeyRange {
+  uint64_t lo;
+  uint64_t hi;
+};
+
+/// Splits a rectangle into sorted, disjoint key ranges. A point is inside the rectangle only if its key is
+/// inside one of the ranges. With `max_ranges` too low for an exact cover, the ranges cover some cells around
+/// the rectangle too, so callers filter the candidates with rg_utils::IsPointWithinRectangle().
+/// @param rectangle corners in any order, edges included
+/// @param curve of the keys to cover
+/// @param max_ranges upper bound of the result size, at least 1
+/// @return ranges ordered by lo
+std::vector<KeyRange> DecomposeRectangle(const routeguide::Rectangle& rectangle, Curve curve,
+                                         size_t max_ranges = 64);
+
+/// Hash of a point for unordered containers, from its Morton key mixed by a multiplicative hash. Pairs with
+/// routeguide::operator==(Point, Point) as the equality.
+struct PointHash {
+  size_t operator()(const routeguide::Point& point) const {
+    const uint64_t mixed = MortonEncode(point) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(mixed ^ (mixed >> 32));
+  }
+};
+
+}  // namespace rg_keys
@@ -0,0 +1,249 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_metrics.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+
+namespace rg_metrics {
+
+namespace {
+// Prometheus label values escape the backslash, the double quote and the line feed.
+std::string FormatLabels(const Labels& labels) {
+  std::string text;
+  for (const auto& [name, value] : labels) {
+    if (!text.empty()) text += ',';
+    text += name;
+    text += "=\"";
+    for (const char c : value) {
+      if (c == '\\' || c == '"') {
+        text += '\\';
+        text += c;
+      } else if (c == '\n') {
+        text += "\\n";
+      } else {
+        text += c;
+      }
+    }
+    text += '"';
+  }
+  return text;
+}
+
+// Joins the formatted labels of a metric with an extra one, in braces, or nothing without labels.
+std::string Braced(const std::string& labels, const std::string_view extra = {}) {
+  if (labels.empty() && extra.empty()) return {};
+  std::string text = "{" + labels;
+  if (!labels.empty() && !extra.empty()) text += ',';
+  text += extra;
+  text += '}';
+  return text;
+}
+
+bool SendAll(const int fd, std::string_view data) {
+  while (!data.empty()) {
+    const auto sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) continue;
+    if (sent <= 0) return false;
+    data.remove_prefix(static_cast<size_t>(sent));
+  }
+  return true;
+}
+}  // anonymous namespace
+
+uint64_t Counter::Value() const {
+  uint64_t total = 0;
+  for (const auto& shard : shards_) {
+    total += shard.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+int64_t Gauge::Value() const {
+  int64_t total = 0;
+  for (const auto& shard : shards_) {
+    total += shard.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+Histogram::Snapshot Histogram::Read() const {
+  Snapshot snapshot;
+  for (const auto& shard : shards_) {
+    for (size_t i = 0; i <= kBucketQty; ++i) {
+      snapshot.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+Registry::Family& Registry::GetFamily(const std::string_view name, const std::string_view help, const Type type,
+                                      const double scale) {
+  auto found = families_.find(name);
+  if (found == families_.end()) {
+    found = families_.emplace(std::string(name), Family{std::string(help), type, scale, {}, {}, {}}).first;
+  } else if (found->second.type != type) {
+    // A programming error: the export would mix two types under one name.
+    spdlog::error("Metric {} registered again with another type", name);
+  }
+  return found->second;
+}
+
+Counter& Registry::GetCounter(const std::string_view name, const std::string_view help, const Labels& labels) {
+  std::lock_guard lock(mu_);
+  auto& metric = GetFamily(name, help, Type::kCounter, 1.0).counters[FormatLabels(labels)];
+  if (!metric) metric = std::make_unique<Counter>();
+  return *metric;
+}
+
+Gauge& Registry::GetGauge(const std::string_view name, const std::string_view help, const Labels& labels) {
+  std::lock_guard lock(mu_);
+  auto& metric = GetFamily(name, help, Type::kGauge, 1.0).gauges[FormatLabels(labels)];
+  if (!metric) metric = std::make_unique<Gauge>();
+  return *metric;
+}
+
+Histogram& Registry::GetHistogram(const std::string_view name, const std::string_view help, const double scale,
+                                  const Labels& labels) {
+  std::lock_guard lock(mu_);
+  auto& metric = GetFamily(name, help, Type::kHistogram, scale).histograms[FormatLabels(labels)];
+  if (!metric) metric = std::make_unique<Histogram>();
+  return *metric;
+}
+
+std::string Registry::ExportText() const {
+  static constexpr const char* kTypeNames[] = {"counter", "gauge", "histogram"};
+  std::string text;
+  auto out = std::back_inserter(text);
+  std::lock_guard lock(mu_);
+  for (const auto& [name, family] : families_) {
+    fmt::format_to(out, "# HELP {} {}\n# TYPE {} {}\n", name, family.help, name,
+                   kTypeNames[static_cast<int>(family.type)]);
+    for (const auto& [labels, counter] : family.counters) {
+      fmt::format_to(out, "{}{} {}\n", name, Braced(labels), counter->Value());
+    }
+    for (const auto& [labels, gauge] : family.gauges) {
+      fmt::format_to(out, "{}{} {}\n", name, Braced(labels), gauge->Value());
+    }
+    for (const auto& [labels, histogram] : family.histograms) {
+      const auto snapshot = histogram->Read();
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < Histogram::kBucketQty; ++i) {
+        cumulative += snapshot.buckets[i];
+        const auto bound = static_cast<double>(uint64_t{1} << i) * family.scale;
+        fmt::format_to(out, "{}_bucket{} {}\n", name, Braced(labels, fmt::format("le=\"{}\"", bound)), cumulative);
+      }
+      cumulative += snapshot.buckets[Histogram::kBucketQty];
+      fmt::format_to(out, "{}_bucket{} {}\n", name, Braced(labels, "le=\"+Inf\""), cumulative);
+      fmt::format_to(out, "{}_sum{} {}\n", name, Braced(labels), static_cast<double>(snapshot.sum) * family.scale);
+      fmt::format_to(out, "{}_count{} {}\n", name, Braced(labels), cumulative);
+    }
+  }
+  return text;
+}
+
+Registry& DefaultRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+std::string_view StatusCodeName(const int code) {
+  static constexpr std::string_view kNames[] = {
+      "OK", "CANCELLED", "UNKNOWN", "INVALID_ARGUMENT", "DEADLINE_EXCEEDED", "NOT_FOUND", "ALREADY_EXISTS",
+      "PERMISSION_DENIED", "RESOURCE_EXHAUSTED", "FAILED_PRECONDITION", "ABORTED", "OUT_OF_RANGE", "UNIMPLEMENTED",
+      "INTERNAL", "UNAVAILABLE", "DATA_LOSS", "UNAUTHENTICATED"};
+  if (code >= 0 && code < static_cast<int>(std::size(kNames))) return kNames[code];
+  return "UNRECOGNIZED";
+}
+
+bool HttpExporter::Start(const uint32_t port) {
+  if (port > 65535) {
+    spdlog::error("Metrics: port {} out of range", port);
+    return false;
+  }
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0) {
+    spdlog::error("Metrics: socket() failed: {}", std::strerror(errno));
+    return false;
+  }
+  const int reuse = 1;
+  ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(static_cast<uint16_t>(port));
+  socklen_t length = sizeof(address);
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+      ::listen(listen_fd_, 16) != 0 ||
+      ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+    spdlog::error("Metrics: can't listen on port {}: {}", port, std::strerror(errno));
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+  port_ = ntohs(address.sin_port);
+  stopping_ = false;
+  thread_ = std::thread(&HttpExporter::Serve, this);
+  spdlog::info("Metrics exported on http://0.0.0.0:{}/metrics", port_);
+  return true;
+}
+
+void HttpExporter::Stop() {
+  stopping_ = true;
+  if (thread_.joinable()) thread_.join();
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+  }
+}
+
+void HttpExporter::Serve() {
+  while (!stopping_) {
+    // Wakes up regularly to notice Stop().
+    pollfd listening{listen_fd_, POLLIN, 0};
+    if (::poll(&listening, 1, 200) <= 0) continue;
+    const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) continue;
+    // A silent client must not stall the exporter.
+    const timeval timeout{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+      const auto received = ::recv(fd, buffer, sizeof(buffer), 0);
+      if (received <= 0) break;
+      request.append(buffer, static_cast<size_t>(received));
+    }
+    const std::string_view request_line(request.data(), std::min(request.find("\r\n"), request.size()));
+    std::string response;
+    if (request_line.starts_with("GET /metrics ") || request_line.starts_with("GET /metrics?")) {
+      const auto body = registry_.ExportText();
+      response = fmt::format(
+          "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: {}\r\n\r\n{}",
+          body.size(), body);
+    } else if (request_line.starts_with("GET ")) {
+      response = "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+    } else {
+      response = "HTTP/1.0 405 Method Not Allowed\r\nAllow: GET\r\nContent-Length: 0\r\n\r\n";
+    }
+    SendAll(fd, response);
+    ::close(fd);
+  }
+}
+
+}  // namespace rg_metrics
@@ -0,0 +1,175 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/************************
+ * Process metrics, exported in the Prometheus text format
+ *
+ * Every metric is sharded: a thread updates its own cache line with a relaxed atomic add, so an update costs a
+ * few nanoseconds and threads updating the same metric don't contend. Reading a metric sums the shards, which
+ * is only done by the export. The registry lock is only taken to register a metric and to export: hot paths
+ * register their metrics once and keep the returned reference, which stays valid for the process lifetime.
+ ************************/
+namespace rg_metrics {
+
+/// Shards per metric. Threads are spread over them round-robin, in the order they first update a metric.
+inline constexpr size_t kShardQty = 16;
+
+namespace internal {
+/// @return shard of the calling thread
+inline size_t ShardIndex() {
+  static std::atomic<size_t> next{0};
+  thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % kShardQty;
+  return index;
+}
+}  // namespace internal
+
+/// Monotonic counter.
+class Counter {
+ public:
+  void Add(const uint64_t value = 1) {
+    shards_[internal::ShardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+  }
+  uint64_t Value() const;
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Shard, kShardQty> shards_;
+};
+
+/// Up-and-down value, like a number of objects alive. Increments and decrements of one object may happen on
+/// different threads: the shards hold deltas, only their sum is meaningful.
+class Gauge {
+ public:
+  void Add(const int64_t delta) { shards_[internal::ShardIndex()].value.fetch_add(delta, std::memory_order_relaxed); }
+  void Increment() { Add(1); }
+  void Decrement() { Add(-1); }
+  /// Replaces the value. Only for gauges with a single writer: a concurrent Add() may be lost.
+  void Set(const int64_t value) { Add(value - Value()); }
+  int64_t Value() const;
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<int64_t> value{0};
+  };
+  std::array<Shard, kShardQty> shards_;
+};
+
+/// Distribution of integer values in power-of-two buckets: bucket i counts the values up to 2^i, above the
+/// previous bucket, as the `le` (less or equal) bound of a Prometheus bucket. The values are in a unit scaled at
+/// export, e.g. nanoseconds exported as seconds.
+class Histogram {
+ public:
+  static constexpr size_t kBucketQty = 40;  ///< up to 2^39 units, then the +Inf bucket
+
+  void Record(const uint64_t value) {
+    auto& shard = shards_[internal::ShardIndex()];
+    const auto bucket = std::min<size_t>(std::bit_width(value == 0 ? 0 : value - 1), kBucketQty);
+    shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  /// Summed shards: bucket counts (not cumulative, the last one is +Inf) and sum of the values.
+  struct Snapshot {
+    std::array<uint64_t, kBucketQty + 1> buckets{};
+    uint64_t sum = 0;
+  };
+  Snapshot Read() const;
+
+ private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, kBucketQty + 1> buckets{};
+    std::atomic<uint64_t> sum{0};
+  };
+  std::array<Shard, kShardQty> shards_;
+};
+
+/// Label name and value pairs of one metric of a family.
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+/// Named metric families. Registering the same name and labels again returns the same metric.
+class Registry {
+ public:
+  Counter& GetCounter(std::string_view name, std::string_view help, const Labels& labels = {});
+  Gauge& GetGauge(std::string_view name, std::string_view help, const Labels& labels = {});
+  /// @param scale multiplies the recorded values and bucket bounds at export, e.g. 1e-9 for nanoseconds
+  ///        recorded into a family in seconds
+  Histogram& GetHistogram(std::string_view name, std::string_view help, double scale = 1.0,
+                          const Labels& labels = {});
+
+  /// @return every metric, in the Prometheus text exposition format (version 0.0.4), families sorted by name
+  std::string ExportText() const;
+
+ private:
+  enum class Type { kCounter, kGauge, kHistogram };
+  struct Family {
+    std::string help;
+    Type type = Type::kCounter;
+    double scale = 1.0;
+    // Formatted labels (a="b",c="d" or empty) to metric: map nodes keep the metric addresses.
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+  };
+  Family& GetFamily(std::string_view name, std::string_view help, Type type, double scale);
+
+  mutable std::mutex mu_;
+  std::map<std::string, Family, std::less<>> families_;
+};
+
+/// @return process-wide registry, the one exported by the binaries
+Registry& DefaultRegistry();
+
+/// @return name of a gRPC status code, as used by the `code` labels: OK, CANCELLED, ... or UNRECOGNIZED
+std::string_view StatusCodeName(int code);
+
+/// Embedded HTTP/1.0 listener serving the registry: `GET /metrics` gets the Prometheus text of the metrics.
+/// One thread serves the connections one after the other, which is plenty for a scraper.
+class HttpExporter {
+ public:
+  explicit HttpExporter(const Registry& registry = DefaultRegistry()) : registry_(registry) {}
+  ~HttpExporter() { Stop(); }
+
+  HttpExporter(const HttpExporter&) = delete;
+  HttpExporter& operator=(const HttpExporter&) = delete;
+
+  /// Listens on the port of every IPv4 interface and starts the serving thread.
+  /// @param port TCP port, 0 for any free port
+  /// @return false if the port is out of range or can't be bound, logged
+  bool Start(uint32_t port);
+  /// Stops the serving thread and closes the listening socket. Idempotent.
+  void Stop();
+  /// @return bound port, useful when started on port 0
+  uint16_t port() const { return port_; }
+
+ private:
+  void Serve();
+
+  const Registry& registry_;
+  int listen_fd_ = -1;
+  uint16_t port_ = 0;
+  std::atomic_bool stopping_{false};
+  std::thread thread_;
+};
+
+}  // namespace rg_metrics
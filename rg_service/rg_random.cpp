@@ -0,0 +1,123 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_random.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace rg_random {
+
+namespace {
+// The seed, its generation and the next stream change together: an engine is never created from the
+// seed of one SetSeed() and the stream of another. global_generation is also read without the lock, by
+// the check of every draw.
+std::mutex seed_mu;
+uint64_t global_seed{static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())};  // seed_mu
+std::atomic_uint64_t global_generation{0};  // written under seed_mu
+uint64_t next_stream{0};  // guarded by seed_mu
+
+uint64_t SplitMix64(uint64_t& x) {
+  uint64_t z = (x += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+// Inclusive E7 range [lo, hi], drawn as an offset from lo. The range spans at most 2^32 values.
+int32_t UniformInRange(Xoshiro256pp& engine, const int32_t lo, const int32_t hi) {
+  const auto span = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo) + 1;
+  const auto offset = span > std::numeric_limits<uint32_t>::max() ? engine() >> 32
+                                                                   : UniformBelow(engine, static_cast<uint32_t>(span));
+  return static_cast<int32_t>(lo + static_cast<int64_t>(offset));
+}
+
+struct ThreadState {
+  uint64_t generation;
+  Xoshiro256pp engine;
+};
+thread_local std::unique_ptr<ThreadState> thread_state;
+}  // anonymous namespace
+
+Xoshiro256pp::Xoshiro256pp(uint64_t seed, const uint64_t stream) {
+  for (auto& word : state_) {
+    word = SplitMix64(seed);
+  }
+  for (uint64_t i = 0; i < stream; ++i) {
+    Jump();
+  }
+}
+
+void Xoshiro256pp::Jump() {
+  static constexpr std::array<uint64_t, 4> kJump{0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa,
+                                                 0x39abdc4529b1661c};
+  std::array<uint64_t, 4> jumped{};
+  for (const auto word : kJump) {
+    for (unsigned bit = 0; bit < 64; ++bit) {
+      if (word & (uint64_t{1} << bit)) {
+        for (size_t i = 0; i < jumped.size(); ++i) {
+          jumped[i] ^= state_[i];
+        }
+      }
+      (*this)();
+    }
+  }
+  state_ = jumped;
+}
+
+void SetSeed(const uint64_t seed) {
+  {
+    std::lock_guard lock(seed_mu);
+    global_seed = seed;
+    next_stream = 0;
+    ++global_generation;
+  }
+  thread_state.reset();
+}
+
+Xoshiro256pp& ThreadLocalEngine() {
+  // Reseeds lazily when SetSeed() ran since this thread's engine was created.
+  if (!thread_state || thread_state->generation != global_generation.load()) {
+    uint64_t generation = 0;
+    uint64_t seed = 0;
+    uint64_t stream = 0;
+    {
+      std::lock_guard lock(seed_mu);
+      generation = global_generation.load();
+      seed = global_seed;
+      stream = next_stream++;
+    }
+    // Out of the lock: the jumps to the stream take a few microseconds each.
+    thread_state = std::make_unique<ThreadState>(ThreadState{generation, Xoshiro256pp(seed, stream)});
+  }
+  return thread_state->engine;
+}
+
+void FillBelow(Xoshiro256pp& engine, std::span<uint32_t> out, const uint32_t bound) {
+  std::generate(out.begin(), out.end(), [&engine, bound] { return UniformBelow(engine, bound); });
+}
+
+void FillPoints(Xoshiro256pp& engine, const FeatureList& feature_list, std::span<const routeguide::Point*> out) {
+  const auto bound = static_cast<uint32_t>(feature_list.size());
+  std::generate(out.begin(), out.end(),
+                [&engine, &feature_list, bound] { return &feature_list[UniformBelow(engine, bound)].location(); });
+}
+
+void FillPointsInRectangle(Xoshiro256pp& engine, const routeguide::Rectangle& rectangle,
+                           std::span<routeguide::Point> out) {
+  const auto lat_lo = std::min(rectangle.lo().latitude(), rectangle.hi().latitude());
+  const auto lat_hi = std::max(rectangle.lo().latitude(), rectangle.hi().latitude());
+  const auto lon_lo = std::min(rectangle.lo().longitude(), rectangle.hi().longitude());
+  const auto lon_hi = std::max(rectangle.lo().longitude(), rectangle.hi().longitude());
+  for (auto& point : out) {
+    point.set_latitude(UniformInRange(engine, lat_lo, lat_hi));
+    point.set_longitude(UniformInRange(engine, lon_lo, lon_hi));
+  }
+}
+
+}  // namespace rg_random
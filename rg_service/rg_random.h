@@ -0,0 +1,87 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "rg_service/rg_utils.h"
+
+namespace rg_random {
+
+/// xoshiro256++ pseudo-random generator (Blackman & Vigna): 256 bits of state, period 2^256 - 1, a handful
+/// of instructions per 64-bit output. Satisfies UniformRandomBitGenerator, so it also plugs into the
+/// std:: distributions. Not thread-safe: use one instance per thread, see ThreadLocalEngine().
+class Xoshiro256pp {
+ public:
+  using result_type = uint64_t;
+
+  /// Seeds the state from one 64-bit value through splitmix64, then jumps `stream` times ahead.
+  /// Each stream is a 2^128-long slice of the sequence, so the streams of one seed never overlap.
+  /// @param seed same seed and stream give the same sequence on every run
+  /// @param stream index of the independent stream, e.g. a thread index
+  explicit Xoshiro256pp(uint64_t seed, uint64_t stream = 0);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    const uint64_t result = std::rotl(state_[0] + state_[3], 23) + state_[0];
+    const uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = std::rotl(state_[3], 45);
+    return result;
+  }
+
+  /// Advances the state by 2^128 outputs.
+  void Jump();
+
+ private:
+  std::array<uint64_t, 4> state_;
+};
+
+/// Uniform integer in [0, bound), without modulo bias (Lemire's multiply-shift method). The rejection loop
+/// almost never runs, so the cost is one multiplication per value. bound must not be 0.
+inline uint32_t UniformBelow(Xoshiro256pp& engine, const uint32_t bound) {
+  uint64_t product = (engine() >> 32) * bound;
+  if (auto low = static_cast<uint32_t>(product); low < bound) {
+    const uint32_t threshold = (0U - bound) % bound;
+    while (low < threshold) {
+      product = (engine() >> 32) * bound;
+      low = static_cast<uint32_t>(product);
+    }
+  }
+  return static_cast<uint32_t>(product >> 32);
+}
+
+/// Sets the seed of the thread-local engines. The calling thread's engine is reseeded immediately, other
+/// threads' engines on their next first use. Engine n (in order of first use) draws from stream n of the
+/// seed, so a run with the same seed and the same thread start order is reproducible.
+/// Without a call, the seed comes from the clock, as before.
+void SetSeed(uint64_t seed);
+
+/// @return engine owned by the calling thread, created on first use
+Xoshiro256pp& ThreadLocalEngine();
+
+/// Fills `out` with uniform integers in [0, bound). bound must not be 0.
+void FillBelow(Xoshiro256pp& engine, std::span<uint32_t> out, uint32_t bound);
+
+/// Fills `out` with the locations of uniformly drawn features, without copying them.
+/// feature_list must not be empty, and must outlive the pointers.
+void FillPoints(Xoshiro256pp& engine, const FeatureList& feature_list, std::span<const routeguide::Point*> out);
+
+/// Fills `out` with points uniformly drawn inside the rectangle, corners included.
+void FillPointsInRectangle(Xoshiro256pp& engine, const routeguide::Rectangle& rectangle,
+                           std::span<routeguide::Point> out);
+
+}  // namespace rg_random
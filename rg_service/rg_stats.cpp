@@ -0,0 +1,76 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#include "rg_service/rg_stats.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace rg_stats {
+
+// Values below kSubBuckets get one bucket each. Above that, the most significant bit selects the power of
+// two and the next kSubBucketBits bits select the linear sub-bucket within it.
+size_t LatencyHistogram::BucketIndex(const uint64_t value) {
+  if (value < kSubBuckets) return static_cast<size_t>(value);
+  const unsigned msb = std::bit_width(value) - 1;
+  const unsigned shift = msb - kSubBucketBits;
+  const auto sub_bucket = static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+  return kSubBuckets + static_cast<size_t>(shift) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(const size_t index) {
+  if (index < kSubBuckets) return index;
+  const auto shift = static_cast<unsigned>((index - kSubBuckets) / kSubBuckets);
+  const uint64_t sub_bucket = (index - kSubBuckets) % kSubBuckets;
+  const uint64_t lower = (kSubBuckets + sub_bucket) << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::Record(const uint64_t value_ns) {
+  ++buckets_[BucketIndex(value_ns)];
+  ++count_;
+  sum_ += value_ns;
+  min_ = std::min(min_, value_ns);
+  max_ = std::max(max_, value_ns);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < kBucketQty; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Reset() {
+  *this = LatencyHistogram{};
+}
+
+uint64_t LatencyHistogram::Percentile(const double percentile) const {
+  if (count_ == 0) return 0;
+  const auto clamped = std::clamp(percentile, 0.0, 100.0);
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count_)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketQty; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) return std::min(BucketUpperBound(i), max_);
+  }
+  return max_;
+}
+
+void LogSummary(spdlog::logger& logger, const std::string_view label, const LatencyHistogram& histogram) {
+  constexpr auto to_us = [](const uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+  logger.info("{}: n={} mean={:.1f}us p50={:.1f}us p90={:.1f}us p99={:.1f}us p99.9={:.1f}us max={:.1f}us", label,
+              histogram.Count(), histogram.Mean() / 1000.0, to_us(histogram.Percentile(50)),
+              to_us(histogram.Percentile(90)), to_us(histogram.Percentile(99)), to_us(histogram.Percentile(99.9)),
+              to_us(histogram.Max()));
+}
+
+}  // namespace rg_stats
@@ -0,0 +1,67 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+
+#pragma once
+
+#include <spdlog/logger.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace rg_stats {
+
+/// Fixed-size, log-linear latency histogram (8 linear sub-buckets per power of two, so every recorded
+/// value is kept within 12.5% of its true value). Recording is allocation-free and branch-light, so one
+/// instance per thread can sit on a hot path; per-thread instances are combined afterwards with Merge().
+/// Not thread-safe: each instance must be owned by one thread at a time.
+class LatencyHistogram {
+ public:
+  static constexpr unsigned kSubBucketBits = 3;
+  static constexpr unsigned kSubBuckets = 1U << kSubBucketBits;
+  static constexpr size_t kBucketQty = kSubBuckets + (64 - kSubBucketBits) * kSubBuckets;
+
+  /// Records one sample, in nanoseconds.
+  void Record(uint64_t value_ns);
+  /// Records one sample from a std::chrono duration.
+  template <class Rep, class Period>
+  void Record(const std::chrono::duration<Rep, Period> elapsed) {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    Record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+  }
+
+  /// Adds every sample of another histogram to this one.
+  void Merge(const LatencyHistogram& other);
+  /// Drops every recorded sample.
+  void Reset();
+
+  uint64_t Count() const { return count_; }
+  uint64_t Min() const { return count_ ? min_ : 0; }
+  uint64_t Max() const { return max_; }
+  double Mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+  /// Value at the given percentile, in nanoseconds.
+  /// @param percentile in the range [0, 100]
+  /// @return upper bound of the bucket holding that percentile, clamped to the recorded maximum
+  uint64_t Percentile(double percentile) const;
+
+ private:
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketUpperBound(size_t index);
+
+  std::array<uint64_t, kBucketQty> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+
+/// Logs a one-line summary of a histogram: sample count, mean and the usual percentiles, in microseconds.
+/// @param logger where the summary is written
+/// @param label prefix identifying what was measured
+/// @param histogram samples to summarize
+void LogSummary(spdlog::logger& logger, std::string_view label, const LatencyHistogram& histogram);
+
+}  // namespace rg_stats
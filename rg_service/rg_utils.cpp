@@ -6,14 +6,18 @@
 #include "rg_service/rg_utils.h"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <numbers>
-#include <random>
 #include <string_view>
 
 #include "generated/route_guide.grpc.pb.h"
 
+#include "rg_service/rg_random.h"
+
 using routeguide::Feature;
 using routeguide::Point;
 using routeguide::Rectangle;
@@ -73,6 +77,49 @@ double rg_utils::GetDistance(const Point& start, const Point& end) {
   return kR * c;
 }
 
+namespace {
+constexpr double kEarthRadius = 6371000;   // the mean radius of the Earth, meters, same as GetDistance()
+constexpr double kRadianPerE7 = std::numbers::pi / 180 / 10000000.0;
+constexpr int32_t kCosStepE7 = 1000000;    // 0.1 degree between two entries of the cos(latitude) table
+constexpr int32_t kCosOriginE7 = -900000000;
+constexpr size_t kCosQty = 1800 + 2;       // -90 to 90 degrees, plus one entry so interpolation never overruns
+// Linear interpolation error between table entries, relative to cos(latitude): step^2 / 8.
+constexpr double kCosTableError = (kCosStepE7 * kRadianPerE7) * (kCosStepE7 * kRadianPerE7) / 8;
+
+const std::array<double, kCosQty>& CosTable() {
+  static const auto table = [] {
+    std::array<double, kCosQty> cosines{};
+    for (size_t i = 0; i < kCosQty; ++i) {
+      cosines[i] = std::cos((kCosOriginE7 + static_cast<double>(i) * kCosStepE7) * kRadianPerE7);
+    }
+    return cosines;
+  }();
+  return table;
+}
+
+// latitude_e7 must be within [-90, 90] degrees.
+double CosLatitude(const int64_t latitude_e7) {
+  const auto& table = CosTable();
+  const auto offset = latitude_e7 - kCosOriginE7;
+  const auto index = static_cast<size_t>(offset / kCosStepE7);
+  const auto fraction = static_cast<double>(offset % kCosStepE7) / kCosStepE7;
+  return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+}  // anonymous namespace
+
+double rg_utils::GetApproxDistance(const Point& start, const Point& end, const double tolerance) {
+  const auto delta_lat_e7 = static_cast<int64_t>(end.latitude()) - start.latitude();
+  const auto delta_lon_e7 = static_cast<int64_t>(end.longitude()) - start.longitude();
+  const auto span = static_cast<double>(std::max(std::abs(delta_lat_e7), std::abs(delta_lon_e7))) * kRadianPerE7;
+  const auto mid_lat_e7 = (static_cast<int64_t>(start.latitude()) + end.latitude()) / 2;
+  if (span * span / 4 + kCosTableError > tolerance || std::abs(mid_lat_e7) > 900000000) {
+    return GetDistance(start, end);
+  }
+  const auto x = static_cast<double>(delta_lon_e7) * kRadianPerE7 * CosLatitude(mid_lat_e7);
+  const auto y = static_cast<double>(delta_lat_e7) * kRadianPerE7;
+  return kEarthRadius * std::sqrt(x * x + y * y);
+}
+
 const char* rg_utils::GetFeatureName(const Point& point, const FeatureList& feature_list) {
   for (const Feature& f : feature_list) {
     if (f.location().latitude() == point.latitude() &&
@@ -83,6 +130,11 @@ const char* rg_utils::GetFeatureName(const Point& point, const FeatureList& feat
   return nullptr;
 }
 
+const char* rg_utils::GetFeatureName(const Point& point, const rg_index::FeatureIndex& feature_index) {
+  const auto found = feature_index.Find(point);
+  return found ? feature_index.store().name(*found).data() : nullptr;
+}
+
 bool rg_utils::IsPointWithinRectangle(const Rectangle& rectangle, const Point& point) {
   const auto left = std::min(rectangle.lo().longitude(), rectangle.hi().longitude());
   const auto right = std::max(rectangle.lo().longitude(), rectangle.hi().longitude());
@@ -103,18 +155,26 @@ Feature rg_utils::GetFeatureFromPoint(const FeatureList& feature_list, const Poi
   return feature;
 }
 
+Feature rg_utils::GetFeatureFromPoint(const rg_index::FeatureIndex& feature_index, const Point& point) {
+  Feature feature;
+  if (const auto name = GetFeatureName(point, feature_index)) {
+    if (strlen(name) > 0) {
+      feature.set_name(name);
+    }
+    *feature.mutable_location() = point;
+  }
+  return feature;
+}
+
+// Thread-safe: each thread draws from its own engine, see rg_random::ThreadLocalEngine().
 const Point& rg_utils::GetRandomPoint(const FeatureList& feature_list) {
-  static unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-  static std::default_random_engine generator(seed);
-  std::uniform_int_distribution<unsigned> feature_distribution(0, feature_list.size() - 1);
-  return feature_list[feature_distribution(generator)].location();
+  const auto size = static_cast<uint32_t>(feature_list.size());
+  return feature_list[rg_random::UniformBelow(rg_random::ThreadLocalEngine(), size)].location();
 }
 
+// Uniform in [500, 1500] milliseconds.
 unsigned rg_utils::GetRandomTimeDelay() {
-  static unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-  static std::default_random_engine generator(seed);
-  static std::uniform_int_distribution<unsigned> delay_distribution(500, 1500);
-  return delay_distribution(generator);
+  return 500 + rg_random::UniformBelow(rg_random::ThreadLocalEngine(), 1001);
 }
 
 bool routeguide::operator==(const Point& point1, const Point& point2) {
@@ -8,6 +8,7 @@
 #include <string_view>
 #include <vector>
 
+#include "rg_service/rg_index.h"
 #include "rg_service/route_guide_service.h"
 
 using FeatureList = std::vector<routeguide::Feature>;
@@ -19,9 +20,24 @@ routeguide::Rectangle MakeRectangle(int32_t latitude_lo, int32_t longitude_lo,
 routeguide::Feature MakeFeature(std::string_view name, int32_t latitude, int32_t longitude);
 routeguide::RouteNote MakeRouteNote(std::string_view message, int32_t latitude, int32_t longitude);
 double GetDistance(const routeguide::Point& start, const routeguide::Point& end);
+
+/// Default relative error accepted by GetApproxDistance(): 0.001%, i.e. under 0.4 m on a 40 km segment.
+inline constexpr double kDistanceTolerance = 1e-5;
+
+/// Tiered distance between two points, in meters. Short segments use an equirectangular approximation
+/// with a cos(latitude) lookup table; the exact haversine of GetDistance() runs only when the error bound
+/// of the approximation is over `tolerance`.
+/// The bound covers both the projection (relative error under D^2/8, D the largest of the latitude and
+/// longitude spans in radians, worst near the poles; the check uses D^2/4 as margin) and the table
+/// interpolation. Antimeridian crossings always take the exact path.
+/// @param tolerance maximum relative error of the result, e.g. 1e-5 for 0.001%
+double GetApproxDistance(const routeguide::Point& start, const routeguide::Point& end,
+                         double tolerance = kDistanceTolerance);
 const char* GetFeatureName(const routeguide::Point& point, const FeatureList& feature_list);
+const char* GetFeatureName(const routeguide::Point& point, const rg_index::FeatureIndex& feature_index);
 bool IsPointWithinRectangle(const routeguide::Rectangle& rectangle, const routeguide::Point& point);
 routeguide::Feature GetFeatureFromPoint(const FeatureList& feature_list, const routeguide::Point& point);
+routeguide::Feature GetFeatureFromPoint(const rg_index::FeatureIndex& feature_index, const routeguide::Point& point);
 const routeguide::Point& GetRandomPoint(const FeatureList& feature_list);
 unsigned GetRandomTimeDelay();
 }  // namespace rg_utils
@@ -0,0 +1,150 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Thread Placement Tests
+///
+/// Tests the CPU lists and the isolation presets of rg_affinity.h against tables of inputs, then the sweep of
+/// Placement on the threads of the test process when it has enough CPUs.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rg_service/rg_affinity.h"
+
+namespace {
+
+using rg_affinity::CpuSet;
+using rg_affinity::Preset;
+
+/// @test Valid CPU lists parse into sorted sets without duplicates, and print back with their ranges merged.
+TEST(RgAffinityTest, ParseCpuList_ValidLists_Parsed) {
+  const struct {
+    const char* text;
+    CpuSet cpus;
+    const char* printed;
+  } kCases[] = {
+      {"", {}, ""},
+      {"0", {0}, "0"},
+      {"0-3", {0, 1, 2, 3}, "0-3"},
+      {"0-3,8,10-11", {0, 1, 2, 3, 8, 10, 11}, "0-3,8,10-11"},
+      {"5,1,3", {1, 3, 5}, "1,3,5"},
+      {"2-4,3-5,4", {2, 3, 4, 5}, "2-5"},
+      {"7-7", {7}, "7"},
+  };
+  for (const auto& test : kCases) {
+    CpuSet cpus{42};
+    EXPECT_TRUE(rg_affinity::ParseCpuList(test.text, cpus)) << test.text;
+    EXPECT_EQ(cpus, test.cpus) << test.text;
+    EXPECT_EQ(rg_affinity::ToString(cpus), test.printed) << test.text;
+  }
+}
+
+/// @test Invalid CPU lists are rejected and leave an empty set.
+TEST(RgAffinityTest, ParseCpuList_InvalidLists_Rejected) {
+  const std::string too_large = std::to_string(CPU_SETSIZE);
+  const std::string kCases[] = {
+      "a", "1,", ",1", "1,,2", " 1", "1 ", "-1", "1-", "3-1", "1-2-3", "0x1", too_large, "0-" + too_large,
+  };
+  for (const auto& text : kCases) {
+    CpuSet cpus{42};
+    EXPECT_FALSE(rg_affinity::ParseCpuList(text, cpus)) << text;
+    EXPECT_TRUE(cpus.empty()) << text;
+  }
+}
+
+/// @test The presets fill the empty sets from the allowed CPUs and keep the ones given explicitly.
+TEST(RgAffinityTest, ApplyPreset_Table_FillsEmptySets) {
+  const struct {
+    Preset preset;
+    CpuSet allowed;
+    CpuSet application;
+    CpuSet others;
+    CpuSet expected_application;
+    CpuSet expected_others;
+  } kCases[] = {
+      {Preset::kNone, {0, 1, 2, 3}, {}, {}, {}, {}},
+      {Preset::kIsolated, {}, {}, {}, {}, {}},
+      {Preset::kIsolated, {0, 1, 2, 3}, {}, {}, {3}, {0, 1, 2}},
+      {Preset::kIsolated, {2, 5}, {}, {}, {5}, {2}},
+      {Preset::kCompact, {0, 1, 2, 3}, {}, {}, {0}, {1}},
+      {Preset::kIsolated, {4}, {}, {}, {4}, {4}},
+      {Preset::kCompact, {4}, {}, {}, {4}, {4}},
+      {Preset::kIsolated, {0, 1, 2, 3}, {1}, {}, {1}, {0, 1, 2}},
+      {Preset::kCompact, {0, 1, 2, 3}, {}, {2, 3}, {0}, {2, 3}},
+      {Preset::kNone, {0, 1}, {1}, {0}, {1}, {0}},
+  };
+  for (size_t i = 0; i < std::size(kCases); ++i) {
+    const auto& test = kCases[i];
+    rg_affinity::PlacementOptions options;
+    options.application = test.application;
+    options.others = test.others;
+    const auto applied = rg_affinity::ApplyPreset(test.preset, test.allowed, options);
+    EXPECT_EQ(applied.application, test.expected_application) << "case " << i;
+    EXPECT_EQ(applied.others, test.expected_others) << "case " << i;
+  }
+}
+
+/// @test The sweep moves the threads still on the CPUs of the process, and leaves alone the application thread and
+/// the threads pinned by their owner.
+TEST(RgAffinityTest, Sweep_DefaultAndPinnedThreads_MovesDefaultOnly) {
+  const auto allowed = rg_affinity::AllowedCpus();
+  if (allowed.size() < 3) GTEST_SKIP() << "needs 3 CPUs, " << allowed.size() << " allowed";
+
+  std::atomic<pid_t> default_tid{0};
+  std::atomic<pid_t> pinned_tid{0};
+  std::atomic_bool done{false};
+  auto park = [&done](std::atomic<pid_t>& tid) {
+    tid = rg_affinity::ThreadId();
+    while (!done) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  };
+  std::thread default_thread(park, std::ref(default_tid));
+  std::thread pinned_thread([&] {
+    rg_affinity::PinThread(0, {allowed[1]});
+    park(pinned_tid);
+  });
+  while (default_tid == 0 || pinned_tid == 0) std::this_thread::yield();
+
+  {
+    rg_affinity::Placement placement;
+    rg_affinity::PlacementOptions options;
+    options.application = {allowed[0]};
+    options.others = {allowed[2]};
+    options.sweep_period = std::chrono::milliseconds(0);
+    EXPECT_TRUE(placement.Start(options));
+    // The test thread is the application thread: pinned by Start(), untouched by the sweeps.
+    EXPECT_EQ(rg_affinity::AllowedCpus(), options.application);
+    EXPECT_EQ(placement.Sweep(), 0u);
+  }
+
+  auto cpus_of = [](const pid_t tid) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CpuSet cpus;
+    if (::sched_getaffinity(tid, sizeof(set), &set) != 0) return cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+    return cpus;
+  };
+  EXPECT_EQ(cpus_of(default_tid), CpuSet{allowed[2]});
+  EXPECT_EQ(cpus_of(pinned_tid), CpuSet{allowed[1]});
+  done = true;
+  default_thread.join();
+  pinned_thread.join();
+  rg_affinity::PinThread(0, allowed);
+}
+
+}  // namespace
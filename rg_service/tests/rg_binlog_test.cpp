@@ -0,0 +1,112 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Binary Log Tests
+///
+/// Tests the ring files of rg_binlog.h end to end: records written by Format::Log() into the ring of the test
+/// thread are read back and rendered by ReadRing(), the decoder of rg_binlog_decode, including once the ring
+/// wrapped around, with records dropped, and from a corrupted file.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "protobuf_utils/protobuf_utils.h"
+#include "rg_service/rg_binlog.h"
+#include "rg_service/rg_utils.h"
+
+namespace {
+
+/// Opens the sink on the test temporary directory under a new name.
+/// @return ring file of the test thread once it logs
+std::string OpenSink(const std::string& name, const size_t ring_bytes = size_t{1} << 20) {
+  EXPECT_TRUE(rg_binlog::Open(::testing::TempDir(), name, ring_bytes));
+  return ::testing::TempDir() + name + "." + std::to_string(::getpid()) + "." +
+         std::to_string(::syscall(SYS_gettid)) + ".binlog";
+}
+
+/// @test Every argument type is written by Log() and rendered back by ReadRing(), messages included.
+TEST(RgBinlogTest, Log_EveryArgumentType_RoundTrips) {
+  static const rg_binlog::Format<bool, int, uint64_t, double, std::string_view, routeguide::Feature> kFormat(
+      "{} {} {} {} [{}] {}");
+  const auto path = OpenSink("rg_binlog_types");
+  const auto feature = rg_utils::MakeFeature("Tab\there", 407838351, -746143763);
+  kFormat.Log(true, -3, 7, 1.5, "text", feature);
+  rg_binlog::Close();
+
+  std::vector<rg_binlog::Record> records;
+  ASSERT_TRUE(rg_binlog::ReadRing(path, records));
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0].text, "true -3 7 1.5 [text] " + protobuf_utils::ToString(feature));
+  EXPECT_EQ(records[0].thread_id, static_cast<uint64_t>(::syscall(SYS_gettid)));
+  EXPECT_GT(records[0].time_ns, 0);
+}
+
+/// @test Once the ring wrapped around, the oldest records are overwritten and the newest ones read in order.
+TEST(RgBinlogTest, Log_RingWrapsAround_KeepsNewestInOrder) {
+  static const rg_binlog::Format<uint64_t> kFormat("record {}");
+  const auto path = OpenSink("rg_binlog_wrap", 4096);
+  constexpr uint64_t kRecords = 1000;  // 24 bytes each, several times the ring
+  for (uint64_t i = 0; i < kRecords; ++i) kFormat.Log(i);
+  rg_binlog::Close();
+
+  std::vector<rg_binlog::Record> records;
+  ASSERT_TRUE(rg_binlog::ReadRing(path, records));
+  ASSERT_FALSE(records.empty());
+  ASSERT_LT(records.size(), kRecords);
+  const auto first = kRecords - records.size();
+  for (size_t i = 0; i < records.size(); ++i) {
+    ASSERT_EQ(records[i].text, "record " + std::to_string(first + i));
+  }
+}
+
+/// @test A record larger than half the ring is dropped, and the records around it still read back.
+TEST(RgBinlogTest, Log_OversizedRecord_Dropped) {
+  static const rg_binlog::Format<std::string> kFormat("{}");
+  const auto path = OpenSink("rg_binlog_drop", 4096);
+  kFormat.Log("before");
+  kFormat.Log(std::string(4096, 'x'));
+  kFormat.Log("after");
+  rg_binlog::Close();
+
+  std::vector<rg_binlog::Record> records;
+  ASSERT_TRUE(rg_binlog::ReadRing(path, records));
+  ASSERT_EQ(records.size(), 2u);
+  EXPECT_EQ(records[0].text, "before");
+  EXPECT_EQ(records[1].text, "after");
+}
+
+/// @test A ring file whose record sizes are corrupted is rejected, as is a file that is not a ring.
+TEST(RgBinlogTest, ReadRing_CorruptedFile_Fails) {
+  static const rg_binlog::Format<uint64_t> kFormat("value {}");
+  const auto path = OpenSink("rg_binlog_corrupt", 4096);
+  kFormat.Log(1);
+  rg_binlog::Close();
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    const uint32_t size = 12;  // not a multiple of 8
+    file.seekp(static_cast<std::streamoff>(rg_binlog::kHeaderSize));
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  }
+  std::vector<rg_binlog::Record> records;
+  EXPECT_FALSE(rg_binlog::ReadRing(path, records));
+
+  const auto not_a_ring = ::testing::TempDir() + "rg_binlog_text.1.binlog";
+  std::ofstream(::testing::TempDir() + "rg_binlog_text.formats") << "1\tu\tvalue {}\n";
+  std::ofstream(not_a_ring) << "plain text";
+  EXPECT_FALSE(rg_binlog::ReadRing(not_a_ring, records));
+  EXPECT_TRUE(records.empty());
+}
+
+}  // namespace
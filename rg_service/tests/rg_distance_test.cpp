@@ -0,0 +1,80 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Approximate Distance Tests
+///
+/// Tests the tiered GetApproxDistance() of rg_utils.h against the exact haversine of GetDistance(): the relative
+/// error stays under the tolerance on short and long segments, at every latitude, and the segments the
+/// approximation can't bound take the exact path.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "rg_service/rg_random.h"
+#include "rg_service/rg_utils.h"
+
+namespace {
+
+constexpr int32_t kE7 = 10000000;
+
+/// Relative error of the approximation on a segment, 0 for a null segment.
+double RelativeError(const routeguide::Point& start, const routeguide::Point& end, const double tolerance) {
+  const double exact = rg_utils::GetDistance(start, end);
+  const double approx = rg_utils::GetApproxDistance(start, end, tolerance);
+  return exact == 0.0 ? std::abs(approx) : std::abs(approx - exact) / exact;
+}
+
+/// @test Random segments, from meters to a few hundred kilometers, at every latitude up to 89 degrees, stay within
+/// the default tolerance.
+TEST(RgDistanceTest, GetApproxDistance_RandomSegments_WithinTolerance) {
+  rg_random::Xoshiro256pp engine(2026);
+  for (int i = 0; i < 20000; ++i) {
+    const auto latitude = static_cast<int32_t>(rg_random::UniformBelow(engine, 178 * kE7)) - 89 * kE7;
+    // 358e7 is past INT32_MAX: draw it unsigned and shift it in 64 bits.
+    const auto longitude = static_cast<int32_t>(
+        static_cast<int64_t>(rg_random::UniformBelow(engine, 358u * uint32_t{kE7})) - int64_t{179} * kE7);
+    // Spans from 1e-7 to about 3 degrees, spread over the orders of magnitude.
+    const auto scale = int32_t{1} << rg_random::UniformBelow(engine, 25);
+    const auto d_lat = static_cast<int32_t>(rg_random::UniformBelow(engine, 2 * scale)) - scale;
+    const auto d_lon = static_cast<int32_t>(rg_random::UniformBelow(engine, 2 * scale)) - scale;
+    const auto start = rg_utils::MakePoint(latitude, longitude);
+    const auto end = rg_utils::MakePoint(std::clamp(latitude + d_lat, -90 * kE7, 90 * kE7), longitude + d_lon);
+    ASSERT_LE(RelativeError(start, end, rg_utils::kDistanceTolerance), rg_utils::kDistanceTolerance)
+        << "segment " << latitude << "," << longitude << " + " << d_lat << "," << d_lon;
+  }
+}
+
+/// @test A tighter tolerance still holds, the approximation giving way to the exact path sooner.
+TEST(RgDistanceTest, GetApproxDistance_TightTolerance_WithinTolerance) {
+  static constexpr double kTolerance = 1e-8;
+  const auto start = rg_utils::MakePoint(45 * kE7, 7 * kE7);
+  for (const int32_t span : {10, 1000, 100000, 10000000}) {
+    EXPECT_LE(RelativeError(start, rg_utils::MakePoint(45 * kE7 + span, 7 * kE7 + span), kTolerance), kTolerance);
+  }
+}
+
+/// @test Segments the approximation can't bound give the exact distance: across the antimeridian, and over
+/// hundreds of kilometers.
+TEST(RgDistanceTest, GetApproxDistance_UnboundedSegments_ExactDistance) {
+  const auto east = rg_utils::MakePoint(10 * kE7, 179 * kE7 + 9000000);
+  const auto west = rg_utils::MakePoint(10 * kE7, -179 * kE7 - 9000000);
+  EXPECT_DOUBLE_EQ(rg_utils::GetApproxDistance(east, west), rg_utils::GetDistance(east, west));
+  const auto paris = rg_utils::MakePoint(488566000, 23522000);
+  const auto rome = rg_utils::MakePoint(419028000, 124964000);
+  EXPECT_DOUBLE_EQ(rg_utils::GetApproxDistance(paris, rome), rg_utils::GetDistance(paris, rome));
+}
+
+/// @test A null segment is 0 meters.
+TEST(RgDistanceTest, GetApproxDistance_SamePoint_Zero) {
+  const auto point = rg_utils::MakePoint(407838351, -746143763);
+  EXPECT_EQ(rg_utils::GetApproxDistance(point, point), 0.0);
+}
+
+}  // namespace
@@ -0,0 +1,152 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Huge Pages Tests
+///
+/// Tests the allocations of rg_hugepages.h in every mode: the mappings of Map(), the standard Allocator splitting
+/// the heap and the mappings at kHugePageSize, and the pool of arena blocks behind ArenaOptions(). The explicit mode
+/// falls back to the transparent one without reserved huge pages, so both pass on any kernel.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <google/protobuf/arena.h>
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "rg_service/rg_hugepages.h"
+#include "rg_service/rg_utils.h"
+#include "rg_service/route_guide_service.h"
+
+namespace {
+
+using rg_hugepages::kHugePageSize;
+using rg_hugepages::Mode;
+
+/// Puts the process back in the default mode after every test.
+class RgHugePagesTest : public ::testing::Test {
+ protected:
+  void TearDown() override { rg_hugepages::SetMode(Mode::kOff); }
+};
+
+bool HugePageAligned(const void* address) {
+  return reinterpret_cast<uintptr_t>(address) % kHugePageSize == 0;
+}
+
+/// @test The mode names parse, any other name is rejected.
+TEST_F(RgHugePagesTest, ParseMode_Names_Parsed) {
+  const struct {
+    const char* name;
+    bool valid;
+    Mode mode;
+  } kCases[] = {
+      {"off", true, Mode::kOff},          {"transparent", true, Mode::kTransparent},
+      {"explicit", true, Mode::kExplicit}, {"", false, Mode::kOff},
+      {"Transparent", false, Mode::kOff},  {"on", false, Mode::kOff},
+  };
+  for (const auto& test : kCases) {
+    auto mode = Mode::kOff;
+    EXPECT_EQ(rg_hugepages::ParseMode(test.name, mode), test.valid) << test.name;
+    if (test.valid) EXPECT_EQ(mode, test.mode) << test.name;
+  }
+}
+
+/// @test In every mode, Map() gives writable memory rounded up to huge pages, aligned on them in the huge-page modes.
+TEST_F(RgHugePagesTest, Map_EveryMode_WritableAndAligned) {
+  for (const auto mode : {Mode::kOff, Mode::kTransparent, Mode::kExplicit}) {
+    rg_hugepages::SetMode(mode);
+    constexpr size_t kBytes = kHugePageSize + 1;
+    auto* address = static_cast<char*>(rg_hugepages::Map(kBytes));
+    ASSERT_NE(address, nullptr);
+    if (mode != Mode::kOff) EXPECT_TRUE(HugePageAligned(address));
+    // The whole rounded length is mapped.
+    std::memset(address, 0x5a, 2 * kHugePageSize);
+    EXPECT_EQ(address[2 * kHugePageSize - 1], 0x5a);
+    rg_hugepages::Unmap(address, kBytes);
+  }
+}
+
+/// @test The allocator keeps the small allocations on the heap and maps the ones of at least kHugePageSize, and a
+/// vector keeps its elements through the growth from one to the other.
+TEST_F(RgHugePagesTest, Allocator_SmallAndLarge_SplitAtHugePage) {
+  rg_hugepages::SetMode(Mode::kTransparent);
+  rg_hugepages::Allocator<uint64_t> allocator;
+  constexpr size_t kLarge = kHugePageSize / sizeof(uint64_t);
+  auto* large = allocator.allocate(kLarge);
+  EXPECT_TRUE(HugePageAligned(large));
+  large[kLarge - 1] = 42;
+  allocator.deallocate(large, kLarge);
+  auto* small = allocator.allocate(16);
+  small[15] = 42;
+  allocator.deallocate(small, 16);
+
+  std::vector<uint64_t, rg_hugepages::Allocator<uint64_t>> values;
+  for (uint64_t i = 0; i < 2 * kLarge; ++i) values.push_back(i);
+  EXPECT_TRUE(HugePageAligned(values.data()));
+  for (uint64_t i = 0; i < values.size(); ++i) ASSERT_EQ(values[i], i);
+  EXPECT_TRUE(rg_hugepages::Allocator<char>() == rg_hugepages::Allocator<int>());
+}
+
+/// @test Off, the arena options are the protobuf defaults.
+TEST_F(RgHugePagesTest, ArenaOptions_Off_Defaults) {
+  const auto options = rg_hugepages::ArenaOptions();
+  const google::protobuf::ArenaOptions defaults;
+  EXPECT_EQ(options.block_alloc, defaults.block_alloc);
+  EXPECT_EQ(options.block_dealloc, defaults.block_dealloc);
+  EXPECT_EQ(options.start_block_size, defaults.start_block_size);
+  EXPECT_EQ(options.max_block_size, defaults.max_block_size);
+}
+
+/// @test In a huge-page mode, the arena blocks come from the pool: distinct blocks within the huge pages, a block
+/// given back is taken again first, and the other sizes come from the heap.
+TEST_F(RgHugePagesTest, ArenaOptions_Pool_ReusesBlocks) {
+  rg_hugepages::SetMode(Mode::kTransparent);
+  const auto options = rg_hugepages::ArenaOptions();
+  ASSERT_NE(options.block_alloc, nullptr);
+  ASSERT_NE(options.block_dealloc, nullptr);
+  ASSERT_EQ(options.start_block_size, options.max_block_size);
+  const auto block_size = options.start_block_size;
+
+  std::set<void*> blocks;
+  for (int i = 0; i < 8; ++i) {
+    auto* block = options.block_alloc(block_size);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % block_size, 0u);
+    std::memset(block, i, block_size);
+    EXPECT_TRUE(blocks.insert(block).second);
+  }
+  auto* last = *blocks.rbegin();
+  options.block_dealloc(last, block_size);
+  EXPECT_EQ(options.block_alloc(block_size), last);
+  for (auto* block : blocks) options.block_dealloc(block, block_size);
+
+  auto* larger = options.block_alloc(3 * block_size);
+  std::memset(larger, 0, 3 * block_size);
+  options.block_dealloc(larger, 3 * block_size);
+}
+
+/// @test An arena on the pool holds messages larger than its blocks and the ones of many blocks.
+TEST_F(RgHugePagesTest, ArenaOptions_Arena_HoldsMessages) {
+  rg_hugepages::SetMode(Mode::kExplicit);
+  google::protobuf::Arena arena(rg_hugepages::ArenaOptions());
+  std::vector<routeguide::Feature*> features;
+  for (int i = 0; i < 1000; ++i) {
+    auto* feature = google::protobuf::Arena::Create<routeguide::Feature>(&arena);
+    *feature = rg_utils::MakeFeature(std::string(i % 7 == 0 ? 5000 : 10, 'f'), i, -i);
+    features.push_back(feature);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(features[i]->location().latitude(), i);
+    ASSERT_EQ(features[i]->name().size(), i % 7 == 0 ? 5000u : 10u);
+  }
+  EXPECT_GT(arena.SpaceAllocated(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,118 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Dataset Import Tests
+///
+/// Tests the CSV and GeoJSON import of rg_import.h through files written in the test temporary directory: the
+/// decimal degrees parser, the CSV layouts, and the GeoJSON members looked up in their own object only.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "rg_service/rg_db.h"
+#include "rg_service/rg_import.h"
+
+namespace {
+
+/// Imports the text as a dataset file of the extension, on two threads.
+std::optional<rg_db::FeatureStore> Import(const std::string& text, const std::string& extension) {
+  static int file_counter = 0;
+  const auto path = ::testing::TempDir() + "rg_import_test_" + std::to_string(file_counter++) + extension;
+  std::ofstream(path) << text;
+  return rg_import::ImportFeatures(path, 2);
+}
+
+/// GeoJSON FeatureCollection of one feature.
+std::string Collection(const std::string& feature) {
+  return R"({"type":"FeatureCollection","features":[)" + feature + "]}";
+}
+
+/// @test Decimal degrees are parsed into E7 units, rounded half away from zero, and the invalid texts rejected.
+TEST(RgImportTest, ParseDegreesE7_Table) {
+  EXPECT_EQ(rg_import::ParseDegreesE7("40.7838351"), 407838351);
+  EXPECT_EQ(rg_import::ParseDegreesE7("-74.6143763"), -746143763);
+  EXPECT_EQ(rg_import::ParseDegreesE7("+1"), 10000000);
+  EXPECT_EQ(rg_import::ParseDegreesE7("0.00000005"), 1);
+  EXPECT_EQ(rg_import::ParseDegreesE7("-0.00000005"), -1);
+  EXPECT_EQ(rg_import::ParseDegreesE7("1.5e1"), 150000000);
+  EXPECT_FALSE(rg_import::ParseDegreesE7("").has_value());
+  EXPECT_FALSE(rg_import::ParseDegreesE7("12a").has_value());
+  EXPECT_FALSE(rg_import::ParseDegreesE7("1000").has_value());
+}
+
+/// @test A CSV header names the columns in any order, and the records that don't parse are skipped.
+TEST(RgImportTest, ImportCsv_HeaderInAnyOrder_ReadsColumns) {
+  const auto store = Import("lon,name,lat\n-74.5,\"Main \"\"St\"\"\",40.25\nbroken line\n1,Second,2\n", ".csv");
+  ASSERT_TRUE(store.has_value());
+  ASSERT_EQ(store->size(), 2u);
+  EXPECT_EQ(store->name(0), "Main \"St\"");
+  EXPECT_EQ(store->latitude(0), 402500000);
+  EXPECT_EQ(store->longitude(0), -745000000);
+  EXPECT_EQ(store->name(1), "Second");
+  EXPECT_EQ(store->latitude(1), 20000000);
+}
+
+/// @test A Point feature gives its coordinates, altitude ignored, and the name of its properties, escapes decoded.
+TEST(RgImportTest, ImportGeoJson_PointFeature_ReadsNameAndCoordinates) {
+  const auto store = Import(Collection(R"({"type":"Feature","properties":{"name":"Café \"A\""},)"
+                                       R"("geometry":{"type":"Point","coordinates":[-74.5, 40.25, 12]}})"),
+                            ".geojson");
+  ASSERT_TRUE(store.has_value());
+  ASSERT_EQ(store->size(), 1u);
+  EXPECT_EQ(store->name(0), "Caf\xc3\xa9 \"A\"");
+  EXPECT_EQ(store->latitude(0), 402500000);
+  EXPECT_EQ(store->longitude(0), -745000000);
+}
+
+/// @test The name is the member of the properties object, not the one of an object nested in it, before or after.
+TEST(RgImportTest, ImportGeoJson_NestedName_ReadsOuterName) {
+  const auto store = Import(Collection(R"({"type":"Feature","properties":{"meta":{"name":"inner"},"name":"outer"},)"
+                                       R"("geometry":{"type":"Point","coordinates":[1,2]}})"),
+                            ".geojson");
+  ASSERT_TRUE(store.has_value());
+  ASSERT_EQ(store->size(), 1u);
+  EXPECT_EQ(store->name(0), "outer");
+}
+
+/// @test Coordinates nested in the properties don't override the ones of the geometry, whatever the member order.
+TEST(RgImportTest, ImportGeoJson_NestedCoordinates_ReadsGeometry) {
+  const auto store =
+      Import(Collection(R"({"type":"Feature","properties":{"name":"n","bbox_note":{"coordinates":[99,9]}},)"
+                        R"("geometry":{"type":"Point","coordinates":[1,2]}})"),
+             ".geojson");
+  ASSERT_TRUE(store.has_value());
+  ASSERT_EQ(store->size(), 1u);
+  EXPECT_EQ(store->latitude(0), 20000000);
+  EXPECT_EQ(store->longitude(0), 10000000);
+}
+
+/// @test Features whose geometry is not a Point, or which have no geometry, are skipped.
+TEST(RgImportTest, ImportGeoJson_NonPointGeometry_Skipped) {
+  const auto store = Import(R"({"type":"FeatureCollection","features":[)"
+                            R"({"type":"Feature","properties":{"name":"line"},)"
+                            R"("geometry":{"type":"LineString","coordinates":[[1,2],[3,4]]}},)"
+                            R"({"type":"Feature","properties":{"name":"flat"},)"
+                            R"("geometry":{"type":"Polygon","coordinates":[5,6]}},)"
+                            R"({"type":"Feature","properties":{"name":"none","coordinates":[7,8]}},)"
+                            R"({"type":"Feature","properties":{"name":"point"},)"
+                            R"("geometry":{"coordinates":[1,2],"type":"Point"}}]})",
+                            ".geojson");
+  ASSERT_TRUE(store.has_value());
+  ASSERT_EQ(store->size(), 1u);
+  EXPECT_EQ(store->name(0), "point");
+}
+
+/// @test An unknown extension is not imported.
+TEST(RgImportTest, ImportFeatures_UnknownExtension_Nullopt) {
+  EXPECT_FALSE(Import("name,1,2\n", ".txt").has_value());
+}
+
+}  // namespace
@@ -0,0 +1,225 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Spatial Index Tests
+///
+/// Tests the indexes of rg_index.h against a scan: FeatureIndex::Find() on a feature store,
+/// NoteIndex::FindNear() through both of its paths, the cell lookup and the filter of every note taken near the
+/// poles or when the index holds fewer notes than the cells to look up, and the interests of the RouteChat
+/// sessions in InterestIndex.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rg_service/rg_db.h"
+#include "rg_service/rg_index.h"
+#include "rg_service/rg_random.h"
+#include "rg_service/rg_utils.h"
+
+namespace {
+
+routeguide::RouteNote MakeNote(const int32_t latitude, const int32_t longitude, const std::string& message) {
+  routeguide::RouteNote note;
+  *note.mutable_location() = rg_utils::MakePoint(latitude, longitude);
+  note.set_message(message);
+  return note;
+}
+
+/// Notes within the radius of the location, by a scan of every note, in insertion order.
+std::vector<std::string> Scan(const std::vector<routeguide::RouteNote>& notes, const routeguide::Point& location,
+                              const double radius_meters) {
+  std::vector<std::string> found;
+  for (const auto& note : notes) {
+    if (radius_meters == 0 ? note.location() == location
+                           : rg_utils::GetApproxDistance(note.location(), location) <= radius_meters) {
+      found.push_back(note.message());
+    }
+  }
+  return found;
+}
+
+std::vector<std::string> Messages(const std::vector<const routeguide::RouteNote*>& notes) {
+  std::vector<std::string> messages;
+  for (const auto* note : notes) messages.push_back(note->message());
+  return messages;
+}
+
+/// Inserts the notes into a new index, and checks FindNear() against a scan at every location.
+void ExpectSameAsScan(const std::vector<routeguide::RouteNote>& notes, const std::vector<routeguide::Point>& locations,
+                      const double radius_meters) {
+  rg_index::NoteIndex index(radius_meters);
+  for (const auto& note : notes) index.Insert(note);
+  ASSERT_EQ(index.size(), notes.size());
+  for (const auto& location : locations) {
+    ASSERT_EQ(Messages(index.FindNear(location)), Scan(notes, location, radius_meters))
+        << "at " << location.latitude() << "," << location.longitude() << " radius " << radius_meters;
+  }
+}
+
+/// @test With a radius of 0, only the notes at the exact location match, in insertion order.
+TEST(RgIndexTest, FindNear_ZeroRadius_ExactLocationOnly) {
+  rg_index::NoteIndex index(0);
+  index.Insert(MakeNote(1, 1, "first"));
+  index.Insert(MakeNote(1, 2, "beside"));
+  index.Insert(MakeNote(1, 1, "second"));
+  EXPECT_EQ(Messages(index.FindNear(rg_utils::MakePoint(1, 1))), (std::vector<std::string>{"first", "second"}));
+  EXPECT_TRUE(index.FindNear(rg_utils::MakePoint(2, 2)).empty());
+}
+
+/// @test Notes spread over a region, looked up through the cells, match the scan for several radii.
+TEST(RgIndexTest, FindNear_SpreadNotes_SameAsScan) {
+  rg_random::Xoshiro256pp engine(83);
+  const auto region = rg_utils::MakeRectangle(400000000, -750000000, 420000000, -730000000);
+  std::vector<routeguide::Point> points(3000);
+  rg_random::FillPointsInRectangle(engine, region, points);
+  std::vector<routeguide::RouteNote> notes;
+  for (size_t i = 0; i < 2000; ++i) {
+    notes.push_back(MakeNote(points[i].latitude(), points[i].longitude(), std::to_string(i)));
+  }
+  const std::vector<routeguide::Point> locations(points.begin() + 1000, points.end());
+  for (const double radius : {500.0, 5000.0, 50000.0}) ExpectSameAsScan(notes, locations, radius);
+}
+
+/// @test Clustered notes, many in few cells, still match the scan: the lookup walks the few cells around the
+/// location whatever the number of cells holding notes.
+TEST(RgIndexTest, FindNear_ClusteredNotes_SameAsScan) {
+  std::vector<routeguide::RouteNote> notes;
+  for (int i = 0; i < 1000; ++i) {
+    notes.push_back(MakeNote(407838351 + (i % 10) * 100, -746143763 + (i / 10) * 100, std::to_string(i)));
+  }
+  const std::vector<routeguide::Point> locations{rg_utils::MakePoint(407838351, -746143763),
+                                                 rg_utils::MakePoint(407848351, -746133763),
+                                                 rg_utils::MakePoint(410000000, -740000000)};
+  ExpectSameAsScan(notes, locations, 100);
+}
+
+/// @test Near the poles the longitude span covers more cells than the index holds notes, and the lookup filters
+/// every note instead: the results still match the scan, across the whole longitude range.
+TEST(RgIndexTest, FindNear_NearThePole_FallsBackToFilter) {
+  std::vector<routeguide::RouteNote> notes{MakeNote(899990000, 0, "pole a"), MakeNote(899990000, 1790000000, "pole b"),
+                                           MakeNote(899000000, 900000000, "ring"), MakeNote(0, 0, "equator")};
+  const std::vector<routeguide::Point> locations{rg_utils::MakePoint(899995000, -1000000000),
+                                                 rg_utils::MakePoint(900000000, 0)};
+  ExpectSameAsScan(notes, locations, 5000);
+  ExpectSameAsScan(notes, locations, 200000);
+}
+
+/// @test A lookup next to the antimeridian finds the notes on the other side of it.
+TEST(RgIndexTest, FindNear_AcrossTheAntimeridian_SameAsScan) {
+  std::vector<routeguide::RouteNote> notes{MakeNote(100000000, 1799990000, "east"),
+                                           MakeNote(100000000, -1799990000, "west"),
+                                           MakeNote(100000000, 1700000000, "far")};
+  std::vector<routeguide::RouteNote> padded = notes;
+  // Enough notes elsewhere for the lookup to walk the cells instead of filtering every note.
+  for (int i = 0; i < 200; ++i) padded.push_back(MakeNote(-400000000 + i * 100000, 0, "pad " + std::to_string(i)));
+  const std::vector<routeguide::Point> locations{rg_utils::MakePoint(100000000, 1800000000),
+                                                 rg_utils::MakePoint(100000000, -1800000000)};
+  ExpectSameAsScan(padded, locations, 1000);
+  rg_index::NoteIndex index(1000);
+  for (const auto& note : padded) index.Insert(note);
+  EXPECT_EQ(Messages(index.FindNear(locations[0])), (std::vector<std::string>{"east", "west"}));
+}
+
+/// @test A subscriber gets one interest per area of the radius, and is found once near the location whatever the
+/// number of its interests there.
+TEST(RgIndexTest, InterestIndexAdd_NearInterest_NotAddedTwice) {
+  rg_index::InterestIndex index(1000);
+  int stream = 0;
+  const rg_index::InterestIndex::Subscriber subscriber{&stream, 7};
+  EXPECT_TRUE(index.Add(subscriber, rg_utils::MakePoint(407838351, -746143763)));
+  EXPECT_FALSE(index.Add(subscriber, rg_utils::MakePoint(407838351, -746143763)));
+  EXPECT_FALSE(index.Add(subscriber, rg_utils::MakePoint(407840000, -746143763)));  // about 18 m away
+  EXPECT_TRUE(index.Add({&stream, 8}, rg_utils::MakePoint(407838351, -746143763)));
+  EXPECT_TRUE(index.Add(subscriber, rg_utils::MakePoint(407938351, -746143763)));  // about 1.1 km away
+  EXPECT_EQ(index.size(), 3u);
+  using Subscribers = std::vector<rg_index::InterestIndex::Subscriber>;
+  EXPECT_EQ(index.FindNear(rg_utils::MakePoint(408000000, -746143763)), (Subscribers{subscriber}));
+  EXPECT_EQ(index.FindNear(rg_utils::MakePoint(407838351, -746143763)), (Subscribers{subscriber, {&stream, 8}}));
+}
+
+/// @test A closed session and an ended stream leave the index, the other sessions stay, and the freed slots
+/// are reused.
+TEST(RgIndexTest, InterestIndexRemove_SessionAndStream_OthersStay) {
+  rg_index::InterestIndex index(0);
+  int first = 0;
+  int second = 0;
+  const auto location = rg_utils::MakePoint(1, 1);
+  index.Add({&first, 1}, location);
+  index.Add({&first, 2}, location);
+  index.Add({&second, 1}, location);
+  index.Add({&second, 1}, rg_utils::MakePoint(2, 2));
+  using Subscribers = std::vector<rg_index::InterestIndex::Subscriber>;
+  ASSERT_EQ(index.FindNear(location).size(), 3u);
+
+  index.Remove({&first, 2});
+  index.Remove({&first, 3});  // never subscribed
+  auto found = index.FindNear(location);
+  EXPECT_EQ(found.size(), 2u);
+  EXPECT_TRUE(std::ranges::find(found, rg_index::InterestIndex::Subscriber{&first, 2}) == found.end());
+
+  index.RemoveStream(&second);
+  EXPECT_EQ(index.FindNear(location), (Subscribers{{&first, 1}}));
+  EXPECT_TRUE(index.FindNear(rg_utils::MakePoint(2, 2)).empty());
+  EXPECT_EQ(index.size(), 1u);
+  EXPECT_TRUE(index.Add({&second, 1}, location));
+  EXPECT_EQ(index.FindNear(location).size(), 2u);
+}
+
+/// @test Interests of many sessions spread over a region, through the cells and through the filter of every
+/// interest, match a scan of the interests of every session.
+TEST(RgIndexTest, InterestIndexFindNear_SpreadInterests_SameAsScan) {
+  rg_random::Xoshiro256pp engine(84);
+  const auto region = rg_utils::MakeRectangle(400000000, -750000000, 420000000, -730000000);
+  std::vector<routeguide::Point> points(1500);
+  rg_random::FillPointsInRectangle(engine, region, points);
+  int streams[10];
+  for (const double radius : {500.0, 5000.0, 500000.0}) {
+    rg_index::InterestIndex index(radius);
+    std::map<rg_index::InterestIndex::Subscriber, std::vector<routeguide::Point>> interests;
+    for (size_t i = 0; i < 1000; ++i) {
+      const rg_index::InterestIndex::Subscriber subscriber{&streams[i % 10], i % 7};
+      auto& locations = interests[subscriber];
+      const bool near = std::ranges::any_of(locations, [&](const auto& interest) {
+        return rg_utils::GetApproxDistance(interest, points[i]) <= radius;
+      });
+      ASSERT_EQ(index.Add(subscriber, points[i]), !near);
+      if (!near) locations.push_back(points[i]);
+    }
+    for (size_t i = 1000; i < points.size(); ++i) {
+      std::vector<rg_index::InterestIndex::Subscriber> expected;
+      for (const auto& [subscriber, locations] : interests) {
+        if (std::ranges::any_of(locations, [&](const auto& interest) {
+              return rg_utils::GetApproxDistance(interest, points[i]) <= radius;
+            })) {
+          expected.push_back(subscriber);
+        }
+      }
+      ASSERT_EQ(index.FindNear(points[i]), expected) << "radius " << radius;
+    }
+  }
+}
+
+/// @test FeatureIndex::Find() returns the position of the first feature at a location, and nothing elsewhere.
+TEST(RgIndexTest, FeatureIndexFind_StoredLocations_FirstPosition) {
+  rg_db::FeatureStore store;
+  store.Add("a", 10, 20);
+  store.Add("b", -10, -20);
+  store.Add("c", 10, 20);
+  store.Add("d", 400000000, -740000000);
+  const rg_index::FeatureIndex index(store, 2);
+  EXPECT_EQ(index.Find(rg_utils::MakePoint(10, 20)), 0u);
+  EXPECT_EQ(index.Find(rg_utils::MakePoint(-10, -20)), 1u);
+  EXPECT_EQ(index.Find(rg_utils::MakePoint(400000000, -740000000)), 3u);
+  EXPECT_FALSE(index.Find(rg_utils::MakePoint(20, 10)).has_value());
+}
+
+}  // namespace
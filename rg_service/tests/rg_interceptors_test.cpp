@@ -0,0 +1,115 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Serialization Metrics Interceptor Tests
+///
+/// Tests the SerializationMetricsInterceptorFactory of rg_interceptors.h: the sampling of the parse times, alone
+/// and through the RPCs of an in-process server, whose messages are recorded in a registry of the test.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rg_service/rg_interceptors.h"
+#include "rg_service/rg_metrics.h"
+#include "rg_service/rg_utils.h"
+#include "rg_service/route_guide_service.h"
+
+namespace {
+
+constexpr int kFeatures = 10;
+
+/// Streams kFeatures features for any rectangle.
+class FeatureService final : public routeguide::RouteGuide::Service {
+ public:
+  grpc::Status ListFeatures(grpc::ServerContext*, const routeguide::Rectangle*,
+                            grpc::ServerWriter<routeguide::Feature>* writer) override {
+    for (int i = 0; i < kFeatures; ++i) {
+      writer->Write(rg_utils::MakeFeature("Feature " + std::to_string(i), i * 1000, -i * 1000));
+    }
+    return grpc::Status::OK;
+  }
+};
+
+/// @return values recorded by a histogram, the sum of its buckets
+uint64_t Count(const rg_metrics::Histogram& histogram) {
+  const auto snapshot = histogram.Read();
+  return std::accumulate(snapshot.buckets.begin(), snapshot.buckets.end(), uint64_t{0});
+}
+
+/// @test One received message out of `parse_sample_every` is sampled, the first one included.
+TEST(RgInterceptorsTest, SampleParse_EveryFourth_SamplesOneInFour) {
+  rg_metrics::Registry registry;
+  rg_interceptors::SerializationMetricsInterceptorFactory factory(registry, 4);
+  std::vector<bool> sampled;
+  for (int i = 0; i < 9; ++i) sampled.push_back(factory.SampleParse());
+  EXPECT_EQ(sampled, (std::vector<bool>{true, false, false, false, true, false, false, false, true}));
+}
+
+/// @test A sampling period of 0 is taken as 1: every received message is sampled.
+TEST(RgInterceptorsTest, SampleParse_ZeroPeriod_SamplesEvery) {
+  rg_metrics::Registry registry;
+  rg_interceptors::SerializationMetricsInterceptorFactory factory(registry, 0);
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(factory.SampleParse());
+}
+
+/// @test Through a streaming RPC, every received message is sized, one out of 4 parsed again, and the RPC counts
+/// its messages per direction once it is done.
+TEST(RgInterceptorsTest, ListFeatures_StreamedResponses_RecordsSizesAndSampledParses) {
+  FeatureService service;
+  grpc::ServerBuilder builder;
+  int port = 0;
+  builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(), &port);
+  builder.RegisterService(&service);
+  const auto server = builder.BuildAndStart();
+  ASSERT_NE(server, nullptr);
+
+  rg_metrics::Registry registry;
+  std::vector<std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>> interceptors;
+  interceptors.push_back(std::make_unique<rg_interceptors::SerializationMetricsInterceptorFactory>(registry, 4));
+  const auto channel = grpc::experimental::CreateCustomChannelWithInterceptors(
+      "localhost:" + std::to_string(port), grpc::InsecureChannelCredentials(), grpc::ChannelArguments(),
+      std::move(interceptors));
+  const auto stub = routeguide::RouteGuide::NewStub(channel);
+  uint64_t received_bytes = 0;
+  {
+    grpc::ClientContext context;
+    const auto reader = stub->ListFeatures(&context, routeguide::Rectangle{});
+    for (routeguide::Feature feature; reader->Read(&feature);) received_bytes += feature.ByteSizeLong();
+    ASSERT_TRUE(reader->Finish().ok());
+  }
+  server->Shutdown();
+
+  const rg_metrics::Labels method{{"method", "ListFeatures"}};
+  auto labels = [&method](const char* direction) {
+    auto labels = method;
+    labels.emplace_back("direction", direction);
+    return labels;
+  };
+  const auto& received = registry.GetHistogram("rg_client_message_bytes", "", 1.0, labels("received"));
+  EXPECT_EQ(Count(received), uint64_t{kFeatures});
+  EXPECT_EQ(received.Read().sum, received_bytes);
+  EXPECT_EQ(Count(registry.GetHistogram("rg_client_message_bytes", "", 1.0, labels("sent"))), 1u);
+  EXPECT_EQ(Count(registry.GetHistogram("rg_client_serialize_duration_seconds", "", 1e-9, method)), 1u);
+  // Messages 0, 4 and 8.
+  EXPECT_EQ(Count(registry.GetHistogram("rg_client_parse_duration_seconds", "", 1e-9, method)), 3u);
+  const auto& received_messages = registry.GetHistogram("rg_client_messages_per_rpc", "", 1.0, labels("received"));
+  EXPECT_EQ(Count(received_messages), 1u);
+  EXPECT_EQ(received_messages.Read().sum, uint64_t{kFeatures});
+}
+
+}  // namespace
@@ -0,0 +1,118 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Spatial Key Tests
+///
+/// Tests the Morton and Hilbert keys of rg_keys.h: lossless round trips of E7 points, the locality of the Hilbert
+/// curve, and the key ranges covering a rectangle.
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "rg_service/rg_keys.h"
+#include "rg_service/rg_random.h"
+#include "rg_service/rg_utils.h"
+
+namespace {
+
+std::vector<routeguide::Point> SamplePoints() {
+  constexpr auto kMin = std::numeric_limits<int32_t>::min();
+  constexpr auto kMax = std::numeric_limits<int32_t>::max();
+  std::vector<routeguide::Point> points{rg_utils::MakePoint(0, 0),       rg_utils::MakePoint(kMin, kMin),
+                                        rg_utils::MakePoint(kMax, kMax), rg_utils::MakePoint(kMin, kMax),
+                                        rg_utils::MakePoint(-1, 1),      rg_utils::MakePoint(900000000, -1800000000)};
+  rg_random::Xoshiro256pp engine(82);
+  for (int i = 0; i < 10000; ++i) {
+    points.push_back(rg_utils::MakePoint(static_cast<int32_t>(engine()), static_cast<int32_t>(engine())));
+  }
+  return points;
+}
+
+bool InRanges(const std::vector<rg_keys::KeyRange>& ranges, const uint64_t key) {
+  return std::ranges::any_of(ranges, [key](const auto& range) { return range.lo <= key && key <= range.hi; });
+}
+
+/// @test A Morton key decodes back to its point, over the whole int32 range.
+TEST(RgKeysTest, MortonEncode_AnyPoint_RoundTrips) {
+  for (const auto& point : SamplePoints()) {
+    EXPECT_EQ(rg_keys::MortonDecode(rg_keys::MortonEncode(point)), point);
+  }
+}
+
+/// @test A Hilbert key decodes back to its point, over the whole int32 range.
+TEST(RgKeysTest, HilbertEncode_AnyPoint_RoundTrips) {
+  for (const auto& point : SamplePoints()) {
+    EXPECT_EQ(rg_keys::HilbertDecode(rg_keys::HilbertEncode(point)), point);
+  }
+}
+
+/// @test Consecutive Hilbert indexes are adjacent cells: the curve never jumps.
+TEST(RgKeysTest, HilbertCell_ConsecutiveIndexes_AdjacentCells) {
+  rg_random::Xoshiro256pp engine(83);
+  for (int i = 0; i < 10000; ++i) {
+    const uint64_t index = engine() - 1;
+    const auto a = rg_keys::HilbertCell(index);
+    const auto b = rg_keys::HilbertCell(index + 1);
+    const auto dx = a.x > b.x ? a.x - b.x : b.x - a.x;
+    const auto dy = a.y > b.y ? a.y - b.y : b.y - a.y;
+    ASSERT_EQ(dx + dy, 1u) << "index " << index;
+  }
+}
+
+/// @test Morton keys keep the order of each coordinate when the other is fixed, negative values included.
+TEST(RgKeysTest, MortonEncode_FixedLongitude_KeepsLatitudeOrder) {
+  EXPECT_LT(rg_keys::MortonEncode(-5, 100), rg_keys::MortonEncode(-4, 100));
+  EXPECT_LT(rg_keys::MortonEncode(-1, 100), rg_keys::MortonEncode(0, 100));
+  EXPECT_LT(rg_keys::MortonEncode(0, 100), rg_keys::MortonEncode(1, 100));
+}
+
+/// @test The ranges of a rectangle are sorted, disjoint, at most max_ranges, and hold the key of every point
+/// inside, for both curves.
+TEST(RgKeysTest, DecomposeRectangle_PointsInside_KeysInRanges) {
+  const auto rectangle = rg_utils::MakeRectangle(420000000, -730000000, 400000000, -750000000);
+  rg_random::Xoshiro256pp engine(84);
+  std::vector<routeguide::Point> inside(2000);
+  rg_random::FillPointsInRectangle(engine, rectangle, inside);
+  for (const auto curve : {rg_keys::Curve::kMorton, rg_keys::Curve::kHilbert}) {
+    for (const size_t max_ranges : {size_t{1}, size_t{8}, size_t{64}}) {
+      const auto ranges = rg_keys::DecomposeRectangle(rectangle, curve, max_ranges);
+      ASSERT_FALSE(ranges.empty());
+      EXPECT_LE(ranges.size(), max_ranges);
+      for (size_t i = 0; i < ranges.size(); ++i) {
+        EXPECT_LE(ranges[i].lo, ranges[i].hi);
+        if (i > 0) EXPECT_LT(ranges[i - 1].hi, ranges[i].lo);
+      }
+      for (const auto& point : inside) {
+        const auto key =
+            curve == rg_keys::Curve::kMorton ? rg_keys::MortonEncode(point) : rg_keys::HilbertEncode(point);
+        ASSERT_TRUE(InRanges(ranges, key)) << "max_ranges " << max_ranges;
+      }
+    }
+  }
+}
+
+/// @test With enough ranges, a corner cell of a small rectangle is covered while the cells just outside are not.
+TEST(RgKeysTest, DecomposeRectangle_EnoughRanges_ExactCover) {
+  const auto rectangle = rg_utils::MakeRectangle(16, 16, 31, 31);
+  for (const auto curve : {rg_keys::Curve::kMorton, rg_keys::Curve::kHilbert}) {
+    const auto ranges = rg_keys::DecomposeRectangle(rectangle, curve, 1024);
+    const auto key = [curve](const int32_t latitude, const int32_t longitude) {
+      return curve == rg_keys::Curve::kMorton ? rg_keys::MortonEncode(latitude, longitude)
+                                              : rg_keys::HilbertEncode(latitude, longitude);
+    };
+    EXPECT_TRUE(InRanges(ranges, key(16, 16)));
+    EXPECT_TRUE(InRanges(ranges, key(31, 31)));
+    EXPECT_FALSE(InRanges(ranges, key(15, 16)));
+    EXPECT_FALSE(InRanges(ranges, key(32, 31)));
+  }
+}
+
+}  // namespace
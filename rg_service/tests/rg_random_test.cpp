@@ -0,0 +1,98 @@
+///
+/// SPDX-License-Identifier: Apache-2.0
+/// Copyright 2026 anderewrey
+///
+///
+/// Random Module Tests
+///
+/// Tests the xoshiro256++ engine, its streams and the thread-local engines of rg_random.h: reproducibility of a
+/// seed, bounds of the draws, and the streams handed out to the threads after SetSeed().
+///
+/// @see /docs/testing.md for comprehensive test documentation
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "rg_service/rg_random.h"
+#include "rg_service/rg_utils.h"
+
+namespace {
+
+std::vector<uint64_t> Draw(rg_random::Xoshiro256pp& engine, const size_t count) {
+  std::vector<uint64_t> values(count);
+  for (auto& value : values) value = engine();
+  return values;
+}
+
+/// @test A seed and a stream give the same sequence every time, and the streams of a seed differ.
+TEST(RgRandomTest, Engine_SameSeedAndStream_SameSequence) {
+  rg_random::Xoshiro256pp first(42, 1);
+  rg_random::Xoshiro256pp second(42, 1);
+  rg_random::Xoshiro256pp other_stream(42, 2);
+  const auto sequence = Draw(first, 16);
+  EXPECT_EQ(sequence, Draw(second, 16));
+  EXPECT_NE(sequence, Draw(other_stream, 16));
+}
+
+/// @test UniformBelow() stays below its bound and reaches every value of a small range.
+TEST(RgRandomTest, UniformBelow_SmallBound_CoversTheRange) {
+  rg_random::Xoshiro256pp engine(7);
+  std::vector<int> counts(10, 0);
+  for (int i = 0; i < 10000; ++i) {
+    const auto value = rg_random::UniformBelow(engine, 10);
+    ASSERT_LT(value, 10u);
+    ++counts[value];
+  }
+  for (const auto count : counts) {
+    EXPECT_GT(count, 800);
+    EXPECT_LT(count, 1200);
+  }
+}
+
+/// @test SetSeed() reseeds the calling thread's engine, which then replays the sequence of the seed.
+TEST(RgRandomTest, SetSeed_SameSeed_ReplaysSequence) {
+  rg_random::SetSeed(1234);
+  const auto first = Draw(rg_random::ThreadLocalEngine(), 8);
+  rg_random::SetSeed(1234);
+  const auto second = Draw(rg_random::ThreadLocalEngine(), 8);
+  EXPECT_EQ(first, second);
+  rg_random::Xoshiro256pp stream_zero(1234, 0);
+  EXPECT_EQ(first, Draw(stream_zero, 8));
+}
+
+/// @test After SetSeed(), each thread draws from its own stream of the seed: one stream per thread, in order of
+/// first use, none of them shared.
+TEST(RgRandomTest, SetSeed_ConcurrentThreads_DistinctStreamsOfTheSeed) {
+  static constexpr size_t kThreads = 4;
+  rg_random::SetSeed(99);
+  std::vector<uint64_t> firsts(kThreads);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&firsts, i] { firsts[i] = rg_random::ThreadLocalEngine()(); });
+  }
+  for (auto& thread : threads) thread.join();
+
+  std::set<uint64_t> expected;
+  for (uint64_t stream = 0; stream < kThreads; ++stream) expected.insert(rg_random::Xoshiro256pp(99, stream)());
+  EXPECT_EQ(std::set<uint64_t>(firsts.begin(), firsts.end()), expected);
+}
+
+/// @test The points drawn in a rectangle stay inside it, whichever corners are lo and hi.
+TEST(RgRandomTest, FillPointsInRectangle_SwappedCorners_StaysInside) {
+  rg_random::Xoshiro256pp engine(3);
+  const auto rectangle = rg_utils::MakeRectangle(420000000, -730000000, 400000000, -750000000);
+  std::vector<routeguide::Point> points(1000);
+  rg_random::FillPointsInRectangle(engine, rectangle, points);
+  for (const auto& point : points) {
+    EXPECT_GE(point.latitude(), 400000000);
+    EXPECT_LE(point.latitude(), 420000000);
+    EXPECT_GE(point.longitude(), -750000000);
+    EXPECT_LE(point.longitude(), -730000000);
+  }
+}
+
+}  // namespace